@@ -58,6 +58,43 @@ _functionList getSipPressureThresholdFunction =   {"ST", "0", "0", &getSipPressu
 _functionList setSipPressureThresholdFunction =   {"ST", "1", "",  &setSipPressureThreshold};
 _functionList getPuffPressureThresholdFunction =  {"PT", "0", "0", &getPuffPressureThreshold};
 _functionList setPuffPressureThresholdFunction =  {"PT", "1", "",  &setPuffPressureThreshold};
+_functionList getAdaptiveThresholdModeFunction =  {"AT", "0", "0", &getAdaptiveThresholdMode};
+_functionList setAdaptiveThresholdModeFunction =  {"AT", "1", "",  &setAdaptiveThresholdMode};
+_functionList getAdaptiveThresholdFractionFunction = {"AF", "0", "0", &getAdaptiveThresholdFraction};
+_functionList setAdaptiveThresholdFractionFunction = {"AF", "1", "",  &setAdaptiveThresholdFraction};
+_functionList getHardSipPressureThresholdFunction =  {"HS", "0", "0", &getHardSipPressureThreshold};
+_functionList setHardSipPressureThresholdFunction =  {"HS", "1", "",  &setHardSipPressureThreshold};
+_functionList getHardPuffPressureThresholdFunction = {"HP", "0", "0", &getHardPuffPressureThreshold};
+_functionList setHardPuffPressureThresholdFunction = {"HP", "1", "",  &setHardPuffPressureThreshold};
+_functionList getPressureOutputModeFunction =     {"PO", "0", "0", &getPressureOutputMode};
+_functionList setPressureOutputModeFunction =     {"PO", "1", "",  &setPressureOutputMode};
+_functionList getPressureOutputDeadbandFunction = {"PD", "0", "0", &getPressureOutputDeadband};
+_functionList setPressureOutputDeadbandFunction = {"PD", "1", "",  &setPressureOutputDeadband};
+_functionList getPressureOutputCurveFunction =    {"PC", "0", "0", &getPressureOutputCurve};
+_functionList setPressureOutputCurveFunction =    {"PC", "1", "",  &setPressureOutputCurve};
+_functionList getGestureModeFunction =            {"GS", "0", "0", &getGestureMode};
+_functionList setGestureModeFunction =            {"GS", "1", "",  &setGestureMode};
+_functionList getDwellModeFunction =              {"DW", "0", "0", &getDwellMode};
+_functionList setDwellModeFunction =              {"DW", "1", "",  &setDwellMode};
+_functionList getDwellTimeFunction =              {"DT", "0", "0", &getDwellTime};
+_functionList setDwellTimeFunction =              {"DT", "1", "",  &setDwellTime};
+_functionList getHighResModeFunction =            {"HR", "0", "0", &getHighResMode};
+_functionList setHighResModeFunction =            {"HR", "1", "",  &setHighResMode};
+_functionList getAbsoluteModeFunction =           {"AP", "0", "0", &getAbsoluteMode};
+_functionList setAbsoluteModeFunction =           {"AP", "1", "",  &setAbsoluteMode};
+_functionList getAbsoluteRegionFunction =         {"AR", "0", "0", &getAbsoluteRegion};
+_functionList setAbsoluteRegionFunction =         {"AR", "1", "",  &setAbsoluteRegion};
+_functionList getAbsoluteGridFunction =           {"AG", "0", "0", &getAbsoluteGrid};
+_functionList setAbsoluteGridFunction =           {"AG", "1", "",  &setAbsoluteGrid};
+_functionList getBluetoothConnectionFunction =    {"BC", "0", "0", &getBluetoothConnection};
+_functionList getBluetoothHostFunction =          {"BH", "0", "0", &getBluetoothHost};
+_functionList setBluetoothHostFunction =          {"BH", "1", "",  &setBluetoothHost};
+_functionList getBluetoothHostStatusFunction =    {"BS", "0", "0", &getBluetoothHostStatus};
+_functionList forgetBluetoothHostFunction =       {"BF", "1", "",  &forgetBluetoothHost};
+_functionList getActionMapFunction =              {"AM", "0", "",  &getActionMap};
+_functionList setActionMapFunction =              {"AM", "1", "",  &setActionMap};
+_functionList getMacroFunction =                  {"MA", "0", "",  &getMacro};
+_functionList setMacroFunction =                  {"MA", "1", "",  &setMacro};
 
 _functionList getSoundModeFunction =              {"SM", "0", "0", &getSoundMode};
 _functionList setSoundModeFunction =              {"SM", "1", "",  &setSoundMode};
@@ -104,6 +141,43 @@ _functionList apiFunction[] = { //Let compiler determine number of functions
   setSipPressureThresholdFunction,
   getPuffPressureThresholdFunction,
   setPuffPressureThresholdFunction,
+  getAdaptiveThresholdModeFunction,
+  setAdaptiveThresholdModeFunction,
+  getAdaptiveThresholdFractionFunction,
+  setAdaptiveThresholdFractionFunction,
+  getHardSipPressureThresholdFunction,
+  setHardSipPressureThresholdFunction,
+  getHardPuffPressureThresholdFunction,
+  setHardPuffPressureThresholdFunction,
+  getPressureOutputModeFunction,
+  setPressureOutputModeFunction,
+  getPressureOutputDeadbandFunction,
+  setPressureOutputDeadbandFunction,
+  getPressureOutputCurveFunction,
+  setPressureOutputCurveFunction,
+  getGestureModeFunction,
+  setGestureModeFunction,
+  getDwellModeFunction,
+  setDwellModeFunction,
+  getDwellTimeFunction,
+  setDwellTimeFunction,
+  getHighResModeFunction,
+  setHighResModeFunction,
+  getAbsoluteModeFunction,
+  setAbsoluteModeFunction,
+  getAbsoluteRegionFunction,
+  setAbsoluteRegionFunction,
+  getAbsoluteGridFunction,
+  setAbsoluteGridFunction,
+  getBluetoothConnectionFunction,
+  getBluetoothHostFunction,
+  setBluetoothHostFunction,
+  getBluetoothHostStatusFunction,
+  forgetBluetoothHostFunction,
+  getActionMapFunction,
+  setActionMapFunction,
+  getMacroFunction,
+  setMacroFunction,
   getJoystickAccelerationFunction,
   setJoystickAccelerationFunction,
   getSoundModeFunction,
@@ -121,6 +195,12 @@ _functionList apiFunction[] = { //Let compiler determine number of functions
   factoryResetFunction
 };
 
+// Declare array of API end points which accept a parameter longer than the standard command format
+String apiLongParameterEndpoint[] = {
+  "AM",
+  "MA"
+};
+
 //***SERIAL SETTINGS FUNCTION TO CHANGE SPEED AND COMMUNICATION MODE USING SOFTWARE***//
 // Function   : serialSettings
 //
@@ -244,9 +324,34 @@ bool isValidCommandFormat(String inputCommandString) {
        inputCommandString.length() == (11)) && inputCommandString.charAt(2) == ',' && inputCommandString.charAt(4) == ':') { // XX,d:dddddd
     isValidFormat = true;
   }
+  else if (inputCommandString.length() > (11) &&
+           inputCommandString.length() <= CONF_API_LONG_COMMAND_MAX_LENGTH &&
+           inputCommandString.charAt(2) == ',' && inputCommandString.charAt(4) == ':' &&
+           isLongParameterEndpoint(inputCommandString.substring(0, 2))) { // XX,d:d-d.d.d-...
+    isValidFormat = true;
+  }
   return isValidFormat;
 }
 
+//***CHECK IF END POINT ACCEPTS LONG PARAMETER FUNCTION***//
+// Function   : isLongParameterEndpoint
+//
+// Description: This function checks if the end point accepts a parameter longer than the standard command format.
+//
+// Parameters :  inputEndpointString : String : The two character end point
+//
+// Return     : boolean
+//*************************************************//
+bool isLongParameterEndpoint(String inputEndpointString) {
+  int endpointTotalNumber = sizeof(apiLongParameterEndpoint) / sizeof(apiLongParameterEndpoint[0]);
+  for (int endpointIndex = 0; endpointIndex < endpointTotalNumber; endpointIndex++) {
+    if (inputEndpointString == apiLongParameterEndpoint[endpointIndex]) {
+      return true;
+    }
+  }
+  return false;
+}
+
 //***VALIDATE INPUT COMMAND PARAMETER FUNCTION***//
 // Function   : isValidCommandParameter
 //
@@ -278,7 +383,7 @@ bool isValidCommandParameter(String inputParameterString) {
 //******************************************//
 boolean isStrNumber(String str) {
   boolean isNumber = false;
-  for (byte i = 0; i < str.length(); i++) {
+  for (unsigned int i = 0; i < str.length(); i++) {
     isNumber = isDigit(str.charAt(i)) || str.charAt(i) == '+' || str.charAt(i) == '.' || str.charAt(i) == '-';
     if (!isNumber) {
       return false; // Non numeric character detected
@@ -521,21 +626,21 @@ void setOperatingMode(bool responseEnabled, bool apiEnabled, int inputOperatingM
   String commandKey = "OM";
 
   if ((inputOperatingMode >= CONF_OPERATING_MODE_MIN) && (inputOperatingMode <= CONF_OPERATING_MODE_MAX)) {   
-    if ((g_comMode == CONF_COM_MODE_BLE) && (inputOperatingMode == CONF_OPERATING_MODE_GAMEPAD)){
-      printResponseInt(responseEnabled, apiEnabled, false, 3, "OM,1", true, inputOperatingMode);    // Return error if user tries to change to Bluetooth mode while in Gamepad mode
+    if ((g_comMode == CONF_COM_MODE_BLE) && (inputOperatingMode == CONF_OPERATING_MODE_ABSOLUTE)){
+      printResponseInt(responseEnabled, apiEnabled, false, 3, "OM,1", true, inputOperatingMode);    // Return error if user tries to change to a USB only mode while in Bluetooth mode
     } else {
       mem.writeInt(CONF_SETTINGS_FILE, commandKey, inputOperatingMode);
       printResponseInt(responseEnabled, apiEnabled, true, 0, "OM,1", true, inputOperatingMode);
-      g_operatingMode = inputOperatingMode;
-      changeOperatingMode(inputOperatingMode);
+      // The new mode begins after a reset when it can't change in place, the screen and factory reset save their other settings before resetting
+      if (!changeOperatingMode(inputOperatingMode) && apiEnabled) {
+        softwareReset();
+      }
     }
   }
   else {
     printResponseInt(responseEnabled, apiEnabled, false, 3, "OM,1", true, inputOperatingMode);
   }
 
-  // TODO: move softwareReset() here instead of in changeOperatingMode?
-
 }
 //***SET OPERATING MODE STATE API FUNCTION***//
 // Function   : setOperatingMode
@@ -1420,6 +1525,1771 @@ void setPuffPressureThreshold(bool responseEnabled, bool apiEnabled, String opti
   setPuffPressureThreshold(responseEnabled, apiEnabled, optionalParameter.toFloat());
 }
 
+//***GET ADAPTIVE THRESHOLD MODE FUNCTION***//
+// Function   : getAdaptiveThresholdMode
+//
+// Description: This function retrieves the adaptive sip and puff threshold mode and applies it.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//
+// Return     : tempAdaptiveMode : int : The current adaptive threshold mode.
+//*********************************//
+int getAdaptiveThresholdMode(bool responseEnabled, bool apiEnabled) {
+  String commandKey = "AT";
+  int tempAdaptiveMode;
+  tempAdaptiveMode = mem.readInt(CONF_SETTINGS_FILE, commandKey);
+
+  if ((tempAdaptiveMode < CONF_PRESS_ADAPTIVE_MODE_MIN) || (tempAdaptiveMode > CONF_PRESS_ADAPTIVE_MODE_MAX)) {
+    tempAdaptiveMode = CONF_PRESS_ADAPTIVE_MODE_DEFAULT;
+    mem.writeInt(CONF_SETTINGS_FILE, commandKey, tempAdaptiveMode);
+  }
+
+  float tempAdaptiveFraction = getAdaptiveThresholdFraction(false, false) / 100.0;
+  ps.setAdaptiveThreshold(tempAdaptiveMode == CONF_PRESS_ADAPTIVE_MODE_ON, tempAdaptiveFraction, CONF_PRESS_ADAPTIVE_MIN_THRESHOLD, CONF_PRESS_ADAPTIVE_MAX_THRESHOLD);
+
+  printResponseInt(responseEnabled, apiEnabled, true, 0, "AT,0", true, tempAdaptiveMode);
+
+  return tempAdaptiveMode;
+}
+
+//***GET ADAPTIVE THRESHOLD MODE API FUNCTION***//
+// Function   : getAdaptiveThresholdMode
+//
+// Description: This function is redefinition of main getAdaptiveThresholdMode function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void getAdaptiveThresholdMode(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  if (optionalParameter.length() == 1 && optionalParameter.toInt() == 0) {
+    getAdaptiveThresholdMode(responseEnabled, apiEnabled);
+  }
+}
+
+//***SET ADAPTIVE THRESHOLD MODE FUNCTION***//
+// Function   : setAdaptiveThresholdMode
+//
+// Description: This function sets the adaptive sip and puff threshold mode.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               inputAdaptiveMode : int : The new adaptive threshold mode (0 = Off, 1 = On).
+//
+// Return     : void
+//*********************************//
+void setAdaptiveThresholdMode(bool responseEnabled, bool apiEnabled, int inputAdaptiveMode) {
+  String commandKey = "AT";
+
+  if ((inputAdaptiveMode >= CONF_PRESS_ADAPTIVE_MODE_MIN) && (inputAdaptiveMode <= CONF_PRESS_ADAPTIVE_MODE_MAX)) {
+    mem.writeInt(CONF_SETTINGS_FILE, commandKey, inputAdaptiveMode);
+    float tempAdaptiveFraction = getAdaptiveThresholdFraction(false, false) / 100.0;
+    ps.setAdaptiveThreshold(inputAdaptiveMode == CONF_PRESS_ADAPTIVE_MODE_ON, tempAdaptiveFraction, CONF_PRESS_ADAPTIVE_MIN_THRESHOLD, CONF_PRESS_ADAPTIVE_MAX_THRESHOLD);
+    printResponseInt(responseEnabled, apiEnabled, true, 0, "AT,1", true, inputAdaptiveMode);
+  }
+  else {
+    printResponseInt(responseEnabled, apiEnabled, false, 3, "AT,1", true, inputAdaptiveMode);
+  }
+}
+
+//***SET ADAPTIVE THRESHOLD MODE API FUNCTION***//
+// Function   : setAdaptiveThresholdMode
+//
+// Description: This function is redefinition of main setAdaptiveThresholdMode function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void setAdaptiveThresholdMode(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  setAdaptiveThresholdMode(responseEnabled, apiEnabled, optionalParameter.toInt());
+}
+
+//***GET ADAPTIVE THRESHOLD FRACTION FUNCTION***//
+// Function   : getAdaptiveThresholdFraction
+//
+// Description: This function retrieves the percentage of the typical sip or puff peak pressure used as adaptive threshold.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//
+// Return     : tempAdaptiveFraction : int : The current adaptive threshold percentage.
+//*********************************//
+int getAdaptiveThresholdFraction(bool responseEnabled, bool apiEnabled) {
+  String commandKey = "AF";
+  int tempAdaptiveFraction;
+  tempAdaptiveFraction = mem.readInt(CONF_SETTINGS_FILE, commandKey);
+
+  if ((tempAdaptiveFraction < CONF_PRESS_ADAPTIVE_FRACTION_MIN) || (tempAdaptiveFraction > CONF_PRESS_ADAPTIVE_FRACTION_MAX)) {
+    tempAdaptiveFraction = CONF_PRESS_ADAPTIVE_FRACTION_DEFAULT;
+    mem.writeInt(CONF_SETTINGS_FILE, commandKey, tempAdaptiveFraction);
+  }
+
+  printResponseInt(responseEnabled, apiEnabled, true, 0, "AF,0", true, tempAdaptiveFraction);
+
+  return tempAdaptiveFraction;
+}
+
+//***GET ADAPTIVE THRESHOLD FRACTION API FUNCTION***//
+// Function   : getAdaptiveThresholdFraction
+//
+// Description: This function is redefinition of main getAdaptiveThresholdFraction function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void getAdaptiveThresholdFraction(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  if (optionalParameter.length() == 1 && optionalParameter.toInt() == 0) {
+    getAdaptiveThresholdFraction(responseEnabled, apiEnabled);
+  }
+}
+
+//***SET ADAPTIVE THRESHOLD FRACTION FUNCTION***//
+// Function   : setAdaptiveThresholdFraction
+//
+// Description: This function sets the percentage of the typical sip or puff peak pressure used as adaptive threshold.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               inputAdaptiveFraction : int : The new adaptive threshold percentage.
+//
+// Return     : void
+//*********************************//
+void setAdaptiveThresholdFraction(bool responseEnabled, bool apiEnabled, int inputAdaptiveFraction) {
+  String commandKey = "AF";
+
+  if ((inputAdaptiveFraction >= CONF_PRESS_ADAPTIVE_FRACTION_MIN) && (inputAdaptiveFraction <= CONF_PRESS_ADAPTIVE_FRACTION_MAX)) {
+    mem.writeInt(CONF_SETTINGS_FILE, commandKey, inputAdaptiveFraction);
+    getAdaptiveThresholdMode(false, false);  // Apply the new percentage
+    printResponseInt(responseEnabled, apiEnabled, true, 0, "AF,1", true, inputAdaptiveFraction);
+  }
+  else {
+    printResponseInt(responseEnabled, apiEnabled, false, 3, "AF,1", true, inputAdaptiveFraction);
+  }
+}
+
+//***SET ADAPTIVE THRESHOLD FRACTION API FUNCTION***//
+// Function   : setAdaptiveThresholdFraction
+//
+// Description: This function is redefinition of main setAdaptiveThresholdFraction function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void setAdaptiveThresholdFraction(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  setAdaptiveThresholdFraction(responseEnabled, apiEnabled, optionalParameter.toInt());
+}
+
+//***GET HARD SIP PRESSURE THRESHOLD FUNCTION***//
+// Function   : getHardSipPressureThreshold
+//
+// Description: This function returns the current hard sip pressure threshold. Zero means hard sips are disabled.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//
+// Return     : tempHardSipThreshold : float : The current hard sip pressure threshold.
+//*********************************//
+float getHardSipPressureThreshold(bool responseEnabled, bool apiEnabled) {
+  String commandKey = "HS";
+  float tempHardSipThreshold;
+  tempHardSipThreshold = mem.readFloat(CONF_SETTINGS_FILE, commandKey);
+
+  if ((tempHardSipThreshold < 0.0) || (tempHardSipThreshold >= CONF_PRESS_MAX_THRESHOLD)) {
+    tempHardSipThreshold = CONF_SIP_HARD_THRESHOLD;
+    mem.writeFloat(CONF_SETTINGS_FILE, commandKey, tempHardSipThreshold);
+  }
+  ps.setHardSipThreshold(tempHardSipThreshold);
+  printResponseFloat(responseEnabled, apiEnabled, true, 0, "HS,0", true, tempHardSipThreshold);
+  return tempHardSipThreshold;
+}
+
+//***GET HARD SIP PRESSURE THRESHOLD API FUNCTION***//
+// Function   : getHardSipPressureThreshold
+//
+// Description: This function is redefinition of main getHardSipPressureThreshold function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void getHardSipPressureThreshold(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  if (optionalParameter.length() == 1 && optionalParameter.toInt() == 0) {
+    getHardSipPressureThreshold(responseEnabled, apiEnabled);
+  }
+}
+
+//***SET HARD SIP PRESSURE THRESHOLD FUNCTION***//
+// Function   : setHardSipPressureThreshold
+//
+// Description: This function sets the hard sip pressure threshold. Sips beyond it are reported as hard sips.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               inputHardSipThreshold : float : The new hard sip pressure threshold, or zero to disable.
+//
+// Return     : void
+//*********************************//
+void setHardSipPressureThreshold(bool responseEnabled, bool apiEnabled, float inputHardSipThreshold) {
+  String commandKey = "HS";
+
+  if (inputHardSipThreshold == 0.0 || (inputHardSipThreshold >= CONF_PRESS_MIN_THRESHOLD && inputHardSipThreshold < CONF_PRESS_MAX_THRESHOLD)) {
+    mem.writeFloat(CONF_SETTINGS_FILE, commandKey, inputHardSipThreshold);
+    ps.setHardSipThreshold(inputHardSipThreshold);
+    printResponseFloat(responseEnabled, apiEnabled, true, 0, "HS,1", true, inputHardSipThreshold);
+  }
+  else {
+    printResponseFloat(responseEnabled, apiEnabled, false, 3, "HS,1", true, inputHardSipThreshold);
+  }
+}
+
+//***SET HARD SIP PRESSURE THRESHOLD API FUNCTION***//
+// Function   : setHardSipPressureThreshold
+//
+// Description: This function is redefinition of main setHardSipPressureThreshold function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void setHardSipPressureThreshold(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  setHardSipPressureThreshold(responseEnabled, apiEnabled, optionalParameter.toFloat());
+}
+
+//***GET HARD PUFF PRESSURE THRESHOLD FUNCTION***//
+// Function   : getHardPuffPressureThreshold
+//
+// Description: This function returns the current hard puff pressure threshold. Zero means hard puffs are disabled.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//
+// Return     : tempHardPuffThreshold : float : The current hard puff pressure threshold.
+//*********************************//
+float getHardPuffPressureThreshold(bool responseEnabled, bool apiEnabled) {
+  String commandKey = "HP";
+  float tempHardPuffThreshold;
+  tempHardPuffThreshold = mem.readFloat(CONF_SETTINGS_FILE, commandKey);
+
+  if ((tempHardPuffThreshold < 0.0) || (tempHardPuffThreshold >= CONF_PRESS_MAX_THRESHOLD)) {
+    tempHardPuffThreshold = CONF_PUFF_HARD_THRESHOLD;
+    mem.writeFloat(CONF_SETTINGS_FILE, commandKey, tempHardPuffThreshold);
+  }
+  ps.setHardPuffThreshold(tempHardPuffThreshold);
+  printResponseFloat(responseEnabled, apiEnabled, true, 0, "HP,0", true, tempHardPuffThreshold);
+  return tempHardPuffThreshold;
+}
+
+//***GET HARD PUFF PRESSURE THRESHOLD API FUNCTION***//
+// Function   : getHardPuffPressureThreshold
+//
+// Description: This function is redefinition of main getHardPuffPressureThreshold function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void getHardPuffPressureThreshold(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  if (optionalParameter.length() == 1 && optionalParameter.toInt() == 0) {
+    getHardPuffPressureThreshold(responseEnabled, apiEnabled);
+  }
+}
+
+//***SET HARD PUFF PRESSURE THRESHOLD FUNCTION***//
+// Function   : setHardPuffPressureThreshold
+//
+// Description: This function sets the hard puff pressure threshold. Puffs beyond it are reported as hard puffs.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               inputHardPuffThreshold : float : The new hard puff pressure threshold, or zero to disable.
+//
+// Return     : void
+//*********************************//
+void setHardPuffPressureThreshold(bool responseEnabled, bool apiEnabled, float inputHardPuffThreshold) {
+  String commandKey = "HP";
+
+  if (inputHardPuffThreshold == 0.0 || (inputHardPuffThreshold >= CONF_PRESS_MIN_THRESHOLD && inputHardPuffThreshold < CONF_PRESS_MAX_THRESHOLD)) {
+    mem.writeFloat(CONF_SETTINGS_FILE, commandKey, inputHardPuffThreshold);
+    ps.setHardPuffThreshold(inputHardPuffThreshold);
+    printResponseFloat(responseEnabled, apiEnabled, true, 0, "HP,1", true, inputHardPuffThreshold);
+  }
+  else {
+    printResponseFloat(responseEnabled, apiEnabled, false, 3, "HP,1", true, inputHardPuffThreshold);
+  }
+}
+
+//***SET HARD PUFF PRESSURE THRESHOLD API FUNCTION***//
+// Function   : setHardPuffPressureThreshold
+//
+// Description: This function is redefinition of main setHardPuffPressureThreshold function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void setHardPuffPressureThreshold(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  setHardPuffPressureThreshold(responseEnabled, apiEnabled, optionalParameter.toFloat());
+}
+
+//***GET PRESSURE OUTPUT MODE FUNCTION***//
+// Function   : getPressureOutputMode
+//
+// Description: This function retrieves the proportional pressure output mode.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//
+// Return     : tempPressureOutputMode : int : The current proportional pressure output mode.
+//*********************************//
+int getPressureOutputMode(bool responseEnabled, bool apiEnabled) {
+  String commandKey = "PO";
+  int tempPressureOutputMode;
+  tempPressureOutputMode = mem.readInt(CONF_SETTINGS_FILE, commandKey);
+
+  if ((tempPressureOutputMode < CONF_PRESS_OUTPUT_MODE_MIN) || (tempPressureOutputMode > CONF_PRESS_OUTPUT_MODE_MAX)) {
+    tempPressureOutputMode = CONF_PRESS_OUTPUT_MODE_DEFAULT;
+    mem.writeInt(CONF_SETTINGS_FILE, commandKey, tempPressureOutputMode);
+  }
+
+  printResponseInt(responseEnabled, apiEnabled, true, 0, "PO,0", true, tempPressureOutputMode);
+
+  return tempPressureOutputMode;
+}
+
+//***GET PRESSURE OUTPUT MODE API FUNCTION***//
+// Function   : getPressureOutputMode
+//
+// Description: This function is redefinition of main getPressureOutputMode function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void getPressureOutputMode(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  if (optionalParameter.length() == 1 && optionalParameter.toInt() == 0) {
+    getPressureOutputMode(responseEnabled, apiEnabled);
+  }
+}
+
+//***SET PRESSURE OUTPUT MODE FUNCTION***//
+// Function   : setPressureOutputMode
+//
+// Description: This function sets the proportional pressure output mode (0 = Off, 1 = Gamepad axis, 2 = Scroll speed, 3 = Cursor speed).
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               inputPressureOutputMode : int : The new proportional pressure output mode.
+//
+// Return     : void
+//*********************************//
+void setPressureOutputMode(bool responseEnabled, bool apiEnabled, int inputPressureOutputMode) {
+  String commandKey = "PO";
+
+  if ((inputPressureOutputMode >= CONF_PRESS_OUTPUT_MODE_MIN) && (inputPressureOutputMode <= CONF_PRESS_OUTPUT_MODE_MAX)) {
+    mem.writeInt(CONF_SETTINGS_FILE, commandKey, inputPressureOutputMode);
+    performPressureOutput(0.0);  // Return the previous proportional output to rest
+    g_pressureOutputMode = inputPressureOutputMode;
+    printResponseInt(responseEnabled, apiEnabled, true, 0, "PO,1", true, inputPressureOutputMode);
+    bool zAxis = (inputPressureOutputMode == CONF_PRESS_OUTPUT_MODE_AXIS);
+    if ((usbHidStarted && gamepad.hasZAxis() != zAxis) || (bleGamepadStarted && btgamepad.hasZAxis() != zAxis)) {
+      softwareReset();  // The gamepad descriptor or report map gains or loses the Z axis
+    }
+  }
+  else {
+    printResponseInt(responseEnabled, apiEnabled, false, 3, "PO,1", true, inputPressureOutputMode);
+  }
+}
+
+//***SET PRESSURE OUTPUT MODE API FUNCTION***//
+// Function   : setPressureOutputMode
+//
+// Description: This function is redefinition of main setPressureOutputMode function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void setPressureOutputMode(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  setPressureOutputMode(responseEnabled, apiEnabled, optionalParameter.toInt());
+}
+
+//***GET PRESSURE OUTPUT DEADBAND FUNCTION***//
+// Function   : getPressureOutputDeadband
+//
+// Description: This function retrieves the pressure magnitude (hPa) below which the proportional pressure output is zero.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//
+// Return     : tempPressureOutputDeadband : float : The current pressure magnitude (hPa) below which the proportional pressure output is zero.
+//*********************************//
+float getPressureOutputDeadband(bool responseEnabled, bool apiEnabled) {
+  String commandKey = "PD";
+  float tempPressureOutputDeadband;
+  tempPressureOutputDeadband = mem.readFloat(CONF_SETTINGS_FILE, commandKey);
+
+  if ((tempPressureOutputDeadband < CONF_PRESS_OUTPUT_DEADBAND_MIN) || (tempPressureOutputDeadband > CONF_PRESS_OUTPUT_DEADBAND_MAX)) {
+    tempPressureOutputDeadband = CONF_PRESS_OUTPUT_DEADBAND_DEFAULT;
+    mem.writeFloat(CONF_SETTINGS_FILE, commandKey, tempPressureOutputDeadband);
+  }
+
+  printResponseFloat(responseEnabled, apiEnabled, true, 0, "PD,0", true, tempPressureOutputDeadband);
+
+  return tempPressureOutputDeadband;
+}
+
+//***GET PRESSURE OUTPUT DEADBAND API FUNCTION***//
+// Function   : getPressureOutputDeadband
+//
+// Description: This function is redefinition of main getPressureOutputDeadband function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void getPressureOutputDeadband(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  if (optionalParameter.length() == 1 && optionalParameter.toInt() == 0) {
+    getPressureOutputDeadband(responseEnabled, apiEnabled);
+  }
+}
+
+//***SET PRESSURE OUTPUT DEADBAND FUNCTION***//
+// Function   : setPressureOutputDeadband
+//
+// Description: This function sets the pressure magnitude (hPa) below which the proportional pressure output is zero.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               inputPressureOutputDeadband : float : The new proportional output deadband in hPa.
+//
+// Return     : void
+//*********************************//
+void setPressureOutputDeadband(bool responseEnabled, bool apiEnabled, float inputPressureOutputDeadband) {
+  String commandKey = "PD";
+
+  if ((inputPressureOutputDeadband >= CONF_PRESS_OUTPUT_DEADBAND_MIN) && (inputPressureOutputDeadband <= CONF_PRESS_OUTPUT_DEADBAND_MAX)) {
+    mem.writeFloat(CONF_SETTINGS_FILE, commandKey, inputPressureOutputDeadband);
+    g_pressureOutputDeadband = inputPressureOutputDeadband;
+    printResponseFloat(responseEnabled, apiEnabled, true, 0, "PD,1", true, inputPressureOutputDeadband);
+  }
+  else {
+    printResponseFloat(responseEnabled, apiEnabled, false, 3, "PD,1", true, inputPressureOutputDeadband);
+  }
+}
+
+//***SET PRESSURE OUTPUT DEADBAND API FUNCTION***//
+// Function   : setPressureOutputDeadband
+//
+// Description: This function is redefinition of main setPressureOutputDeadband function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void setPressureOutputDeadband(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  setPressureOutputDeadband(responseEnabled, apiEnabled, optionalParameter.toFloat());
+}
+
+//***GET PRESSURE OUTPUT CURVE FUNCTION***//
+// Function   : getPressureOutputCurve
+//
+// Description: This function retrieves the exponent of the proportional pressure output curve.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//
+// Return     : tempPressureOutputCurve : float : The current exponent of the proportional pressure output curve.
+//*********************************//
+float getPressureOutputCurve(bool responseEnabled, bool apiEnabled) {
+  String commandKey = "PC";
+  float tempPressureOutputCurve;
+  tempPressureOutputCurve = mem.readFloat(CONF_SETTINGS_FILE, commandKey);
+
+  if ((tempPressureOutputCurve < CONF_PRESS_OUTPUT_CURVE_MIN) || (tempPressureOutputCurve > CONF_PRESS_OUTPUT_CURVE_MAX)) {
+    tempPressureOutputCurve = CONF_PRESS_OUTPUT_CURVE_DEFAULT;
+    mem.writeFloat(CONF_SETTINGS_FILE, commandKey, tempPressureOutputCurve);
+  }
+
+  printResponseFloat(responseEnabled, apiEnabled, true, 0, "PC,0", true, tempPressureOutputCurve);
+
+  return tempPressureOutputCurve;
+}
+
+//***GET PRESSURE OUTPUT CURVE API FUNCTION***//
+// Function   : getPressureOutputCurve
+//
+// Description: This function is redefinition of main getPressureOutputCurve function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void getPressureOutputCurve(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  if (optionalParameter.length() == 1 && optionalParameter.toInt() == 0) {
+    getPressureOutputCurve(responseEnabled, apiEnabled);
+  }
+}
+
+//***SET PRESSURE OUTPUT CURVE FUNCTION***//
+// Function   : setPressureOutputCurve
+//
+// Description: This function sets the exponent of the proportional pressure output curve (1.0 = linear).
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               inputPressureOutputCurve : float : The new proportional output curve exponent.
+//
+// Return     : void
+//*********************************//
+void setPressureOutputCurve(bool responseEnabled, bool apiEnabled, float inputPressureOutputCurve) {
+  String commandKey = "PC";
+
+  if ((inputPressureOutputCurve >= CONF_PRESS_OUTPUT_CURVE_MIN) && (inputPressureOutputCurve <= CONF_PRESS_OUTPUT_CURVE_MAX)) {
+    mem.writeFloat(CONF_SETTINGS_FILE, commandKey, inputPressureOutputCurve);
+    g_pressureOutputCurve = inputPressureOutputCurve;
+    printResponseFloat(responseEnabled, apiEnabled, true, 0, "PC,1", true, inputPressureOutputCurve);
+  }
+  else {
+    printResponseFloat(responseEnabled, apiEnabled, false, 3, "PC,1", true, inputPressureOutputCurve);
+  }
+}
+
+//***SET PRESSURE OUTPUT CURVE API FUNCTION***//
+// Function   : setPressureOutputCurve
+//
+// Description: This function is redefinition of main setPressureOutputCurve function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void setPressureOutputCurve(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  setPressureOutputCurve(responseEnabled, apiEnabled, optionalParameter.toFloat());
+}
+
+//***GET GESTURE MODE FUNCTION***//
+// Function   : getGestureMode
+//
+// Description: This function retrieves the gesture sequence mode.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//
+// Return     : tempGestureMode : int : The current gesture sequence mode.
+//*********************************//
+int getGestureMode(bool responseEnabled, bool apiEnabled) {
+  String commandKey = "GS";
+  int tempGestureMode;
+  tempGestureMode = mem.readInt(CONF_SETTINGS_FILE, commandKey);
+
+  if ((tempGestureMode < CONF_GESTURE_MODE_MIN) || (tempGestureMode > CONF_GESTURE_MODE_MAX)) {
+    tempGestureMode = CONF_GESTURE_MODE_DEFAULT;
+    mem.writeInt(CONF_SETTINGS_FILE, commandKey, tempGestureMode);
+  }
+
+  printResponseInt(responseEnabled, apiEnabled, true, 0, "GS,0", true, tempGestureMode);
+
+  return tempGestureMode;
+}
+
+//***GET GESTURE MODE API FUNCTION***//
+// Function   : getGestureMode
+//
+// Description: This function is redefinition of main getGestureMode function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void getGestureMode(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  if (optionalParameter.length() == 1 && optionalParameter.toInt() == 0) {
+    getGestureMode(responseEnabled, apiEnabled);
+  }
+}
+
+//***SET GESTURE MODE FUNCTION***//
+// Function   : setGestureMode
+//
+// Description: This function sets the gesture sequence mode.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               inputGestureMode : int : The new gesture sequence mode. ( 0 = Off, 1 = On )
+//
+// Return     : void
+//*********************************//
+void setGestureMode(bool responseEnabled, bool apiEnabled, int inputGestureMode) {
+  String commandKey = "GS";
+
+  if ((inputGestureMode >= CONF_GESTURE_MODE_MIN) && (inputGestureMode <= CONF_GESTURE_MODE_MAX)) {
+    mem.writeInt(CONF_SETTINGS_FILE, commandKey, inputGestureMode);
+    gesture.clear();  // Drop any pending sequence
+    g_gestureMode = inputGestureMode;
+    printResponseInt(responseEnabled, apiEnabled, true, 0, "GS,1", true, inputGestureMode);
+  }
+  else {
+    printResponseInt(responseEnabled, apiEnabled, false, 3, "GS,1", true, inputGestureMode);
+  }
+}
+
+//***SET GESTURE MODE API FUNCTION***//
+// Function   : setGestureMode
+//
+// Description: This function is redefinition of main setGestureMode function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void setGestureMode(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  setGestureMode(responseEnabled, apiEnabled, optionalParameter.toInt());
+}
+
+//***GET DWELL MODE FUNCTION***//
+// Function   : getDwellMode
+//
+// Description: This function retrieves the dwell click mode.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//
+// Return     : tempDwellMode : int : The current dwell click mode.
+//*********************************//
+int getDwellMode(bool responseEnabled, bool apiEnabled) {
+  String commandKey = "DW";
+  int tempDwellMode;
+  tempDwellMode = mem.readInt(CONF_SETTINGS_FILE, commandKey);
+
+  if ((tempDwellMode < CONF_DWELL_MODE_MIN) || (tempDwellMode > CONF_DWELL_MODE_MAX)) {
+    tempDwellMode = CONF_DWELL_MODE_DEFAULT;
+    mem.writeInt(CONF_SETTINGS_FILE, commandKey, tempDwellMode);
+  }
+
+  printResponseInt(responseEnabled, apiEnabled, true, 0, "DW,0", true, tempDwellMode);
+
+  return tempDwellMode;
+}
+
+//***GET DWELL MODE API FUNCTION***//
+// Function   : getDwellMode
+//
+// Description: This function is redefinition of main getDwellMode function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void getDwellMode(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  if (optionalParameter.length() == 1 && optionalParameter.toInt() == 0) {
+    getDwellMode(responseEnabled, apiEnabled);
+  }
+}
+
+//***SET DWELL MODE FUNCTION***//
+// Function   : setDwellMode
+//
+// Description: This function sets the dwell click mode.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               inputDwellMode : int : The new dwell click mode. ( 0 = Off, 1 = Left click, 2 = Right click, 3 = Double click, 4 = Drag toggle )
+//
+// Return     : void
+//*********************************//
+void setDwellMode(bool responseEnabled, bool apiEnabled, int inputDwellMode) {
+  String commandKey = "DW";
+
+  if ((inputDwellMode >= CONF_DWELL_MODE_MIN) && (inputDwellMode <= CONF_DWELL_MODE_MAX)) {
+    mem.writeInt(CONF_SETTINGS_FILE, commandKey, inputDwellMode);
+    stopDwell();  // Drop any running countdown
+    g_dwellMode = inputDwellMode;
+    printResponseInt(responseEnabled, apiEnabled, true, 0, "DW,1", true, inputDwellMode);
+  }
+  else {
+    printResponseInt(responseEnabled, apiEnabled, false, 3, "DW,1", true, inputDwellMode);
+  }
+}
+
+//***SET DWELL MODE API FUNCTION***//
+// Function   : setDwellMode
+//
+// Description: This function is redefinition of main setDwellMode function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void setDwellMode(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  setDwellMode(responseEnabled, apiEnabled, optionalParameter.toInt());
+}
+
+//***GET DWELL TIME FUNCTION***//
+// Function   : getDwellTime
+//
+// Description: This function retrieves the time the cursor rests before a dwell click.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//
+// Return     : tempDwellTime : int : The current dwell time in milliseconds.
+//*********************************//
+int getDwellTime(bool responseEnabled, bool apiEnabled) {
+  String commandKey = "DT";
+  int tempDwellTime;
+  tempDwellTime = mem.readInt(CONF_SETTINGS_FILE, commandKey);
+
+  if ((tempDwellTime < CONF_DWELL_TIME_MIN) || (tempDwellTime > CONF_DWELL_TIME_MAX)) {
+    tempDwellTime = CONF_DWELL_TIME_DEFAULT;
+    mem.writeInt(CONF_SETTINGS_FILE, commandKey, tempDwellTime);
+  }
+  dwell.setDwellTime(tempDwellTime);
+
+  printResponseInt(responseEnabled, apiEnabled, true, 0, "DT,0", true, tempDwellTime);
+
+  return tempDwellTime;
+}
+
+//***GET DWELL TIME API FUNCTION***//
+// Function   : getDwellTime
+//
+// Description: This function is redefinition of main getDwellTime function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void getDwellTime(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  if (optionalParameter.length() == 1 && optionalParameter.toInt() == 0) {
+    getDwellTime(responseEnabled, apiEnabled);
+  }
+}
+
+//***SET DWELL TIME FUNCTION***//
+// Function   : setDwellTime
+//
+// Description: This function sets the time the cursor rests before a dwell click.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               inputDwellTime : int : The new dwell time in milliseconds. ( 300 to 5000 )
+//
+// Return     : void
+//*********************************//
+void setDwellTime(bool responseEnabled, bool apiEnabled, int inputDwellTime) {
+  String commandKey = "DT";
+
+  if ((inputDwellTime >= CONF_DWELL_TIME_MIN) && (inputDwellTime <= CONF_DWELL_TIME_MAX)) {
+    mem.writeInt(CONF_SETTINGS_FILE, commandKey, inputDwellTime);
+    dwell.setDwellTime(inputDwellTime);
+    printResponseInt(responseEnabled, apiEnabled, true, 0, "DT,1", true, inputDwellTime);
+  }
+  else {
+    printResponseInt(responseEnabled, apiEnabled, false, 3, "DT,1", true, inputDwellTime);
+  }
+}
+
+//***SET DWELL TIME API FUNCTION***//
+// Function   : setDwellTime
+//
+// Description: This function is redefinition of main setDwellTime function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain the dwell time.
+//
+// Return     : void
+void setDwellTime(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  setDwellTime(responseEnabled, apiEnabled, optionalParameter.toInt());
+}
+
+//***GET HIGH RESOLUTION MODE FUNCTION***//
+// Function   : getHighResMode
+//
+// Description: This function retrieves the high resolution mouse mode.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//
+// Return     : tempHighResMode : int : The current high resolution mouse mode.
+//*********************************//
+int getHighResMode(bool responseEnabled, bool apiEnabled) {
+  String commandKey = "HR";
+  int tempHighResMode;
+  tempHighResMode = mem.readInt(CONF_SETTINGS_FILE, commandKey);
+
+  if ((tempHighResMode < CONF_HIGH_RES_MODE_MIN) || (tempHighResMode > CONF_HIGH_RES_MODE_MAX)) {
+    tempHighResMode = CONF_HIGH_RES_MODE_DEFAULT;
+    mem.writeInt(CONF_SETTINGS_FILE, commandKey, tempHighResMode);
+  }
+
+  printResponseInt(responseEnabled, apiEnabled, true, 0, "HR,0", true, tempHighResMode);
+
+  return tempHighResMode;
+}
+
+//***GET HIGH RESOLUTION MODE API FUNCTION***//
+// Function   : getHighResMode
+//
+// Description: This function is redefinition of main getHighResMode function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void getHighResMode(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  if (optionalParameter.length() == 1 && optionalParameter.toInt() == 0) {
+    getHighResMode(responseEnabled, apiEnabled);
+  }
+}
+
+//***SET HIGH RESOLUTION MODE FUNCTION***//
+// Function   : setHighResMode
+//
+// Description: This function sets the high resolution mouse mode.
+//              The composite USB descriptor is read by the host when the device mounts, so the device
+//              is reset when the mouse format of the started USB interface changes.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               inputHighResMode : int : The new high resolution mouse mode. ( 0 = Off, 1 = On )
+//
+// Return     : void
+//*********************************//
+void setHighResMode(bool responseEnabled, bool apiEnabled, int inputHighResMode) {
+  String commandKey = "HR";
+
+  if ((inputHighResMode >= CONF_HIGH_RES_MODE_MIN) && (inputHighResMode <= CONF_HIGH_RES_MODE_MAX)) {
+    mem.writeInt(CONF_SETTINGS_FILE, commandKey, inputHighResMode);
+    printResponseInt(responseEnabled, apiEnabled, true, 0, "HR,1", true, inputHighResMode);
+    if (usbHidStarted && (usbmouse.isHighResolution() != (inputHighResMode == CONF_HIGH_RES_MODE_ON))) {
+      softwareReset();
+    }
+  }
+  else {
+    printResponseInt(responseEnabled, apiEnabled, false, 3, "HR,1", true, inputHighResMode);
+  }
+}
+
+//***SET HIGH RESOLUTION MODE API FUNCTION***//
+// Function   : setHighResMode
+//
+// Description: This function is redefinition of main setHighResMode function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void setHighResMode(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  setHighResMode(responseEnabled, apiEnabled, optionalParameter.toInt());
+}
+
+//***GET ABSOLUTE POINTER MODE FUNCTION***//
+// Function   : getAbsoluteMode
+//
+// Description: This function retrieves the absolute pointer mode.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//
+// Return     : tempAbsoluteMode : int : The current absolute pointer mode.
+//*********************************//
+int getAbsoluteMode(bool responseEnabled, bool apiEnabled) {
+  String commandKey = "AP";
+  int tempAbsoluteMode;
+  tempAbsoluteMode = mem.readInt(CONF_SETTINGS_FILE, commandKey);
+
+  if ((tempAbsoluteMode < CONF_ABS_MODE_MIN) || (tempAbsoluteMode > CONF_ABS_MODE_MAX)) {
+    tempAbsoluteMode = CONF_ABS_MODE_DEFAULT;
+    mem.writeInt(CONF_SETTINGS_FILE, commandKey, tempAbsoluteMode);
+  }
+  g_absoluteMode = tempAbsoluteMode;
+
+  printResponseInt(responseEnabled, apiEnabled, true, 0, "AP,0", true, tempAbsoluteMode);
+
+  return tempAbsoluteMode;
+}
+
+//***GET ABSOLUTE POINTER MODE API FUNCTION***//
+// Function   : getAbsoluteMode
+//
+// Description: This function is redefinition of main getAbsoluteMode function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void getAbsoluteMode(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  if (optionalParameter.length() == 1 && optionalParameter.toInt() == 0) {
+    getAbsoluteMode(responseEnabled, apiEnabled);
+  }
+}
+
+//***SET ABSOLUTE POINTER MODE FUNCTION***//
+// Function   : setAbsoluteMode
+//
+// Description: This function sets the absolute pointer mode.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               inputAbsoluteMode : int : The new absolute pointer mode. ( 0 = Integrate, 1 = Direct )
+//
+// Return     : void
+//*********************************//
+void setAbsoluteMode(bool responseEnabled, bool apiEnabled, int inputAbsoluteMode) {
+  String commandKey = "AP";
+
+  if ((inputAbsoluteMode >= CONF_ABS_MODE_MIN) && (inputAbsoluteMode <= CONF_ABS_MODE_MAX)) {
+    mem.writeInt(CONF_SETTINGS_FILE, commandKey, inputAbsoluteMode);
+    g_absoluteMode = inputAbsoluteMode;
+    pointer.center();
+    printResponseInt(responseEnabled, apiEnabled, true, 0, "AP,1", true, inputAbsoluteMode);
+  }
+  else {
+    printResponseInt(responseEnabled, apiEnabled, false, 3, "AP,1", true, inputAbsoluteMode);
+  }
+}
+
+//***SET ABSOLUTE POINTER MODE API FUNCTION***//
+// Function   : setAbsoluteMode
+//
+// Description: This function is redefinition of main setAbsoluteMode function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void setAbsoluteMode(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  setAbsoluteMode(responseEnabled, apiEnabled, optionalParameter.toInt());
+}
+
+//***GET ABSOLUTE POINTER REGION FUNCTION***//
+// Function   : getAbsoluteRegion
+//
+// Description: This function retrieves the absolute pointer screen region.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//
+// Return     : tempAbsoluteRegion : int : The current absolute pointer screen region.
+//*********************************//
+int getAbsoluteRegion(bool responseEnabled, bool apiEnabled) {
+  String commandKey = "AR";
+  int tempAbsoluteRegion;
+  tempAbsoluteRegion = mem.readInt(CONF_SETTINGS_FILE, commandKey);
+
+  if ((tempAbsoluteRegion < CONF_ABS_REGION_MIN) || (tempAbsoluteRegion > CONF_ABS_REGION_MAX)) {
+    tempAbsoluteRegion = CONF_ABS_REGION_DEFAULT;
+    mem.writeInt(CONF_SETTINGS_FILE, commandKey, tempAbsoluteRegion);
+  }
+  setAbsoluteRegionProperty(tempAbsoluteRegion);
+
+  printResponseInt(responseEnabled, apiEnabled, true, 0, "AR,0", true, tempAbsoluteRegion);
+
+  return tempAbsoluteRegion;
+}
+
+//***GET ABSOLUTE POINTER REGION API FUNCTION***//
+// Function   : getAbsoluteRegion
+//
+// Description: This function is redefinition of main getAbsoluteRegion function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void getAbsoluteRegion(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  if (optionalParameter.length() == 1 && optionalParameter.toInt() == 0) {
+    getAbsoluteRegion(responseEnabled, apiEnabled);
+  }
+}
+
+//***SET ABSOLUTE POINTER REGION FUNCTION***//
+// Function   : setAbsoluteRegion
+//
+// Description: This function sets the absolute pointer screen region.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               inputAbsoluteRegion : int : The new screen region. ( 0 = Full, 1 = Left half, 2 = Right half, 3 = Top half, 4 = Bottom half, 5 = Center )
+//
+// Return     : void
+//*********************************//
+void setAbsoluteRegion(bool responseEnabled, bool apiEnabled, int inputAbsoluteRegion) {
+  String commandKey = "AR";
+
+  if ((inputAbsoluteRegion >= CONF_ABS_REGION_MIN) && (inputAbsoluteRegion <= CONF_ABS_REGION_MAX)) {
+    mem.writeInt(CONF_SETTINGS_FILE, commandKey, inputAbsoluteRegion);
+    setAbsoluteRegionProperty(inputAbsoluteRegion);
+    printResponseInt(responseEnabled, apiEnabled, true, 0, "AR,1", true, inputAbsoluteRegion);
+  }
+  else {
+    printResponseInt(responseEnabled, apiEnabled, false, 3, "AR,1", true, inputAbsoluteRegion);
+  }
+}
+
+//***SET ABSOLUTE POINTER REGION API FUNCTION***//
+// Function   : setAbsoluteRegion
+//
+// Description: This function is redefinition of main setAbsoluteRegion function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void setAbsoluteRegion(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  setAbsoluteRegion(responseEnabled, apiEnabled, optionalParameter.toInt());
+}
+
+//***GET ABSOLUTE POINTER GRID FUNCTION***//
+// Function   : getAbsoluteGrid
+//
+// Description: This function retrieves the number of snap grid cells per axis of the absolute pointer.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//
+// Return     : tempAbsoluteGrid : int : The current number of snap grid cells per axis of the absolute pointer.
+//*********************************//
+int getAbsoluteGrid(bool responseEnabled, bool apiEnabled) {
+  String commandKey = "AG";
+  int tempAbsoluteGrid;
+  tempAbsoluteGrid = mem.readInt(CONF_SETTINGS_FILE, commandKey);
+
+  if ((tempAbsoluteGrid < CONF_ABS_GRID_MIN) || (tempAbsoluteGrid > CONF_ABS_GRID_MAX)) {
+    tempAbsoluteGrid = CONF_ABS_GRID_DEFAULT;
+    mem.writeInt(CONF_SETTINGS_FILE, commandKey, tempAbsoluteGrid);
+  }
+  pointer.setGrid(tempAbsoluteGrid);
+
+  printResponseInt(responseEnabled, apiEnabled, true, 0, "AG,0", true, tempAbsoluteGrid);
+
+  return tempAbsoluteGrid;
+}
+
+//***GET ABSOLUTE POINTER GRID API FUNCTION***//
+// Function   : getAbsoluteGrid
+//
+// Description: This function is redefinition of main getAbsoluteGrid function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void getAbsoluteGrid(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  if (optionalParameter.length() == 1 && optionalParameter.toInt() == 0) {
+    getAbsoluteGrid(responseEnabled, apiEnabled);
+  }
+}
+
+//***SET ABSOLUTE POINTER GRID FUNCTION***//
+// Function   : setAbsoluteGrid
+//
+// Description: This function sets the number of snap grid cells per axis of the absolute pointer.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               inputAbsoluteGrid : int : The new number of grid cells per axis. ( 0 = No snapping, up to 16 )
+//
+// Return     : void
+//*********************************//
+void setAbsoluteGrid(bool responseEnabled, bool apiEnabled, int inputAbsoluteGrid) {
+  String commandKey = "AG";
+
+  if ((inputAbsoluteGrid >= CONF_ABS_GRID_MIN) && (inputAbsoluteGrid <= CONF_ABS_GRID_MAX)) {
+    mem.writeInt(CONF_SETTINGS_FILE, commandKey, inputAbsoluteGrid);
+    pointer.setGrid(inputAbsoluteGrid);
+    printResponseInt(responseEnabled, apiEnabled, true, 0, "AG,1", true, inputAbsoluteGrid);
+  }
+  else {
+    printResponseInt(responseEnabled, apiEnabled, false, 3, "AG,1", true, inputAbsoluteGrid);
+  }
+}
+
+//***SET ABSOLUTE POINTER GRID API FUNCTION***//
+// Function   : setAbsoluteGrid
+//
+// Description: This function is redefinition of main setAbsoluteGrid function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void setAbsoluteGrid(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  setAbsoluteGrid(responseEnabled, apiEnabled, optionalParameter.toInt());
+}
+
+//***GET BLUETOOTH CONNECTION FUNCTION***//
+// Function   : getBluetoothConnection
+//
+// Description: This function retrieves the current Bluetooth connection parameters, the number of
+//              connection parameter updates that took effect since start up and the number of reports
+//              that waited for a free notification buffer. Active is 1 while the connection uses an interval
+//              shorter than the idle interval.
+//              Output is interval,slave latency,supervision timeout,updates,active,tx queue full
+//              in units of 1.25 ms, connection events and 10 ms. The parameters are 0 when not connected.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//
+// Return     : void
+//*********************************//
+void getBluetoothConnection(bool responseEnabled, bool apiEnabled) {
+  const int outputArraySize = 6;
+  int tempConnection[outputArraySize];
+  tempConnection[0] = btconnection.getInterval();
+  tempConnection[1] = btconnection.getSlaveLatency();
+  tempConnection[2] = btconnection.getSupervisionTimeout();
+  tempConnection[3] = (int)btconnection.getUpdateCount();
+  tempConnection[4] = btconnection.isActive() ? 1 : 0;
+  tempConnection[5] = (int)bletx.getFullCount();
+
+  printResponseIntArray(responseEnabled, apiEnabled, true, 0, "BC,0", true, "", outputArraySize, ',', tempConnection);
+}
+
+//***GET BLUETOOTH CONNECTION API FUNCTION***//
+// Function   : getBluetoothConnection
+//
+// Description: This function is redefinition of main getBluetoothConnection function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void getBluetoothConnection(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  if (optionalParameter.length() == 1 && optionalParameter.toInt() == 0) {
+    getBluetoothConnection(responseEnabled, apiEnabled);
+  }
+}
+
+//***GET BLUETOOTH HOST FUNCTION***//
+// Function   : getBluetoothHost
+//
+// Description: This function retrieves the selected Bluetooth host slot.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//
+// Return     : tempBluetoothHost : int : The selected Bluetooth host slot.
+//*********************************//
+int getBluetoothHost(bool responseEnabled, bool apiEnabled) {
+  String commandKey = "BH";
+  int tempBluetoothHost;
+  tempBluetoothHost = mem.readInt(CONF_SETTINGS_FILE, commandKey);
+
+  if ((tempBluetoothHost < CONF_BT_HOST_MIN) || (tempBluetoothHost > CONF_BT_HOST_MAX)) {
+    tempBluetoothHost = CONF_BT_HOST_DEFAULT;
+    mem.writeInt(CONF_SETTINGS_FILE, commandKey, tempBluetoothHost);
+  }
+
+  printResponseInt(responseEnabled, apiEnabled, true, 0, "BH,0", true, tempBluetoothHost);
+
+  return tempBluetoothHost;
+}
+
+//***GET BLUETOOTH HOST API FUNCTION***//
+// Function   : getBluetoothHost
+//
+// Description: This function is redefinition of main getBluetoothHost function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void getBluetoothHost(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  if (optionalParameter.length() == 1 && optionalParameter.toInt() == 0) {
+    getBluetoothHost(responseEnabled, apiEnabled);
+  }
+}
+
+//***SET BLUETOOTH HOST FUNCTION***//
+// Function   : setBluetoothHost
+//
+// Description: This function selects a Bluetooth host slot. In Bluetooth mode the current host is disconnected
+//              and the device advertises to the host of the slot, or pairs a new host if the slot is empty.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               inputBluetoothHost : int : The new Bluetooth host slot. ( 0 to 2 )
+//
+// Return     : void
+//*********************************//
+void setBluetoothHost(bool responseEnabled, bool apiEnabled, int inputBluetoothHost) {
+  String commandKey = "BH";
+
+  if ((inputBluetoothHost >= CONF_BT_HOST_MIN) && (inputBluetoothHost <= CONF_BT_HOST_MAX)) {
+    mem.writeInt(CONF_SETTINGS_FILE, commandKey, inputBluetoothHost);
+    if (g_comMode == CONF_COM_MODE_BLE) {
+      blehosts.select(inputBluetoothHost, millis());
+    } else {
+      blehosts.setSlot(inputBluetoothHost);
+    }
+    printResponseInt(responseEnabled, apiEnabled, true, 0, "BH,1", true, inputBluetoothHost);
+  }
+  else {
+    printResponseInt(responseEnabled, apiEnabled, false, 3, "BH,1", true, inputBluetoothHost);
+  }
+}
+
+//***SET BLUETOOTH HOST API FUNCTION***//
+// Function   : setBluetoothHost
+//
+// Description: This function is redefinition of main setBluetoothHost function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void setBluetoothHost(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  setBluetoothHost(responseEnabled, apiEnabled, optionalParameter.toInt());
+}
+
+//***NEXT BLUETOOTH HOST FUNCTION***//
+// Function   : nextBluetoothHost
+//
+// Description: This function switches to the next Bluetooth host slot.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//
+// Return     : void
+//*********************************//
+void nextBluetoothHost(bool responseEnabled, bool apiEnabled) {
+  int tempBluetoothHost = blehosts.getSlot();
+  if (tempBluetoothHost < CONF_BT_HOST_MAX) {
+    tempBluetoothHost++;
+  }
+  else {
+    tempBluetoothHost = CONF_BT_HOST_MIN;
+  }
+  setBluetoothHost(responseEnabled, apiEnabled, tempBluetoothHost);
+}
+
+//***GET BLUETOOTH HOST STATUS FUNCTION***//
+// Function   : getBluetoothHostStatus
+//
+// Description: This function retrieves the state of the Bluetooth host slots.
+//              Output is slot,paired slots,reconnect time,switches,rejected connections,unfilterable host
+//              where paired slots has one bit per slot with a host, reconnect time is the time in ms
+//              from the last switch to the connection of the host ( -1 while not connected ), and unfilterable host
+//              is 1 when the host connected in the empty selected slot uses a private address that can't be stored.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//
+// Return     : void
+//*********************************//
+void getBluetoothHostStatus(bool responseEnabled, bool apiEnabled) {
+  const int outputArraySize = 6;
+  int tempHostStatus[outputArraySize];
+  tempHostStatus[0] = blehosts.getSlot();
+  tempHostStatus[1] = 0;
+  for (int slot = 0; slot < BLE_HOST_SLOTS; slot++) {
+    tempHostStatus[1] |= blehosts.isValid(slot) ? (1 << slot) : 0;
+  }
+  tempHostStatus[2] = (int)blehosts.getReconnectTime();
+  tempHostStatus[3] = (int)blehosts.getSwitchCount();
+  tempHostStatus[4] = (int)blehosts.getRejectCount();
+  tempHostStatus[5] = blehosts.isUnfilterable(tempHostStatus[0]) ? 1 : 0;
+
+  printResponseIntArray(responseEnabled, apiEnabled, true, 0, "BS,0", true, "", outputArraySize, ',', tempHostStatus);
+}
+
+//***GET BLUETOOTH HOST STATUS API FUNCTION***//
+// Function   : getBluetoothHostStatus
+//
+// Description: This function is redefinition of main getBluetoothHostStatus function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void getBluetoothHostStatus(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  if (optionalParameter.length() == 1 && optionalParameter.toInt() == 0) {
+    getBluetoothHostStatus(responseEnabled, apiEnabled);
+  }
+}
+
+//***FORGET BLUETOOTH HOST FUNCTION***//
+// Function   : forgetBluetoothHost
+//
+// Description: This function clears a Bluetooth host slot, so a new host can pair in the slot.
+//              It fails when the host of the slot is unfilterable, as that host was never stored.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               inputBluetoothHost : int : The Bluetooth host slot to clear. ( 0 to 2 )
+//
+// Return     : void
+//*********************************//
+void forgetBluetoothHost(bool responseEnabled, bool apiEnabled, int inputBluetoothHost) {
+  if (!blehosts.isUnfilterable(inputBluetoothHost) && blehosts.forget(inputBluetoothHost)) {
+    saveBluetoothHost();
+    printResponseInt(responseEnabled, apiEnabled, true, 0, "BF,1", true, inputBluetoothHost);
+  }
+  else {
+    printResponseInt(responseEnabled, apiEnabled, false, 3, "BF,1", true, inputBluetoothHost);
+  }
+}
+
+//***FORGET BLUETOOTH HOST API FUNCTION***//
+// Function   : forgetBluetoothHost
+//
+// Description: This function is redefinition of main forgetBluetoothHost function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain one element with value of zero.
+//
+// Return     : void
+void forgetBluetoothHost(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  forgetBluetoothHost(responseEnabled, apiEnabled, optionalParameter.toInt());
+}
+
+//***GET ACTION MAPPING FUNCTION***//
+// Function   : getActionMap
+//
+// Description: This function retrieves a whole action mapping table.
+//              Entries are separated by '-'. Input table entries are
+//              state.mouseAction.gamepadAction.menuAction.safeModeAction.startTime.endTime
+//              where the state of a chord is the sum of its inputs ( 1 = Sip, 2 = Puff, 4 and 8 = Buttons 1 and 2,
+//              16, 32 and 64 = Switches 1 to 3 )
+//              and led table entries are action.led.startColor.endColor.endAction
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               inputTable : int : The table. ( 0 = Sip and Puff, 1 = Buttons, 2 = Switches, 3 = Chords, 4 = Led )
+//
+// Return     : void
+//*********************************//
+void getActionMap(bool responseEnabled, bool apiEnabled, int inputTable) {
+  if (inputTable < 0 || inputTable >= ACTION_MAP_TABLE_NUMBER) {
+    printResponseInt(responseEnabled, apiEnabled, false, 3, "AM,0", true, inputTable);
+    return;
+  }
+
+  String tableString = String(inputTable);
+  if (inputTable == ACTION_MAP_TABLE_LED) {
+    const ledActionStruct* ledTable = actionMap.getLedTable();
+    for (int ledIndex = 0; ledIndex < actionMap.getLedSize(); ledIndex++) {
+      tableString += "-" + String(ledTable[ledIndex].ledOutputActionNumber) +
+                     "." + String(ledTable[ledIndex].ledNumber) +
+                     "." + String(ledTable[ledIndex].ledStartColor) +
+                     "." + String(ledTable[ledIndex].ledEndColor) +
+                     "." + String(ledTable[ledIndex].ledEndAction);
+    }
+  } else {
+    const inputActionStruct* actionTable = actionMap.getInputTable(inputTable);
+    for (int actionIndex = 0; actionIndex < actionMap.getInputSize(inputTable); actionIndex++) {
+      tableString += "-" + String(actionTable[actionIndex].inputActionState) +
+                     "." + String(actionTable[actionIndex].mouseOutputActionNumber) +
+                     "." + String(actionTable[actionIndex].gamepadOutputActionNumber) +
+                     "." + String(actionTable[actionIndex].menuOutputActionNumber) +
+                     "." + String(actionTable[actionIndex].safeModeOutputActionNumber) +
+                     "." + String(actionTable[actionIndex].inputActionStartTime) +
+                     "." + String(actionTable[actionIndex].inputActionEndTime);
+    }
+  }
+  printResponseString(responseEnabled, apiEnabled, true, 0, "AM,0", true, tableString);
+}
+
+//***GET ACTION MAPPING API FUNCTION***//
+// Function   : getActionMap
+//
+// Description: This function is redefinition of main getActionMap function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain the table number.
+//
+// Return     : void
+void getActionMap(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  if (optionalParameter.length() == 1) {
+    getActionMap(responseEnabled, apiEnabled, optionalParameter.toInt());
+  }
+}
+
+//***SET ACTION MAPPING FUNCTION***//
+// Function   : setActionMap
+//
+// Description: This function replaces a whole action mapping table and saves the mapping to flash memory.
+//              The parameter is the table number followed by its entries, in the format of getActionMap.
+//              A table number without entries restores the default table.
+//              The table is only replaced if every entry is valid and no two windows of the same input state overlap.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               inputTableString : String : The table number and entries.
+//
+// Return     : void
+//*********************************//
+void setActionMap(bool responseEnabled, bool apiEnabled, String inputTableString) {
+  int entryIndex = inputTableString.indexOf('-');
+  int inputTable = inputTableString.substring(0, entryIndex).toInt();
+  int result = ACTION_MAP_VALID;
+
+  if (entryIndex < 0 && inputTableString.length() == 1 && inputTable >= 0 && inputTable < ACTION_MAP_TABLE_NUMBER) {
+    actionMap.resetTable(inputTable);
+  }
+  else if (inputTable == ACTION_MAP_TABLE_LED && entryIndex > 0) {
+    ledActionStruct tempLedAction[ACTION_MAP_LED_MAX_SIZE];
+    unsigned long entryValue[5];
+    int ledSize = 0;
+    while (entryIndex >= 0 && result == ACTION_MAP_VALID) {
+      if (ledSize >= ACTION_MAP_LED_MAX_SIZE) {
+        result = ACTION_MAP_ERROR_SIZE;
+      } else if (!parseActionMapEntry(inputTableString, &entryIndex, entryValue, 5)) {
+        result = ACTION_MAP_ERROR_RECORD;
+      } else {
+        tempLedAction[ledSize++] = { (uint8_t)min(entryValue[0], 255UL), (uint8_t)min(entryValue[1], 255UL), (uint8_t)min(entryValue[2], 255UL),
+                                     (uint8_t)min(entryValue[3], 255UL), (uint8_t)min(entryValue[4], 255UL) };
+      }
+    }
+    if (result == ACTION_MAP_VALID) {
+      result = actionMap.setLedTable(tempLedAction, ledSize);
+    }
+  }
+  else if (inputTable >= 0 && inputTable < ACTION_MAP_INPUT_TABLE_NUMBER && entryIndex > 0) {
+    inputActionStruct tempInputAction[ACTION_MAP_MAX_SIZE];
+    unsigned long entryValue[7];
+    int actionSize = 0;
+    while (entryIndex >= 0 && result == ACTION_MAP_VALID) {
+      if (actionSize >= ACTION_MAP_MAX_SIZE) {
+        result = ACTION_MAP_ERROR_SIZE;
+      } else if (!parseActionMapEntry(inputTableString, &entryIndex, entryValue, 7)) {
+        result = ACTION_MAP_ERROR_RECORD;
+      } else {
+        tempInputAction[actionSize++] = { (uint8_t)min(entryValue[0], 255UL), (uint8_t)min(entryValue[1], 255UL), (uint8_t)min(entryValue[2], 255UL),
+                                          (uint8_t)min(entryValue[3], 255UL), (uint8_t)min(entryValue[4], 255UL), entryValue[5], entryValue[6] };
+      }
+    }
+    if (result == ACTION_MAP_VALID) {
+      result = actionMap.setInputTable(inputTable, tempInputAction, actionSize);
+    }
+  }
+  else {
+    result = ACTION_MAP_ERROR_TABLE;
+  }
+
+  if (result == ACTION_MAP_VALID && saveActionMap()) {
+    applyActionMap(inputTable);
+    printResponseInt(responseEnabled, apiEnabled, true, 0, "AM,1", true, inputTable);
+  }
+  else {
+    printResponseInt(responseEnabled, apiEnabled, false, 3, "AM,1", true, result);
+  }
+}
+
+//***PARSE ACTION MAPPING ENTRY FUNCTION***//
+// Function   : parseActionMapEntry
+//
+// Description: This function parses one '-' prefixed entry of '.' separated values of an action mapping table string.
+//
+// Parameters :  inputTableString : String : The table string
+//               entryIndex : int* : Index of the '-' before the entry. Set to the index of the next entry, or -1 after the last entry.
+//               entryValue : unsigned long[] : Parsed values
+//               valueNumber : int : Number of values expected in the entry
+//
+// Return     : bool : true if the entry has the expected number of values
+//*********************************//
+bool parseActionMapEntry(String inputTableString, int* entryIndex, unsigned long entryValue[], int valueNumber) {
+  int nextEntryIndex = inputTableString.indexOf('-', *entryIndex + 1);
+  String entryString = inputTableString.substring(*entryIndex + 1, (nextEntryIndex < 0) ? inputTableString.length() : nextEntryIndex);
+  *entryIndex = nextEntryIndex;
+
+  int valueStart = 0;
+  for (int valueIndex = 0; valueIndex < valueNumber; valueIndex++) {
+    int valueEnd = entryString.indexOf('.', valueStart);
+    if ((valueIndex < valueNumber - 1) == (valueEnd < 0)) {
+      return false;  // Too few or too many values
+    }
+    String valueString = entryString.substring(valueStart, (valueEnd < 0) ? entryString.length() : valueEnd);
+    if (valueString.length() == 0) {
+      return false;
+    }
+    entryValue[valueIndex] = valueString.toInt();
+    valueStart = valueEnd + 1;
+  }
+  return true;
+}
+
+//***GET MACRO FUNCTION***//
+// Function   : getMacro
+//
+// Description: This function retrieves the steps of a macro.
+//              Steps are separated by '-' and each step is type.parameter1.parameter2.delay
+//              Signed parameters (mouse movement and scroll) are sent as bytes, e.g. 255 = -1.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               inputMacroNumber : int : The macro number. ( 1 to CONF_MACRO_NUMBER )
+//
+// Return     : void
+//*********************************//
+void getMacro(bool responseEnabled, bool apiEnabled, int inputMacroNumber) {
+  const macroStruct* tempMacro = macro.getMacro(inputMacroNumber - 1);
+  if (tempMacro == NULL) {
+    printResponseInt(responseEnabled, apiEnabled, false, 3, "MA,0", true, inputMacroNumber);
+    return;
+  }
+
+  String macroString = String(inputMacroNumber);
+  for (int stepIndex = 0; stepIndex < tempMacro->stepCount; stepIndex++) {
+    macroString += "-" + String(tempMacro->step[stepIndex].stepType) +
+                   "." + String(tempMacro->step[stepIndex].stepParameter1) +
+                   "." + String(tempMacro->step[stepIndex].stepParameter2) +
+                   "." + String(tempMacro->step[stepIndex].stepDelay);
+  }
+  printResponseString(responseEnabled, apiEnabled, true, 0, "MA,0", true, macroString);
+}
+
+//***GET MACRO API FUNCTION***//
+// Function   : getMacro
+//
+// Description: This function is redefinition of main getMacro function to match the types of API function arguments.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               optionalParameter : String : The input parameter string should contain the macro number.
+//
+// Return     : void
+void getMacro(bool responseEnabled, bool apiEnabled, String optionalParameter) {
+  if (optionalParameter.length() == 1) {
+    getMacro(responseEnabled, apiEnabled, optionalParameter.toInt());
+  }
+}
+
+//***SET MACRO FUNCTION***//
+// Function   : setMacro
+//
+// Description: This function replaces the steps of a macro and saves all macros to flash memory.
+//              The parameter is the macro number followed by its steps, in the format of getMacro.
+//              A macro number without steps restores the default macro.
+//
+// Parameters :  responseEnabled : bool : The response for serial printing is enabled if it's set to true.
+//                                        The serial printing is ignored if it's set to false.
+//               apiEnabled : bool : The api response is sent if it's set to true.
+//                                   Manual response is sent if it's set to false.
+//               inputMacroString : String : The macro number and steps.
+//
+// Return     : void
+//*********************************//
+void setMacro(bool responseEnabled, bool apiEnabled, String inputMacroString) {
+  int stepStringIndex = inputMacroString.indexOf('-');
+  int inputMacroNumber = inputMacroString.substring(0, stepStringIndex).toInt();
+  int result = MACRO_VALID;
+
+  if (inputMacroNumber < 1 || inputMacroNumber > CONF_MACRO_NUMBER || (stepStringIndex < 0 && inputMacroString.length() != 1)) {
+    result = MACRO_ERROR_INDEX;
+  }
+  else if (stepStringIndex < 0) {
+    macro.resetMacro(inputMacroNumber - 1);
+  }
+  else {
+    macroStepStruct tempStep[MACRO_MAX_STEPS];
+    unsigned long stepValue[4];
+    int stepCount = 0;
+    while (stepStringIndex >= 0 && result == MACRO_VALID) {
+      if (stepCount >= MACRO_MAX_STEPS) {
+        result = MACRO_ERROR_SIZE;
+      } else if (!parseActionMapEntry(inputMacroString, &stepStringIndex, stepValue, 4)) {
+        result = MACRO_ERROR_STEP;
+      } else {
+        tempStep[stepCount++] = { (uint8_t)min(stepValue[0], 255UL), (uint8_t)min(stepValue[1], 255UL),
+                                  (uint8_t)min(stepValue[2], 255UL), (uint8_t)min(stepValue[3], 255UL) };
+      }
+    }
+    if (result == MACRO_VALID) {
+      result = macro.setMacro(inputMacroNumber - 1, tempStep, stepCount);
+    }
+  }
+
+  if (result == MACRO_VALID && saveMacro()) {
+    printResponseInt(responseEnabled, apiEnabled, true, 0, "MA,1", true, inputMacroNumber);
+  }
+  else {
+    printResponseInt(responseEnabled, apiEnabled, false, 3, "MA,1", true, result);
+  }
+}
+
 //***GET JOYSTICK ACCELERATION FUNCTION***//
 // Function   : getJoystickAcceleration
 //
@@ -1627,8 +3497,8 @@ void setCommunicationMode(bool responseEnabled, bool apiEnabled, int inputCommun
   String commandKey = "CM";
   
   if ((inputCommunicationMode >= CONF_COM_MODE_MIN) && (inputCommunicationMode <= CONF_COM_MODE_MAX)) {
-    if ((inputCommunicationMode == CONF_COM_MODE_BLE) && (g_operatingMode == CONF_OPERATING_MODE_GAMEPAD)){
-      printResponseInt(responseEnabled, apiEnabled, false, 3, "CM,1", true, inputCommunicationMode);    // Return error if user tries to change to Bluetooth mode while in Gamepad mode
+    if ((inputCommunicationMode == CONF_COM_MODE_BLE) && (g_operatingMode == CONF_OPERATING_MODE_ABSOLUTE)){
+      printResponseInt(responseEnabled, apiEnabled, false, 3, "CM,1", true, inputCommunicationMode);    // Return error if user tries to change to Bluetooth mode while in Absolute mode
     } else {
       g_comMode = inputCommunicationMode;
       setCommunicationModeLed(g_comMode);
@@ -1640,13 +3510,14 @@ void setCommunicationMode(bool responseEnabled, bool apiEnabled, int inputCommun
     // TODO: move this?
     releaseOutputAction();
     switch(g_comMode) {
-      case CONF_COM_MODE_USB:       // USB Mouse
+      case CONF_COM_MODE_USB:       // USB Mouse or Gamepad
         btmouse.end();
-        usbmouse.begin();    
+        btgamepad.end();
+        (g_operatingMode == CONF_OPERATING_MODE_GAMEPAD) ? gamepad.begin() : usbmouse.begin();
         break;
-      case CONF_COM_MODE_BLE:       // Bluetooth Mouse
+      case CONF_COM_MODE_BLE:       // Bluetooth Mouse or Gamepad
         usbmouse.end();
-        btmouse.begin();
+        (g_operatingMode == CONF_OPERATING_MODE_GAMEPAD) ? btgamepad.begin() : btmouse.begin();
         break;
     }
 
@@ -0,0 +1,504 @@
+/*
+* File: LSActionMap.h
+* Firmware: LipSync
+* Developed by: MakersMakingChange
+* Version: v4.1 (28 March 2025)
+  License: GPL v3.0 or later
+
+  Copyright (C) 2024 - 2025 Neil Squire Society
+  This program is free software: you can redistribute it and/or modify it under the terms of
+  the GNU General Public License as published by the Free Software Foundation,
+  either version 3 of the License, or (at your option) any later version.
+  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License along with this program.
+  If not, see <http://www.gnu.org/licenses/>
+*/
+
+//Header definition
+#ifndef _LSACTIONMAP_H
+#define _LSACTIONMAP_H
+
+// Action mapping tables
+#define ACTION_MAP_TABLE_SAP 0
+#define ACTION_MAP_TABLE_BUTTON 1
+#define ACTION_MAP_TABLE_SWITCH 2
+#define ACTION_MAP_TABLE_CHORD 3
+#define ACTION_MAP_TABLE_LED 4
+
+#define ACTION_MAP_INPUT_TABLE_NUMBER 4         // Sip and puff, button, switch and chord tables
+#define ACTION_MAP_TABLE_NUMBER 5
+
+#define ACTION_MAP_MAX_SIZE ACTION_TABLE_MAX_SIZE  // Maximum number of entries per input table
+#define ACTION_MAP_LED_MAX_SIZE 32                 // Maximum number of led entries ( indexed by output action )
+#define ACTION_MAP_TIME_MAX 65535                  // Action window times are stored as 16 bit values (ms)
+
+// Binary record : {ID0, ID1, VERSION, TABLE COUNT} {TABLE, ENTRY COUNT, ENTRIES...} ... {CHECKSUM}
+#define ACTION_MAP_RECORD_ID0 'L'
+#define ACTION_MAP_RECORD_ID1 'A'
+#define ACTION_MAP_RECORD_VERSION 2             // Version 2 adds the chord table
+#define ACTION_MAP_RECORD_HEADER_SIZE 4
+#define ACTION_MAP_TABLE_HEADER_SIZE 2
+#define ACTION_MAP_INPUT_ENTRY_SIZE 9           // state, 4 actions, start time (2 bytes), end time (2 bytes)
+#define ACTION_MAP_LED_ENTRY_SIZE 5             // action, led, start color, end color, end action
+#define ACTION_MAP_RECORD_MAX_SIZE (ACTION_MAP_RECORD_HEADER_SIZE \
+                                    + ACTION_MAP_INPUT_TABLE_NUMBER * (ACTION_MAP_TABLE_HEADER_SIZE + ACTION_MAP_MAX_SIZE * ACTION_MAP_INPUT_ENTRY_SIZE) \
+                                    + ACTION_MAP_TABLE_HEADER_SIZE + ACTION_MAP_LED_MAX_SIZE * ACTION_MAP_LED_ENTRY_SIZE + 1)
+
+// Validation results
+#define ACTION_MAP_VALID 0
+#define ACTION_MAP_ERROR_TABLE 1                // Unknown table
+#define ACTION_MAP_ERROR_SIZE 2                 // Too many entries
+#define ACTION_MAP_ERROR_STATE 3                // Input main state out of range
+#define ACTION_MAP_ERROR_ACTION 4               // Output action out of range
+#define ACTION_MAP_ERROR_WINDOW 5               // End time before start time or beyond ACTION_MAP_TIME_MAX
+#define ACTION_MAP_ERROR_OVERLAP 6              // Two windows of the same main state overlap
+#define ACTION_MAP_ERROR_LED 7                  // Led number, color or led action out of range
+#define ACTION_MAP_ERROR_RECORD 8               // Binary record header, length or checksum is invalid
+
+class LSActionMap {
+  private:
+    inputActionStruct _inputAction[ACTION_MAP_INPUT_TABLE_NUMBER][ACTION_MAP_MAX_SIZE];
+    int _inputSize[ACTION_MAP_INPUT_TABLE_NUMBER];
+    ledActionStruct _ledAction[ACTION_MAP_LED_MAX_SIZE];  // Indexed by output action
+    int _ledSize;
+    int validateInputTable(const inputActionStruct actionProperty[], int actionSize, int stateNumber);
+    int checkInputTable(int table, const inputActionStruct actionProperty[], int actionSize);
+    int validateLedTable(const ledActionStruct ledProperty[], int ledSize);
+    void writeUint16(uint8_t* buffer, unsigned long value);
+    unsigned long readUint16(const uint8_t* buffer);
+  public:
+    LSActionMap();
+    void resetTable(int table);
+    int setInputTable(int table, const inputActionStruct actionProperty[], int actionSize);
+    int setLedTable(const ledActionStruct ledProperty[], int ledSize);
+    const inputActionStruct* getInputTable(int table);
+    int getInputSize(int table);
+    const ledActionStruct* getLedTable();
+    int getLedSize();
+    const ledActionStruct& getLedAction(int outputAction);
+    int encode(uint8_t* buffer, int bufferSize);
+    int decode(const uint8_t* buffer, int length);
+};
+
+//*********************************//
+// Function   : LSActionMap
+//
+// Description: Construct LSActionMap with the default action mapping of LSConfig.h
+//
+// Arguments :  void
+//
+// Return     : void
+//*********************************//
+LSActionMap::LSActionMap() {
+  for (int tableIndex = 0; tableIndex < ACTION_MAP_TABLE_NUMBER; tableIndex++) {
+    resetTable(tableIndex);
+  }
+}
+
+//*********************************//
+// Function   : resetTable
+//
+// Description: Restore the default mapping of a table.
+//
+// Arguments :  table : int : ACTION_MAP_TABLE_SAP, _BUTTON, _SWITCH, _CHORD or _LED
+//
+// Return     : void
+//*********************************//
+void LSActionMap::resetTable(int table) {
+  switch (table) {
+    case ACTION_MAP_TABLE_SAP:
+      setInputTable(table, sapActionProperty, sizeof(sapActionProperty) / sizeof(inputActionStruct));
+      break;
+    case ACTION_MAP_TABLE_BUTTON:
+      setInputTable(table, buttonActionProperty, sizeof(buttonActionProperty) / sizeof(inputActionStruct));
+      break;
+    case ACTION_MAP_TABLE_SWITCH:
+      setInputTable(table, switchActionProperty, sizeof(switchActionProperty) / sizeof(inputActionStruct));
+      break;
+    case ACTION_MAP_TABLE_CHORD:
+      setInputTable(table, chordActionProperty, sizeof(chordActionProperty) / sizeof(inputActionStruct));
+      break;
+    case ACTION_MAP_TABLE_LED:
+      setLedTable(ledActionProperty, sizeof(ledActionProperty) / sizeof(ledActionStruct));
+      break;
+  }
+}
+
+//*********************************//
+// Function   : setInputTable
+//
+// Description: Validate and replace an input action table. The table is left unchanged if it's invalid.
+//
+// Arguments :  table : int : ACTION_MAP_TABLE_SAP, _BUTTON, _SWITCH or _CHORD
+//              actionProperty : const inputActionStruct[] : New action mapping
+//              actionSize : int : Number of entries
+//
+// Return     : int : ACTION_MAP_VALID or validation error
+//*********************************//
+int LSActionMap::setInputTable(int table, const inputActionStruct actionProperty[], int actionSize) {
+  int result = checkInputTable(table, actionProperty, actionSize);
+  if (result == ACTION_MAP_VALID) {
+    memcpy(_inputAction[table], actionProperty, actionSize * sizeof(inputActionStruct));
+    _inputSize[table] = actionSize;
+  }
+  return result;
+}
+
+//*********************************//
+// Function   : checkInputTable
+//
+// Description: Check an input action table against the main states of its table without changing it.
+//
+// Arguments :  table : int : ACTION_MAP_TABLE_SAP, _BUTTON, _SWITCH or _CHORD
+//              actionProperty : const inputActionStruct[] : Action mapping
+//              actionSize : int : Number of entries
+//
+// Return     : int : ACTION_MAP_VALID or validation error
+//*********************************//
+int LSActionMap::checkInputTable(int table, const inputActionStruct actionProperty[], int actionSize) {
+  if (table < 0 || table >= ACTION_MAP_INPUT_TABLE_NUMBER) {
+    return ACTION_MAP_ERROR_TABLE;
+  }
+
+  int stateNumber = (table == ACTION_MAP_TABLE_CHORD) ? CONF_CHORD_STATE_NUMBER : ACTION_COMMIT_STATE_NUMBER;
+  return validateInputTable(actionProperty, actionSize, stateNumber);
+}
+
+//*********************************//
+// Function   : setLedTable
+//
+// Description: Validate and replace the led action table. The table is left unchanged if it's invalid.
+//
+// Arguments :  ledProperty : const ledActionStruct[] : New led actions
+//              ledSize : int : Number of entries
+//
+// Return     : int : ACTION_MAP_VALID or validation error
+//*********************************//
+int LSActionMap::setLedTable(const ledActionStruct ledProperty[], int ledSize) {
+  int result = validateLedTable(ledProperty, ledSize);
+  if (result != ACTION_MAP_VALID) {
+    return result;
+  }
+
+  // Store each entry at the index of its output action, so the led action is found without a search
+  memset(_ledAction, 0, sizeof(_ledAction));
+  _ledSize = 0;
+  for (int ledIndex = 0; ledIndex < ledSize; ledIndex++) {
+    int outputAction = ledProperty[ledIndex].ledOutputActionNumber;
+    _ledAction[outputAction] = ledProperty[ledIndex];
+    if (_ledSize <= outputAction) {
+      _ledSize = outputAction + 1;
+    }
+  }
+  for (int ledIndex = 0; ledIndex < _ledSize; ledIndex++) {
+    _ledAction[ledIndex].ledOutputActionNumber = ledIndex;  // Actions without an entry have no led action
+  }
+  return ACTION_MAP_VALID;
+}
+
+//*********************************//
+// Function   : getInputTable
+//
+// Description: Get an input action table.
+//
+// Arguments :  table : int : ACTION_MAP_TABLE_SAP, _BUTTON, _SWITCH or _CHORD
+//
+// Return     : const inputActionStruct* : Action mapping entries
+//*********************************//
+const inputActionStruct* LSActionMap::getInputTable(int table) {
+  return _inputAction[constrain(table, 0, ACTION_MAP_INPUT_TABLE_NUMBER - 1)];
+}
+
+//*********************************//
+// Function   : getInputSize
+//
+// Description: Get the number of entries of an input action table.
+//
+// Arguments :  table : int : ACTION_MAP_TABLE_SAP, _BUTTON, _SWITCH or _CHORD
+//
+// Return     : int : Number of entries
+//*********************************//
+int LSActionMap::getInputSize(int table) {
+  if (table < 0 || table >= ACTION_MAP_INPUT_TABLE_NUMBER) {
+    return 0;
+  }
+  return _inputSize[table];
+}
+
+//*********************************//
+// Function   : getLedTable
+//
+// Description: Get the led action table, indexed by output action.
+//
+// Arguments :  void
+//
+// Return     : const ledActionStruct* : Led action entries
+//*********************************//
+const ledActionStruct* LSActionMap::getLedTable() {
+  return _ledAction;
+}
+
+//*********************************//
+// Function   : getLedSize
+//
+// Description: Get the number of entries of the led action table.
+//
+// Arguments :  void
+//
+// Return     : int : Number of entries
+//*********************************//
+int LSActionMap::getLedSize() {
+  return _ledSize;
+}
+
+//*********************************//
+// Function   : getLedAction
+//
+// Description: Get the led action of an output action.
+//
+// Arguments :  outputAction : int : Output action
+//
+// Return     : const ledActionStruct& : Led action, or the led action of CONF_ACTION_NOTHING if out of range
+//*********************************//
+const ledActionStruct& LSActionMap::getLedAction(int outputAction) {
+  if (outputAction < 0 || outputAction >= ACTION_MAP_LED_MAX_SIZE) {
+    return _ledAction[CONF_ACTION_NOTHING];
+  }
+  return _ledAction[outputAction];
+}
+
+//*********************************//
+// Function   : encode
+//
+// Description: Write all tables to a compact binary record.
+//
+// Arguments :  buffer : uint8_t* : Record buffer
+//              bufferSize : int : Size of the buffer
+//
+// Return     : int : Length of the record, or 0 if the buffer is too small
+//*********************************//
+int LSActionMap::encode(uint8_t* buffer, int bufferSize) {
+  if (bufferSize < ACTION_MAP_RECORD_MAX_SIZE) {
+    return 0;
+  }
+
+  int length = 0;
+  buffer[length++] = ACTION_MAP_RECORD_ID0;
+  buffer[length++] = ACTION_MAP_RECORD_ID1;
+  buffer[length++] = ACTION_MAP_RECORD_VERSION;
+  buffer[length++] = ACTION_MAP_TABLE_NUMBER;
+
+  for (int tableIndex = 0; tableIndex < ACTION_MAP_INPUT_TABLE_NUMBER; tableIndex++) {
+    buffer[length++] = tableIndex;
+    buffer[length++] = _inputSize[tableIndex];
+    for (int actionIndex = 0; actionIndex < _inputSize[tableIndex]; actionIndex++) {
+      const inputActionStruct& action = _inputAction[tableIndex][actionIndex];
+      buffer[length++] = action.inputActionState;
+      buffer[length++] = action.mouseOutputActionNumber;
+      buffer[length++] = action.gamepadOutputActionNumber;
+      buffer[length++] = action.menuOutputActionNumber;
+      buffer[length++] = action.safeModeOutputActionNumber;
+      writeUint16(&buffer[length], action.inputActionStartTime);
+      writeUint16(&buffer[length + 2], action.inputActionEndTime);
+      length += 4;
+    }
+  }
+
+  buffer[length++] = ACTION_MAP_TABLE_LED;
+  buffer[length++] = _ledSize;
+  for (int ledIndex = 0; ledIndex < _ledSize; ledIndex++) {
+    buffer[length++] = _ledAction[ledIndex].ledOutputActionNumber;
+    buffer[length++] = _ledAction[ledIndex].ledNumber;
+    buffer[length++] = _ledAction[ledIndex].ledStartColor;
+    buffer[length++] = _ledAction[ledIndex].ledEndColor;
+    buffer[length++] = _ledAction[ledIndex].ledEndAction;
+  }
+
+  uint8_t checksum = 0;
+  for (int byteIndex = 0; byteIndex < length; byteIndex++) {
+    checksum += buffer[byteIndex];
+  }
+  buffer[length++] = checksum;
+
+  return length;
+}
+
+//*********************************//
+// Function   : decode
+//
+// Description: Load tables from a binary record. The whole record is checked first, and its tables only
+//              replace the current tables if all of them are valid. Tables missing from the record are left unchanged.
+//
+// Arguments :  buffer : const uint8_t* : Record
+//              length : int : Length of the record
+//
+// Return     : int : ACTION_MAP_VALID, or the first error found
+//*********************************//
+int LSActionMap::decode(const uint8_t* buffer, int length) {
+  if (length < ACTION_MAP_RECORD_HEADER_SIZE + 1
+      || buffer[0] != ACTION_MAP_RECORD_ID0
+      || buffer[1] != ACTION_MAP_RECORD_ID1
+      || buffer[2] != ACTION_MAP_RECORD_VERSION) {
+    return ACTION_MAP_ERROR_RECORD;
+  }
+
+  uint8_t checksum = 0;
+  for (int byteIndex = 0; byteIndex < length - 1; byteIndex++) {
+    checksum += buffer[byteIndex];
+  }
+  if (checksum != buffer[length - 1]) {
+    return ACTION_MAP_ERROR_RECORD;
+  }
+
+  // The first pass only checks the tables, the second pass replaces them
+  for (int pass = 0; pass < 2; pass++) {
+    bool apply = (pass == 1);
+    int position = ACTION_MAP_RECORD_HEADER_SIZE;
+    int tableCount = buffer[3];
+    for (int tableIndex = 0; tableIndex < tableCount; tableIndex++) {
+      if (position + ACTION_MAP_TABLE_HEADER_SIZE > length - 1) {
+        return ACTION_MAP_ERROR_RECORD;
+      }
+      int table = buffer[position];
+      int entryCount = buffer[position + 1];
+      position += ACTION_MAP_TABLE_HEADER_SIZE;
+
+      int tableResult;
+      if (table == ACTION_MAP_TABLE_LED) {
+        if (entryCount > ACTION_MAP_LED_MAX_SIZE || position + entryCount * ACTION_MAP_LED_ENTRY_SIZE > length - 1) {
+          return ACTION_MAP_ERROR_RECORD;
+        }
+        ledActionStruct tempLedAction[ACTION_MAP_LED_MAX_SIZE];
+        for (int ledIndex = 0; ledIndex < entryCount; ledIndex++) {
+          tempLedAction[ledIndex] = { buffer[position], buffer[position + 1], buffer[position + 2], buffer[position + 3], buffer[position + 4] };
+          position += ACTION_MAP_LED_ENTRY_SIZE;
+        }
+        tableResult = apply ? setLedTable(tempLedAction, entryCount) : validateLedTable(tempLedAction, entryCount);
+      } else {
+        if (entryCount > ACTION_MAP_MAX_SIZE || position + entryCount * ACTION_MAP_INPUT_ENTRY_SIZE > length - 1) {
+          return ACTION_MAP_ERROR_RECORD;
+        }
+        inputActionStruct tempInputAction[ACTION_MAP_MAX_SIZE];
+        for (int actionIndex = 0; actionIndex < entryCount; actionIndex++) {
+          tempInputAction[actionIndex] = { buffer[position], buffer[position + 1], buffer[position + 2], buffer[position + 3], buffer[position + 4],
+                                           readUint16(&buffer[position + 5]), readUint16(&buffer[position + 7]) };
+          position += ACTION_MAP_INPUT_ENTRY_SIZE;
+        }
+        tableResult = apply ? setInputTable(table, tempInputAction, entryCount) : checkInputTable(table, tempInputAction, entryCount);
+      }
+
+      if (tableResult != ACTION_MAP_VALID) {
+        return tableResult;  // Only reached in the first pass, nothing was replaced
+      }
+    }
+  }
+  return ACTION_MAP_VALID;
+}
+
+//*********************************//
+// Function   : validateInputTable
+//
+// Description: Check the ranges of an input action table and that no two windows of the same main state overlap.
+//
+// Arguments :  actionProperty : const inputActionStruct[] : Action mapping
+//              actionSize : int : Number of entries
+//              stateNumber : int : Number of input main states of the table
+//
+// Return     : int : ACTION_MAP_VALID or validation error
+//*********************************//
+int LSActionMap::validateInputTable(const inputActionStruct actionProperty[], int actionSize, int stateNumber) {
+  if (actionSize < 0 || actionSize > ACTION_MAP_MAX_SIZE) {
+    return ACTION_MAP_ERROR_SIZE;
+  }
+
+  for (int actionIndex = 0; actionIndex < actionSize; actionIndex++) {
+    const inputActionStruct& action = actionProperty[actionIndex];
+    if (action.inputActionState >= stateNumber) {
+      return ACTION_MAP_ERROR_STATE;
+    }
+    if (action.mouseOutputActionNumber >= CONF_ACTION_NUMBER
+        || action.gamepadOutputActionNumber >= CONF_ACTION_NUMBER
+        || action.menuOutputActionNumber >= CONF_ACTION_NUMBER
+        || action.safeModeOutputActionNumber >= CONF_ACTION_NUMBER) {
+      return ACTION_MAP_ERROR_ACTION;
+    }
+    if (action.inputActionEndTime < action.inputActionStartTime || action.inputActionEndTime > ACTION_MAP_TIME_MAX) {
+      return ACTION_MAP_ERROR_WINDOW;
+    }
+
+    // Empty windows ( e.g. the entry of no input ) can't overlap
+    if (action.inputActionEndTime == action.inputActionStartTime) {
+      continue;
+    }
+    for (int otherIndex = 0; otherIndex < actionIndex; otherIndex++) {
+      const inputActionStruct& other = actionProperty[otherIndex];
+      if (other.inputActionState == action.inputActionState
+          && other.inputActionStartTime < action.inputActionEndTime
+          && action.inputActionStartTime < other.inputActionEndTime) {
+        return ACTION_MAP_ERROR_OVERLAP;
+      }
+    }
+  }
+  return ACTION_MAP_VALID;
+}
+
+//*********************************//
+// Function   : validateLedTable
+//
+// Description: Check the ranges of a led action table.
+//
+// Arguments :  ledProperty : const ledActionStruct[] : Led actions
+//              ledSize : int : Number of entries
+//
+// Return     : int : ACTION_MAP_VALID or validation error
+//*********************************//
+int LSActionMap::validateLedTable(const ledActionStruct ledProperty[], int ledSize) {
+  if (ledSize < 0 || ledSize > ACTION_MAP_LED_MAX_SIZE) {
+    return ACTION_MAP_ERROR_SIZE;
+  }
+
+  for (int ledIndex = 0; ledIndex < ledSize; ledIndex++) {
+    if (ledProperty[ledIndex].ledOutputActionNumber >= CONF_ACTION_NUMBER) {
+      return ACTION_MAP_ERROR_ACTION;
+    }
+    if (ledProperty[ledIndex].ledNumber > CONF_LED_ALL
+        || ledProperty[ledIndex].ledStartColor > LED_CLR_WHITE
+        || ledProperty[ledIndex].ledEndColor > LED_CLR_WHITE
+        || ledProperty[ledIndex].ledEndAction > LED_ACTION_BLINKFAST) {
+      return ACTION_MAP_ERROR_LED;
+    }
+  }
+  return ACTION_MAP_VALID;
+}
+
+//*********************************//
+// Function   : writeUint16
+//
+// Description: Write a 16 bit value to a buffer, least significant byte first.
+//
+// Arguments :  buffer : uint8_t* : Destination
+//              value : unsigned long : Value
+//
+// Return     : void
+//*********************************//
+void LSActionMap::writeUint16(uint8_t* buffer, unsigned long value) {
+  buffer[0] = value & 0xFF;
+  buffer[1] = (value >> 8) & 0xFF;
+}
+
+//*********************************//
+// Function   : readUint16
+//
+// Description: Read a 16 bit value from a buffer, least significant byte first.
+//
+// Arguments :  buffer : const uint8_t* : Source
+//
+// Return     : unsigned long : Value
+//*********************************//
+unsigned long LSActionMap::readUint16(const uint8_t* buffer) {
+  return buffer[0] | ((unsigned long)buffer[1] << 8);
+}
+
+#endif
@@ -0,0 +1,204 @@
+/*
+* File: LSActionTable.h
+* Firmware: LipSync
+* Developed by: MakersMakingChange
+* Version: v4.1 (28 March 2025)
+  License: GPL v3.0 or later
+
+  Copyright (C) 2024 - 2025 Neil Squire Society
+  This program is free software: you can redistribute it and/or modify it under the terms of
+  the GNU General Public License as published by the Free Software Foundation,
+  either version 3 of the License, or (at your option) any later version.
+  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License along with this program.
+  If not, see <http://www.gnu.org/licenses/>
+*/
+
+//Header definition
+#ifndef _LSACTIONTABLE_H
+#define _LSACTIONTABLE_H
+
+#define ACTION_TABLE_MAX_SIZE 32              // Maximum number of action windows per input source
+#define ACTION_TABLE_STATE_NUMBER CONF_CHORD_STATE_NUMBER  // Number of input main states (input states of each source fit within chord states)
+
+// Action columns
+#define ACTION_TABLE_MODE_MOUSE 0
+#define ACTION_TABLE_MODE_GAMEPAD 1
+#define ACTION_TABLE_MODE_MENU 2
+#define ACTION_TABLE_MODE_SAFE 3
+#define ACTION_TABLE_MODE_NUMBER 4
+
+#define ACTION_TABLE_NO_ACTION -1             // No action window contains the elapsed time
+
+// Action interval structure ( One action window of an input main state, with the output action of each mode )
+typedef struct {
+  unsigned long startTime;
+  unsigned long endTime;
+  uint8_t outputAction[ACTION_TABLE_MODE_NUMBER];
+} actionIntervalStruct;
+
+class LSActionTable {
+  private:
+    actionIntervalStruct _interval[ACTION_TABLE_MAX_SIZE];    // Action windows grouped by main state and sorted by start time
+    uint8_t _stateOffset[ACTION_TABLE_STATE_NUMBER + 1];      // First window of each main state
+    int _intervalCount;
+    unsigned long _maxTime;
+  public:
+    LSActionTable();
+    void begin(const inputActionStruct actionProperty[], int actionSize);
+    int getAction(int mode, int mainState, unsigned long elapsedTime);
+    unsigned long getMaxTime();
+    unsigned long getLastStartTime(int mainState);
+    int getIntervalCount(int mainState);
+};
+
+//*********************************//
+// Function   : LSActionTable
+//
+// Description: Construct LSActionTable
+//
+// Arguments :  void
+//
+// Return     : void
+//*********************************//
+LSActionTable::LSActionTable() {
+  _intervalCount = 0;
+  _maxTime = 0;
+  memset(_stateOffset, 0, sizeof(_stateOffset));
+}
+
+//*********************************//
+// Function   : begin
+//
+// Description: Compile an action mapping table into action windows grouped by input main state
+//              and sorted by start time, so the action of an input state is found by binary search.
+//              Call again after the action mapping changes.
+//
+// Arguments :  actionProperty : const inputActionStruct[] : Action mapping table
+//              actionSize : int : Number of entries in the table
+//
+// Return     : void
+//*********************************//
+void LSActionTable::begin(const inputActionStruct actionProperty[], int actionSize) {
+  _intervalCount = 0;
+  _maxTime = 0;
+
+  for (int stateIndex = 0; stateIndex < ACTION_TABLE_STATE_NUMBER; stateIndex++) {
+    _stateOffset[stateIndex] = _intervalCount;
+
+    for (int actionIndex = 0; actionIndex < actionSize && _intervalCount < ACTION_TABLE_MAX_SIZE; actionIndex++) {
+      if (actionProperty[actionIndex].inputActionState != stateIndex
+          || actionProperty[actionIndex].inputActionEndTime <= actionProperty[actionIndex].inputActionStartTime) {
+        continue;  // Other main state or empty window
+      }
+
+      actionIntervalStruct newInterval = {
+        actionProperty[actionIndex].inputActionStartTime,
+        actionProperty[actionIndex].inputActionEndTime,
+        { actionProperty[actionIndex].mouseOutputActionNumber,
+          actionProperty[actionIndex].gamepadOutputActionNumber,
+          actionProperty[actionIndex].menuOutputActionNumber,
+          actionProperty[actionIndex].safeModeOutputActionNumber }
+      };
+
+      // Insert sorted by start time
+      int insertIndex = _intervalCount;
+      while (insertIndex > _stateOffset[stateIndex] && _interval[insertIndex - 1].startTime > newInterval.startTime) {
+        _interval[insertIndex] = _interval[insertIndex - 1];
+        insertIndex--;
+      }
+      _interval[insertIndex] = newInterval;
+      _intervalCount++;
+
+      if (_maxTime < newInterval.endTime) {
+        _maxTime = newInterval.endTime;
+      }
+    }
+  }
+  _stateOffset[ACTION_TABLE_STATE_NUMBER] = _intervalCount;
+}
+
+//*********************************//
+// Function   : getAction
+//
+// Description: Find the output action of an input main state and elapsed time.
+//
+// Arguments :  mode : int : Action column (ACTION_TABLE_MODE_MOUSE, _GAMEPAD, _MENU or _SAFE)
+//              mainState : int : Input main state
+//              elapsedTime : unsigned long : Time the input state lasted (ms)
+//
+// Return     : int : Output action, or ACTION_TABLE_NO_ACTION if no window contains the elapsed time
+//*********************************//
+int LSActionTable::getAction(int mode, int mainState, unsigned long elapsedTime) {
+  if (mode < 0 || mode >= ACTION_TABLE_MODE_NUMBER || mainState < 0 || mainState >= ACTION_TABLE_STATE_NUMBER) {
+    return ACTION_TABLE_NO_ACTION;
+  }
+
+  // Find the last window starting at or before the elapsed time
+  int low = _stateOffset[mainState];
+  int high = _stateOffset[mainState + 1] - 1;
+  int found = -1;
+  while (low <= high) {
+    int middle = (low + high) / 2;
+    if (_interval[middle].startTime <= elapsedTime) {
+      found = middle;
+      low = middle + 1;
+    } else {
+      high = middle - 1;
+    }
+  }
+
+  if (found < 0 || elapsedTime >= _interval[found].endTime) {
+    return ACTION_TABLE_NO_ACTION;
+  }
+  return _interval[found].outputAction[mode];
+}
+
+//*********************************//
+// Function   : getMaxTime
+//
+// Description: Get the maximum end time of all action windows.
+//
+// Arguments :  void
+//
+// Return     : unsigned long : Maximum end time (ms)
+//*********************************//
+unsigned long LSActionTable::getMaxTime() {
+  return _maxTime;
+}
+
+//*********************************//
+// Function   : getLastStartTime
+//
+// Description: Get the start time of the last action window of an input main state.
+//
+// Arguments :  mainState : int : Input main state
+//
+// Return     : unsigned long : Start time (ms) of the last window, or 0 if the state has no window
+//*********************************//
+unsigned long LSActionTable::getLastStartTime(int mainState) {
+  if (getIntervalCount(mainState) == 0) {
+    return 0;
+  }
+  return _interval[_stateOffset[mainState + 1] - 1].startTime;
+}
+
+//*********************************//
+// Function   : getIntervalCount
+//
+// Description: Get the number of action windows of an input main state.
+//
+// Arguments :  mainState : int : Input main state
+//
+// Return     : int : Number of action windows
+//*********************************//
+int LSActionTable::getIntervalCount(int mainState) {
+  if (mainState < 0 || mainState >= ACTION_TABLE_STATE_NUMBER) {
+    return 0;
+  }
+  return _stateOffset[mainState + 1] - _stateOffset[mainState];
+}
+
+#endif
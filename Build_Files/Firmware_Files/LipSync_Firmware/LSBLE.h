@@ -16,14 +16,192 @@
   If not, see <http://www.gnu.org/licenses/>
 */
 #include <bluefruit.h>
+#include "LSReportQueue.h"
 
 #define MOUSE_LEFT 1
 #define MOUSE_RIGHT 2
 #define MOUSE_MIDDLE 4
 #define MOUSE_ALL (MOUSE_LEFT | MOUSE_RIGHT | MOUSE_MIDDLE)
+#define MOUSE_SCROLL_RESOLUTION 120      // Smooth scroll units per wheel detent
+
+// Queued report types
+#define BLE_REPORT_KEYBOARD 1
+#define BLE_REPORT_MOUSE 2
+#define BLE_REPORT_GAMEPAD 1                 // Report id of the gamepad service, the first input report
+
+// Connection parameters in units of 1.25 ms ( interval ), connection events ( latency ) and 10 ms ( timeout )
+#define BLE_CONN_INTERVAL_ACTIVE 6           // 7.5 ms while the user is moving or giving input
+#define BLE_CONN_INTERVAL_IDLE 48            // 60 ms once the user rests
+#define BLE_CONN_INTERVAL_MAX 16             // Longest interval accepted when the connection is made, 20 ms
+#define BLE_CONN_LATENCY_ACTIVE 0
+#define BLE_CONN_LATENCY_IDLE 4              // Connection events the peripheral may skip when idle
+#define BLE_CONN_SUPERVISION_TIMEOUT 400     // 4 s
+#define BLE_CONN_IDLE_TIMEOUT 3000           // Rest time in ms before the idle parameters are requested
+#define BLE_CONN_REQUEST_DELAY 500           // Minimum time in ms between two parameter requests
+
+#define BLE_TX_QUEUE_SIZE 3                  // Notifications the SoftDevice can hold for the next connection events
+
+#define BLE_HOST_SLOTS 3                     // Hosts remembered for switching
+#define BLE_HOST_DIRECTED_TIME 1300          // High duty cycle directed advertising lasts 1.28 s, then the low duty cycle directed advertising starts
+#define BLE_HOST_DIRECTED_INTERVAL 244       // Low duty cycle directed advertising interval, 152.5 ms as the slow undirected advertising
+#define BLE_HOST_REJECT_DELAY 1000           // Wait after a rejected host before advertising to any host again
+#define BLE_HOST_ADV_HANDLE 0                // The advertising set configured by Bluefruit.Advertising
+
+// HID report map of the gamepad service : the 8 buttons and 2 axis joystick of the USB gamepad
+uint8_t const ble_gamepad_desc_hid_report[] =
+{
+    0x05, 0x01,        // Usage Page (Generic Desktop Ctrls)
+    0x09, 0x05,        // Usage (Gamepad)
+    0xA1, 0x01,        // Collection (Application)
+    0x85, BLE_REPORT_GAMEPAD, //   Report ID (1)
+    0x15, 0x00,        //   Logical Minimum (0)
+    0x25, 0x01,        //   Logical Maximum (1)
+    0x35, 0x00,        //   Physical Minimum (0)
+    0x45, 0x01,        //   Physical Maximum (1)
+    0x75, 0x01,        //   Report Size (1)
+    0x95, 0x08,        //   Report Count (8)
+    0x05, 0x09,        //   Usage Page (Button)
+    0x19, 0x01,        //   Usage Minimum (0x01)
+    0x29, 0x08,        //   Usage Maximum (0x08)
+    0x81, 0x02,        //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+    0x05, 0x01,        //   Usage Page (Generic Desktop Ctrls)
+    0x26, 0xFF, 0x00,  //   Logical Maximum (255)
+    0x46, 0xFF, 0x00,  //   Physical Maximum (255)
+    0x09, 0x30,        //   Usage (X)
+    0x09, 0x31,        //   Usage (Y)
+    0x75, 0x08,        //   Report Size (8)
+    0x95, 0x02,        //   Report Count (2)
+    0x81, 0x02,        //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+    0xC0,              // End Collection
+};
+
+// Gamepad report map with the Z axis, used when the pressure output is set to the gamepad axis
+uint8_t const ble_gamepad_z_desc_hid_report[] =
+{
+    0x05, 0x01,        // Usage Page (Generic Desktop Ctrls)
+    0x09, 0x05,        // Usage (Gamepad)
+    0xA1, 0x01,        // Collection (Application)
+    0x85, BLE_REPORT_GAMEPAD, //   Report ID (1)
+    0x15, 0x00,        //   Logical Minimum (0)
+    0x25, 0x01,        //   Logical Maximum (1)
+    0x35, 0x00,        //   Physical Minimum (0)
+    0x45, 0x01,        //   Physical Maximum (1)
+    0x75, 0x01,        //   Report Size (1)
+    0x95, 0x08,        //   Report Count (8)
+    0x05, 0x09,        //   Usage Page (Button)
+    0x19, 0x01,        //   Usage Minimum (0x01)
+    0x29, 0x08,        //   Usage Maximum (0x08)
+    0x81, 0x02,        //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+    0x05, 0x01,        //   Usage Page (Generic Desktop Ctrls)
+    0x26, 0xFF, 0x00,  //   Logical Maximum (255)
+    0x46, 0xFF, 0x00,  //   Physical Maximum (255)
+    0x09, 0x30,        //   Usage (X)
+    0x09, 0x31,        //   Usage (Y)
+    0x09, 0x32,        //   Usage (Z)
+    0x75, 0x08,        //   Report Size (8)
+    0x95, 0x03,        //   Report Count (3)
+    0x81, 0x02,        //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+    0xC0,              // End Collection
+};
+
+bool bleGamepadStarted = false;    // The report map is read by the host, it can't change until the next reset
+bool bleGamepadZAxis = false;      // Gamepad report carries the Z axis of the pressure output
+
+// HID service with the gamepad report map and a single input report
+class LSBLEHidGamepad : public BLEHidGeneric {
+  public:
+    LSBLEHidGamepad(void) : BLEHidGeneric(1, 0, 0) {}
+    err_t begin(void)
+    {
+      if (bleGamepadZAxis)
+        setReportMap(ble_gamepad_z_desc_hid_report, sizeof(ble_gamepad_z_desc_hid_report));
+      else
+        setReportMap(ble_gamepad_desc_hid_report, sizeof(ble_gamepad_desc_hid_report));
+      bleGamepadStarted = true;
+      return BLEHidGeneric::begin();
+    }
+};
+
+// Tracks the notification buffers of the SoftDevice. Reports are only sent while a buffer is free, so sending never blocks.
+// Motion waits until the notifications sent before are transmitted, so one motion report is sent per connection event
+// and the motion of the reports waiting in the queues is combined. Button and key edges may use the other buffers.
+class LSBLETransmit {
+  public:
+    inline LSBLETransmit(void);
+    inline void reset(void);
+    inline bool isAvailable(bool edge);            // Checks if a report can be sent now
+    inline void sent(void);
+    inline void complete(uint8_t count);           // Called from the BLE event callback
+    inline void disconnected(void);                // Called from the BLE event callback
+    inline uint8_t getInFlight(void);
+    inline unsigned long getFullCount(void);       // Reports that waited for a free buffer
+  private:
+    uint32_t _sentCount;                           // Written by the loop only
+    volatile uint32_t _completeCount;              // Written by the BLE event callback only
+    volatile uint32_t _disconnectCount;            // Written by the BLE event callback only
+    uint32_t _resetCount;                          // Disconnections handled by the loop
+    bool _full;
+    unsigned long _fullCount;
+};
+
+typedef struct
+{
+  uint8_t valid;
+  ble_gap_addr_t addr;
+} bleHostStruct;
+
+// Remembers the identity address of a host in each slot. Only the host of the selected slot may connect, or any new host
+// while the slot is empty. While the selected slot has a host the advertising is directed to it, so other hosts are not invited.
+// A private address the SoftDevice didn't resolve to an identity address can't be stored, such a host is only accepted
+// while the selected slot is empty, and is reported as unfilterable.
+class LSBLEHosts {
+  public:
+    inline LSBLEHosts(void);
+    inline void setSlot(int slot);                 // Selects the slot without switching, at start up
+    inline bool select(int slot, unsigned long now);
+    inline bool forget(int slot);
+    inline int getSlot(void);
+    inline bool isValid(int slot);
+    inline void update(unsigned long now);
+    inline bool connected(uint16_t connHandle);    // Called from the connect callback, false if the host was rejected
+    inline void disconnected(void);                // Called from the BLE event callback
+    inline bool isUnfilterable(int slot);          // The host connected in the empty slot can't be stored
+    inline long getReconnectTime(void);            // Time in ms from the last switch to the connection, -1 if not connected yet
+    inline unsigned long getSwitchCount(void);
+    inline unsigned long getRejectCount(void);
+    inline bool isChanged(void);                   // The slots changed since they were saved
+    inline void saved(void);
+    inline int getRecord(uint8_t* buffer, int bufferSize);
+    inline bool setRecord(const uint8_t* buffer, int length);
+  private:
+    bleHostStruct _hosts[BLE_HOST_SLOTS];
+    int _slot;
+    bool _connected;
+    bool _switchPending;                           // Waiting for the disconnection of the last host
+    volatile bool _advertisePending;               // Advertising restarts once the connection is lost
+    bool _directed;
+    bool _directedSlow;
+    bool _measuring;
+    bool _changed;
+    bool _unfilterable;
+    unsigned long _switchTime;
+    unsigned long _directedTime;
+    volatile unsigned long _rejectTime;
+    long _reconnectTime;
+    unsigned long _switchCount;
+    volatile unsigned long _rejectCount;
+    int findHost(const ble_gap_addr_t* addr);
+    bool isIdentity(const ble_gap_addr_t* addr);
+    bool isAllowed(const ble_gap_addr_t* addr);
+    void startAdvertising(unsigned long now);
+    void startDirected(unsigned long now, bool highDuty);
+};
 
 BLEDis bledis;
 BLEHidAdafruit blehid;
+LSBLEHidGamepad blegamepad;
+LSBLETransmit bletx;
+LSBLEHosts blehosts;
 bool needsInitialization = true;
 
 class LSBLEMouse {
@@ -32,20 +210,93 @@ class LSBLEMouse {
     inline LSBLEMouse(void);
     inline void begin(const char* s = "LipSync");
     inline void end(void);
-    inline void move(signed char x, signed char y);
-    inline void moveAll(signed char x, signed char y, signed char wheel = 0, signed char pan = 0);
+    inline void move(int x, int y);
+    inline void moveAll(int x, int y, signed char wheel = 0, signed char pan = 0);
     inline void scroll(signed char wheel = 0);
     inline void pan(signed char pan = 0);
+    inline void smoothScroll(int wheel, int pan = 0);   // Wheel motion in 1/MOUSE_SCROLL_RESOLUTION detents
     inline void click(uint8_t b = MOUSE_LEFT);
     inline void press(uint8_t b = MOUSE_LEFT);   // press LEFT by default
     inline void release(uint8_t b = MOUSE_LEFT); // release LEFT by default
     inline bool isPressed(uint8_t b = MOUSE_LEFT); // check LEFT by default
+    inline bool keyPress(uint8_t m, uint8_t k);    // Keyboard report of the HID service
+    inline bool keyRelease(uint8_t k);
+    inline bool keyReleaseAll(void);
     inline bool isConnected(void);
+    void sendQueuedReport(void);
+    void update(void);
+    unsigned long getDroppedCount(void);
   protected:
+    LSReportQueue _reportQueue;
+    uint8_t _sentButtons = 0;                      // Buttons of the last mouse report sent
+    int _wheelRemainder = 0;                       // Smooth scroll motion below a detent
+    int _panRemainder = 0;
     uint8_t _buttons;
+    uint8_t _keyModifiers;
+    uint8_t _keys[6];
     void buttons(uint8_t b);
+    bool keyboardReport(void);
   private:
-    void mouseReport(signed char b, signed char x, signed char y, signed char wheel = 0, signed char pan = 0);
+    void mouseReport(uint8_t b, long x, long y, long wheel = 0, long pan = 0);
+};
+
+typedef struct
+{
+  uint8_t buttons;
+  uint8_t xAxis;
+  uint8_t yAxis;
+  uint8_t zAxis;
+} btGamepadReport;
+
+class LSBLEGamepad {
+  public:
+    inline LSBLEGamepad(void);
+    inline void begin(const char* s = "LipSync");
+    inline void end(void);
+    inline void send(void);                        // Queues the report if it changed since the last report
+    inline void press(uint8_t b);
+    inline void release(uint8_t b);
+    inline void releaseAll(void);
+    inline void buttons(uint8_t b);
+    inline void xAxis(uint8_t a);
+    inline void yAxis(uint8_t a);
+    inline void zAxis(uint8_t a);
+    inline void move(uint8_t x, uint8_t y);
+    inline void setZAxis(bool zAxis);             // Set before begin, the host reads the report map when it connects
+    inline bool hasZAxis(void);
+    inline bool isReady(void);
+    inline bool isConnected(void);
+    void sendQueuedReport(void);
+    void update(void);
+    unsigned long getDroppedCount(void);
+  protected:
+    inline size_t reportLength(void);             // Report without the Z axis byte unless the report map has it
+    btGamepadReport _report;
+    btGamepadReport _lastReport;                   // Last report queued
+    bool _lastReportValid = false;
+    LSReportQueue _reportQueue;
+    uint8_t _sentButtons = 0;                      // Buttons of the last report sent
+};
+
+// Requests the shortest connection interval while the user is active and a long interval with slave latency at rest
+class LSBLEConnection {
+  public:
+    inline LSBLEConnection(void);
+    inline void setActive(unsigned long now);      // Marks user activity
+    inline void update(unsigned long now);
+    inline void parametersUpdated(void);           // Called from the BLE event callback
+    inline bool isActive(void);                    // The connection uses the active interval
+    inline unsigned long getUpdateCount(void);     // Parameter updates that took effect
+    inline uint16_t getInterval(void);             // Current parameters of the connection, 0 when not connected
+    inline uint16_t getSlaveLatency(void);
+    inline uint16_t getSupervisionTimeout(void);
+  private:
+    uint16_t _connHandle;
+    bool _active;                                  // Parameters requested last
+    unsigned long _activeTime;                     // Time of the last user activity
+    unsigned long _requestTime;
+    volatile unsigned long _updateCount;
+    BLEConnection* connection(void);
 };
 
 typedef struct
@@ -60,7 +311,9 @@ class LSBLEKeyboard : public Print
 {
   private:
     btKeyReport _keyReport;
+    LSReportQueue _reportQueue;                    // Key edges waiting for a free notification buffer
     void keyboardReport(btKeyReport* keys);
+    void sendQueuedReport(void);
     uint8_t const _ascii2keycode[128][2] = {HID_ASCII_TO_KEYCODE};
   public:
     inline LSBLEKeyboard(void);
@@ -72,25 +325,55 @@ class LSBLEKeyboard : public Print
     inline size_t release(uint8_t m, uint8_t k);
     inline void releaseAll(void);
     inline bool isConnected(void);
+    inline void update(void);
 };
 
 
-void initializeBluefruit(const char* s) {
+extern LSBLEConnection btconnection;
+
+// Frees the notification buffers once the notifications were transmitted
+void bleEventCallback(ble_evt_t* evt) {
+  if (evt->header.evt_id == BLE_GATTS_EVT_HVN_TX_COMPLETE) {
+    bletx.complete(evt->evt.gatts_evt.params.hvn_tx_complete.count);
+  } else if (evt->header.evt_id == BLE_GAP_EVT_CONN_PARAM_UPDATE) {
+    btconnection.parametersUpdated();  // A request the central rejects never gets here
+  } else if (evt->header.evt_id == BLE_GAP_EVT_DISCONNECTED) {
+    bletx.disconnected();
+    blehosts.disconnected();
+  }
+}
+
+// Disconnects the hosts of the other slots
+void bleConnectCallback(uint16_t connHandle) {
+  blehosts.connected(connHandle);
+}
+
+// Only one HID service is started : the mouse and keyboard service or the gamepad service
+void initializeBluefruit(const char* s, bool gamepad = false) {
+  Bluefruit.configPrphConn(BLE_GATT_ATT_MTU_DEFAULT, BLE_GAP_EVENT_LENGTH_DEFAULT, BLE_TX_QUEUE_SIZE, BLE_GATTC_WRITE_CMD_TX_QUEUE_SIZE_DEFAULT);
   Bluefruit.begin();
-  Bluefruit.Periph.setConnInterval(9, 16);  // min = 9*1.25=11.25 ms, max = 16*1.25=20ms
+  Bluefruit.setEventCallback(bleEventCallback);
+  Bluefruit.Periph.setConnectCallback(bleConnectCallback);
+  Bluefruit.Periph.setConnInterval(BLE_CONN_INTERVAL_ACTIVE, BLE_CONN_INTERVAL_MAX);  // min = 6*1.25=7.5 ms, max = 16*1.25=20ms
   Bluefruit.setTxPower(4);                  // Check bluefruit.h for supported values
   Bluefruit.setName(s);
   bledis.setManufacturer("MakersMakingChange");
-  bledis.setModel("LipSync Mouse");
+  bledis.setModel(gamepad ? "LipSync Gamepad" : "LipSync Mouse");
   bledis.begin();
-  blehid.begin();
   Bluefruit.Advertising.addFlags(BLE_GAP_ADV_FLAGS_LE_ONLY_GENERAL_DISC_MODE);
   Bluefruit.Advertising.addTxPower();
-  Bluefruit.Advertising.addAppearance(BLE_APPEARANCE_HID_KEYBOARD);
-  Bluefruit.Advertising.addAppearance(BLE_APPEARANCE_HID_MOUSE);
-  Bluefruit.Advertising.addService(blehid);
+  if (gamepad) {
+    blegamepad.begin();
+    Bluefruit.Advertising.addAppearance(BLE_APPEARANCE_HID_GAMEPAD);
+    Bluefruit.Advertising.addService(blegamepad);
+  } else {
+    blehid.begin();
+    Bluefruit.Advertising.addAppearance(BLE_APPEARANCE_HID_KEYBOARD);
+    Bluefruit.Advertising.addAppearance(BLE_APPEARANCE_HID_MOUSE);
+    Bluefruit.Advertising.addService(blehid);
+  }
   Bluefruit.Advertising.addName();
-  Bluefruit.Advertising.restartOnDisconnect(true);
+  Bluefruit.Advertising.restartOnDisconnect(false);   // LSBLEHosts restarts the advertising for the selected slot
   Bluefruit.Advertising.setInterval(32, 244);    // 20 ms - in unit of 0.625 ms (Interval:  fast mode = 20 ms, slow mode = 152.5 ms)
   Bluefruit.Advertising.setFastTimeout(30);      // number of seconds in fast mode
   Bluefruit.Advertising.start(0);                // 0 = Don't stop advertising after n seconds
@@ -100,6 +383,449 @@ void initializeBluefruit(const char* s) {
 }
 
 
+/*****************************
+     TRANSMIT SECTION
+ *****************************/
+
+LSBLETransmit::LSBLETransmit(void)
+{
+  _sentCount = 0;
+  _completeCount = 0;
+  _disconnectCount = 0;
+  _resetCount = 0;
+  _full = false;
+  _fullCount = 0;
+}
+
+// The buffers are free again once the connection is lost, the notifications left are never completed
+void LSBLETransmit::reset(void)
+{
+  _resetCount = _disconnectCount;
+  _sentCount = _completeCount;
+  _full = false;
+}
+
+bool LSBLETransmit::isAvailable(bool edge)
+{
+  if (_resetCount != _disconnectCount || (_sentCount - _completeCount) > BLE_TX_QUEUE_SIZE) {
+    reset();
+  }
+  if (!Bluefruit.connected())
+    return false;
+  uint8_t inFlight = getInFlight();
+  if (inFlight >= BLE_TX_QUEUE_SIZE) {
+    if (!_full) {
+      _full = true;  // Count each report that finds the buffers full once
+      _fullCount++;
+      if (USB_DEBUG) {
+        Serial.print("BLE TX queue full: ");
+        Serial.println(_fullCount);
+      }
+    }
+    return false;
+  }
+  return edge || inFlight == 0;
+}
+
+void LSBLETransmit::sent(void)
+{
+  _sentCount++;
+  _full = false;
+}
+
+void LSBLETransmit::complete(uint8_t count)
+{
+  _completeCount += count;
+}
+
+void LSBLETransmit::disconnected(void)
+{
+  _disconnectCount++;
+}
+
+uint8_t LSBLETransmit::getInFlight(void)
+{
+  uint32_t inFlight = _sentCount - _completeCount;
+  return (inFlight > BLE_TX_QUEUE_SIZE) ? 0 : inFlight;
+}
+
+unsigned long LSBLETransmit::getFullCount(void)
+{
+  return _fullCount;
+}
+
+
+/*****************************
+     HOST SECTION
+ *****************************/
+
+LSBLEHosts::LSBLEHosts(void)
+{
+  memset(_hosts, 0, sizeof(_hosts));
+  _slot = 0;
+  _connected = false;
+  _switchPending = false;
+  _advertisePending = true;  // Advertise to the host of the slot loaded at start up
+  _directed = false;
+  _directedSlow = false;
+  _measuring = false;
+  _changed = false;
+  _unfilterable = false;
+  _switchTime = 0;
+  _directedTime = 0;
+  _rejectTime = 0;
+  _reconnectTime = -1;
+  _switchCount = 0;
+  _rejectCount = 0;
+}
+
+void LSBLEHosts::setSlot(int slot)
+{
+  if (slot >= 0 && slot < BLE_HOST_SLOTS)
+    _slot = slot;
+}
+
+bool LSBLEHosts::select(int slot, unsigned long now)
+{
+  if (slot < 0 || slot >= BLE_HOST_SLOTS)
+    return false;
+  _slot = slot;
+  _switchTime = now;
+  _reconnectTime = -1;
+  _measuring = true;
+  _unfilterable = false;
+  _switchCount++;
+
+  if (Bluefruit.connected()) {
+    BLEConnection* conn = Bluefruit.Connection(Bluefruit.connHandle());
+    if (conn != NULL) {
+      ble_gap_addr_t addr = conn->getPeerAddr();
+      if (_hosts[_slot].valid && findHost(&addr) == _slot) {
+        _reconnectTime = 0;  // Already connected to the selected host
+        _measuring = false;
+        return true;
+      }
+    }
+    Bluefruit.disconnect(Bluefruit.connHandle());
+  }
+  _switchPending = true;
+  return true;
+}
+
+// The bond stays in the bond storage of Bluefruit, the host pairs again in the free slot
+bool LSBLEHosts::forget(int slot)
+{
+  if (slot < 0 || slot >= BLE_HOST_SLOTS)
+    return false;
+  if (_hosts[slot].valid) {
+    _hosts[slot].valid = 0;
+    _changed = true;
+    if (slot == _slot)
+      _advertisePending = true;  // Advertise to any host, so a new host can pair in the slot
+  }
+  return true;
+}
+
+int LSBLEHosts::getSlot(void)
+{
+  return _slot;
+}
+
+bool LSBLEHosts::isValid(int slot)
+{
+  return (slot >= 0 && slot < BLE_HOST_SLOTS) && _hosts[slot].valid;
+}
+
+void LSBLEHosts::update(unsigned long now)
+{
+  bool connected = Bluefruit.connected();
+
+  if (_switchPending && !connected) {
+    _switchPending = false;
+    _advertisePending = true;
+  }
+
+  // A rejected host would connect again at once to undirected advertising
+  if (_advertisePending && !connected && (_rejectCount == 0 || (now - _rejectTime) >= BLE_HOST_REJECT_DELAY)) {
+    _advertisePending = false;
+    startAdvertising(now);
+  }
+
+  if (_directed && !_directedSlow && !connected && (now - _directedTime) >= BLE_HOST_DIRECTED_TIME) {
+    startDirected(now, false);  // The host didn't answer, keep inviting only this host
+  }
+
+  BLEConnection* conn = connected ? Bluefruit.Connection(Bluefruit.connHandle()) : NULL;
+  if (conn != NULL && !_connected) {
+    _directed = false;
+    ble_gap_addr_t addr = conn->getPeerAddr();
+    if (!isAllowed(&addr)) {
+      return;  // Rejected by the connect callback, wait for the disconnection
+    }
+    if (!_hosts[_slot].valid) {
+      _unfilterable = !isIdentity(&addr);
+      if (!_unfilterable) {
+        _hosts[_slot].valid = 1;  // A new host paired in the empty slot
+        _hosts[_slot].addr = addr;
+        _changed = true;
+      }
+    }
+    if (_measuring) {
+      _measuring = false;
+      _reconnectTime = now - _switchTime;
+      if (USB_DEBUG) {
+        Serial.print("BLE host reconnect time: ");
+        Serial.println(_reconnectTime);
+      }
+    }
+  }
+  _connected = connected;
+}
+
+bool LSBLEHosts::connected(uint16_t connHandle)
+{
+  BLEConnection* conn = Bluefruit.Connection(connHandle);
+  if (conn == NULL)
+    return true;
+  ble_gap_addr_t addr = conn->getPeerAddr();
+  if (isAllowed(&addr))
+    return true;
+  _rejectTime = millis();
+  _rejectCount++;
+  conn->disconnect();
+  return false;
+}
+
+void LSBLEHosts::disconnected(void)
+{
+  _advertisePending = true;
+}
+
+bool LSBLEHosts::isUnfilterable(int slot)
+{
+  return slot == _slot && _unfilterable;
+}
+
+long LSBLEHosts::getReconnectTime(void)
+{
+  return _reconnectTime;
+}
+
+unsigned long LSBLEHosts::getSwitchCount(void)
+{
+  return _switchCount;
+}
+
+unsigned long LSBLEHosts::getRejectCount(void)
+{
+  return _rejectCount;
+}
+
+bool LSBLEHosts::isChanged(void)
+{
+  return _changed;
+}
+
+void LSBLEHosts::saved(void)
+{
+  _changed = false;
+}
+
+int LSBLEHosts::getRecord(uint8_t* buffer, int bufferSize)
+{
+  if (bufferSize < (int)sizeof(_hosts))
+    return 0;
+  memcpy(buffer, _hosts, sizeof(_hosts));
+  return sizeof(_hosts);
+}
+
+bool LSBLEHosts::setRecord(const uint8_t* buffer, int length)
+{
+  if (length != (int)sizeof(_hosts))
+    return false;
+  memcpy(_hosts, buffer, sizeof(_hosts));
+  return true;
+}
+
+int LSBLEHosts::findHost(const ble_gap_addr_t* addr)
+{
+  for (int slot = 0; slot < BLE_HOST_SLOTS; slot++) {
+    if (_hosts[slot].valid && _hosts[slot].addr.addr_type == addr->addr_type
+        && memcmp(_hosts[slot].addr.addr, addr->addr, BLE_GAP_ADDR_LEN) == 0) {
+      return slot;
+    }
+  }
+  return -1;
+}
+
+// Public and static addresses, or a private address the SoftDevice resolved to the identity address of a bond
+bool LSBLEHosts::isIdentity(const ble_gap_addr_t* addr)
+{
+  return addr->addr_id_peer || addr->addr_type == BLE_GAP_ADDR_TYPE_PUBLIC
+         || addr->addr_type == BLE_GAP_ADDR_TYPE_RANDOM_STATIC;
+}
+
+// The host of the selected slot, or a host of no slot while the selected slot is empty
+bool LSBLEHosts::isAllowed(const ble_gap_addr_t* addr)
+{
+  if (!isIdentity(addr))
+    return !_hosts[_slot].valid;
+  int slot = findHost(addr);
+  return _hosts[_slot].valid ? (slot == _slot) : (slot < 0);
+}
+
+// Directed advertising to the host of the selected slot, undirected advertising while the slot is empty
+void LSBLEHosts::startAdvertising(unsigned long now)
+{
+  if (_hosts[_slot].valid) {
+    startDirected(now, true);
+    return;
+  }
+  if (_directed) {
+    sd_ble_gap_adv_stop(BLE_HOST_ADV_HANDLE);
+    _directed = false;
+  }
+  if (!Bluefruit.Advertising.isRunning()) {
+    Bluefruit.Advertising.start(0);  // Pair a new host in the empty slot
+  }
+}
+
+// High duty directed advertising reaches the host in a few ms, without the scan of undirected advertising.
+// The low duty cycle advertising that follows has no timeout.
+void LSBLEHosts::startDirected(unsigned long now, bool highDuty)
+{
+  Bluefruit.Advertising.stop();
+  if (_directed) {
+    sd_ble_gap_adv_stop(BLE_HOST_ADV_HANDLE);
+  }
+
+  ble_gap_adv_params_t advParams;
+  memset(&advParams, 0, sizeof(advParams));
+  if (highDuty) {
+    advParams.properties.type = BLE_GAP_ADV_TYPE_CONNECTABLE_NONSCANNABLE_DIRECTED_HIGH_DUTY_CYCLE;
+  } else {
+    advParams.properties.type = BLE_GAP_ADV_TYPE_CONNECTABLE_NONSCANNABLE_DIRECTED;
+    advParams.interval = BLE_HOST_DIRECTED_INTERVAL;
+  }
+  advParams.p_peer_addr = &_hosts[_slot].addr;
+  advParams.filter_policy = BLE_GAP_ADV_FP_ANY;
+  advParams.primary_phy = BLE_GAP_PHY_1MBPS;
+
+  ble_gap_adv_data_t advData;
+  memset(&advData, 0, sizeof(advData));  // Directed advertising has no data
+
+  uint8_t advHandle = BLE_HOST_ADV_HANDLE;
+  if (sd_ble_gap_adv_set_configure(&advHandle, &advData, &advParams) == NRF_SUCCESS
+      && sd_ble_gap_adv_start(advHandle, CONN_CFG_PERIPHERAL) == NRF_SUCCESS) {
+    _directed = true;
+    _directedSlow = !highDuty;
+    _directedTime = now;
+  } else {
+    _directed = false;
+    Bluefruit.Advertising.start(0);
+  }
+}
+
+
+/*****************************
+     CONNECTION SECTION
+ *****************************/
+
+LSBLEConnection::LSBLEConnection(void)
+{
+  _connHandle = BLE_CONN_HANDLE_INVALID;
+  _active = true;
+  _activeTime = 0;
+  _requestTime = 0;
+  _updateCount = 0;
+}
+
+void LSBLEConnection::setActive(unsigned long now)
+{
+  _activeTime = now;
+  if (!_active) {
+    update(now);  // Renegotiate the short interval without waiting for the next loop
+  }
+}
+
+void LSBLEConnection::update(unsigned long now)
+{
+  if (!Bluefruit.connected()) {
+    _connHandle = BLE_CONN_HANDLE_INVALID;
+    return;
+  }
+
+  // A new connection starts with the preferred parameters of initializeBluefruit
+  if (Bluefruit.connHandle() != _connHandle) {
+    _connHandle = Bluefruit.connHandle();
+    _active = true;
+    _activeTime = now;
+    _requestTime = now;
+    return;
+  }
+
+  bool active = (now - _activeTime) < BLE_CONN_IDLE_TIMEOUT;
+  if (active == _active || (now - _requestTime) < BLE_CONN_REQUEST_DELAY)
+    return;
+
+  BLEConnection* conn = connection();
+  if (conn == NULL)
+    return;
+  _requestTime = now;
+  if (active) {
+    conn->requestConnectionParameter(BLE_CONN_INTERVAL_ACTIVE, BLE_CONN_LATENCY_ACTIVE, BLE_CONN_SUPERVISION_TIMEOUT);
+  } else {
+    conn->requestConnectionParameter(BLE_CONN_INTERVAL_IDLE, BLE_CONN_LATENCY_IDLE, BLE_CONN_SUPERVISION_TIMEOUT);
+  }
+  _active = active;
+  if (USB_DEBUG) {
+    Serial.print("BLE connection parameters requested: ");
+    Serial.println(active ? "active" : "idle");
+  }
+}
+
+void LSBLEConnection::parametersUpdated(void)
+{
+  _updateCount++;
+}
+
+bool LSBLEConnection::isActive(void)
+{
+  uint16_t interval = getInterval();
+  return interval != 0 && interval < BLE_CONN_INTERVAL_IDLE;
+}
+
+unsigned long LSBLEConnection::getUpdateCount(void)
+{
+  return _updateCount;
+}
+
+uint16_t LSBLEConnection::getInterval(void)
+{
+  BLEConnection* conn = connection();
+  return (conn != NULL) ? conn->getConnectionInterval() : 0;
+}
+
+uint16_t LSBLEConnection::getSlaveLatency(void)
+{
+  BLEConnection* conn = connection();
+  return (conn != NULL) ? conn->getSlaveLatency() : 0;
+}
+
+uint16_t LSBLEConnection::getSupervisionTimeout(void)
+{
+  BLEConnection* conn = connection();
+  return (conn != NULL) ? conn->getSupervisionTimeout() : 0;
+}
+
+BLEConnection* LSBLEConnection::connection(void)
+{
+  if (!Bluefruit.connected())
+    return NULL;
+  return Bluefruit.Connection(Bluefruit.connHandle());
+}
+
+
 /*****************************
      MOUSE SECTION
  *****************************/
@@ -112,6 +838,8 @@ LSBLEMouse::LSBLEMouse(void)
 void LSBLEMouse::begin(const char* s)
 {
   _buttons = 0;
+  _keyModifiers = 0;
+  memset(_keys, 0, sizeof(_keys));
   if (needsInitialization) {
     initializeBluefruit(s);
     needsInitialization = false;
@@ -121,18 +849,64 @@ void LSBLEMouse::begin(const char* s)
 
 void LSBLEMouse::end(void)
 {
+  _reportQueue.clear();
+}
+
+// Mouse reports are queued and sent once a notification buffer is free.
+// The motion of the reports waiting in the queue is combined into the last report.
+void LSBLEMouse::mouseReport(uint8_t b, long x, long y, long wheel, long pan)
+{
+  if (!isConnected())
+    return;
+  if (!_reportQueue.pushMouse(BLE_REPORT_MOUSE, false, b, x, y, wheel, pan, true) && USB_DEBUG) {
+    Serial.print("BLE mouse report dropped: ");
+    Serial.println(_reportQueue.getDroppedCount());
+  }
+  sendQueuedReport();
+}
+
+void LSBLEMouse::sendQueuedReport(void)
+{
+  hidReportStruct* report = _reportQueue.peek();
+  if (report == NULL)
+    return;
+  if (!isConnected()) {
+    _reportQueue.clear();
+    return;
+  }
+
+  bool mouse = (report->reportId == BLE_REPORT_MOUSE);
+  if (!bletx.isAvailable(!mouse || report->data[0] != _sentButtons))
+    return;
+
+  if (mouse) {
+    blehid.mouseReport((hid_mouse_report_t*)report->data);
+    _sentButtons = report->data[0];
+  } else {
+    blehid.keyboardReport((hid_keyboard_report_t*)report->data);
+  }
+  bletx.sent();
+  _reportQueue.pop();
+}
+
+// Send the reports waiting for a free notification buffer
+void LSBLEMouse::update(void)
+{
+  if (isConnected())
+    _reportQueue.flushMouse(true);   // Motion left over while the queue was full
+  sendQueuedReport();
 }
 
-void LSBLEMouse::mouseReport(int8_t b, int8_t x, int8_t y, int8_t wheel, int8_t pan)
+unsigned long LSBLEMouse::getDroppedCount(void)
 {
-  blehid.mouseReport(b, x, y, wheel, pan);
+  return _reportQueue.getDroppedCount();
 }
 
-void LSBLEMouse::move(int8_t x, int8_t y)
+void LSBLEMouse::move(int x, int y)
 {
   mouseReport(_buttons, x, y, 0, 0);
 }
-void LSBLEMouse::moveAll(int8_t x, int8_t y, int8_t wheel, int8_t pan)
+void LSBLEMouse::moveAll(int x, int y, int8_t wheel, int8_t pan)
 {
   mouseReport(_buttons, x, y, wheel, pan);
 }
@@ -147,6 +921,19 @@ void LSBLEMouse::pan(int8_t pan)
   mouseReport(_buttons, 0, 0, 0, pan);
 }
 
+// The report map of the HID service has no Resolution Multiplier, so whole detents are sent
+void LSBLEMouse::smoothScroll(int wheel, int pan)
+{
+  _wheelRemainder += wheel;
+  _panRemainder += pan;
+  int wheelOutput = _wheelRemainder / MOUSE_SCROLL_RESOLUTION;
+  int panOutput = _panRemainder / MOUSE_SCROLL_RESOLUTION;
+  _wheelRemainder -= wheelOutput * MOUSE_SCROLL_RESOLUTION;
+  _panRemainder -= panOutput * MOUSE_SCROLL_RESOLUTION;
+  if (wheelOutput != 0 || panOutput != 0)
+    mouseReport(_buttons, 0, 0, wheelOutput, panOutput);
+}
+
 void LSBLEMouse::click(uint8_t b)
 {
   _buttons = b;
@@ -181,12 +968,204 @@ bool LSBLEMouse::isPressed(uint8_t b)
   return false;
 }
 
+// Keyboard reports share the queue of the mouse reports, so key and button reports are sent in order
+bool LSBLEMouse::keyboardReport(void)
+{
+  if (!isConnected())
+    return false;
+  hid_keyboard_report_t report;
+  report.modifier = _keyModifiers;
+  report.reserved = 0;
+  memcpy(report.keycode, _keys, sizeof(report.keycode));
+  bool queued = _reportQueue.push(BLE_REPORT_KEYBOARD, &report, sizeof(report));
+  sendQueuedReport();
+  return queued;
+}
+
+bool LSBLEMouse::keyPress(uint8_t m, uint8_t k)
+{
+  _keyModifiers |= m;
+  if (k != 0 && memchr(_keys, k, sizeof(_keys)) == NULL) {
+    uint8_t* freeKey = (uint8_t*)memchr(_keys, 0, sizeof(_keys));
+    if (freeKey == NULL)
+      return false;
+    *freeKey = k;
+  }
+  return keyboardReport();
+}
+
+bool LSBLEMouse::keyRelease(uint8_t k)
+{
+  _keyModifiers = 0;
+  for (uint8_t i = 0; i < sizeof(_keys); i++) {
+    if (k != 0 && _keys[i] == k)
+      _keys[i] = 0;
+  }
+  return keyboardReport();
+}
+
+bool LSBLEMouse::keyReleaseAll(void)
+{
+  _keyModifiers = 0;
+  memset(_keys, 0, sizeof(_keys));
+  return keyboardReport();
+}
+
 bool LSBLEMouse::isConnected(void) {
   return Bluefruit.connected();
 }
 
 
 
+/*****************************
+     GAMEPAD SECTION
+ *****************************/
+
+LSBLEGamepad::LSBLEGamepad(void)
+{
+
+}
+
+void LSBLEGamepad::begin(const char* s)
+{
+  if (needsInitialization) {
+    initializeBluefruit(s, true);
+    needsInitialization = false;
+  }
+  // Release all the buttons and center joystick
+  end();
+}
+
+void LSBLEGamepad::end(void)
+{
+  _reportQueue.clear();
+  _report.buttons = 0;
+  _report.xAxis = 128;
+  _report.yAxis = 128;
+  _report.zAxis = 128;
+  send();
+}
+
+// Reports are only queued when the state changed, and sent once a notification buffer is free.
+// Axis changes replace the axes of the last report waiting in the queue.
+void LSBLEGamepad::send(void)
+{
+  if (!isConnected()) {
+    _lastReportValid = false;   // The host gets the whole state once it connects
+    return;
+  }
+  if (_lastReportValid && memcmp(&_report, &_lastReport, reportLength()) == 0)
+    return;
+  if (!_reportQueue.pushState(BLE_REPORT_GAMEPAD, &_report, reportLength(), true) && USB_DEBUG) {
+    Serial.print("BLE gamepad report dropped: ");
+    Serial.println(_reportQueue.getDroppedCount());
+  }
+  memcpy(&_lastReport, &_report, sizeof(_report));
+  _lastReportValid = true;
+  sendQueuedReport();
+}
+
+void LSBLEGamepad::sendQueuedReport(void)
+{
+  hidReportStruct* report = _reportQueue.peek();
+  if (report == NULL)
+    return;
+  if (!isConnected()) {
+    _reportQueue.clear();
+    return;
+  }
+
+  if (!bletx.isAvailable(report->data[0] != _sentButtons))
+    return;
+
+  blegamepad.inputReport(report->reportId, report->data, report->length);
+  _sentButtons = report->data[0];
+  bletx.sent();
+  _reportQueue.pop();
+}
+
+// Send the reports waiting for a free notification buffer
+void LSBLEGamepad::update(void)
+{
+  sendQueuedReport();
+}
+
+unsigned long LSBLEGamepad::getDroppedCount(void)
+{
+  return _reportQueue.getDroppedCount();
+}
+
+void LSBLEGamepad::press(uint8_t b)
+{
+  b &= 0x7; // Limit value between 0..7
+  _report.buttons |= (uint8_t)1 << b;
+}
+
+void LSBLEGamepad::release(uint8_t b)
+{
+  b &= 0x7; // Limit value between 0..7
+  _report.buttons &= ~((uint8_t)1 << b);
+}
+
+void LSBLEGamepad::releaseAll(void)
+{
+  _report.buttons = 0;
+}
+
+void LSBLEGamepad::buttons(uint8_t b)
+{
+  _report.buttons = b;
+}
+
+void LSBLEGamepad::xAxis(uint8_t a)
+{
+  _report.xAxis = 128 + a;
+}
+
+void LSBLEGamepad::yAxis(uint8_t a)
+{
+  _report.yAxis = 128 + a;
+}
+
+void LSBLEGamepad::zAxis(uint8_t a)
+{
+  _report.zAxis = 128 + a;
+}
+
+void LSBLEGamepad::move(uint8_t x, uint8_t y)
+{
+  _report.xAxis = 128 + x;
+  _report.yAxis = 128 + y;
+}
+
+void LSBLEGamepad::setZAxis(bool zAxis)
+{
+  if (!bleGamepadStarted)
+    bleGamepadZAxis = zAxis;
+}
+
+bool LSBLEGamepad::hasZAxis(void)
+{
+  return bleGamepadZAxis;
+}
+
+size_t LSBLEGamepad::reportLength(void)
+{
+  return bleGamepadZAxis ? sizeof(_report) : sizeof(_report) - sizeof(_report.zAxis);
+}
+
+// Reports are queued, the gamepad is ready while the queue has room
+bool LSBLEGamepad::isReady(void)
+{
+  return isConnected() && _reportQueue.getCount() < REPORT_QUEUE_SIZE;
+}
+
+bool LSBLEGamepad::isConnected(void) {
+  return Bluefruit.connected();
+}
+
+
+
 /*****************************
      KEYBOARD SECTION
  *****************************/
@@ -209,8 +1188,33 @@ void LSBLEKeyboard::end(void)
 
 void LSBLEKeyboard::keyboardReport(btKeyReport* keys)
 {
-  blehid.keyboardReport(keys->modifiers, keys->keys);
-  delay(2);
+  if (!_reportQueue.push(BLE_REPORT_KEYBOARD, keys, sizeof(btKeyReport)) && USB_DEBUG) {
+    Serial.print("BLE keyboard report dropped: ");
+    Serial.println(_reportQueue.getDroppedCount());
+  }
+  sendQueuedReport();
+}
+
+void LSBLEKeyboard::sendQueuedReport(void)
+{
+  hidReportStruct* report = _reportQueue.peek();
+  if (report == NULL)
+    return;
+  if (!isConnected()) {
+    _reportQueue.clear();
+    return;
+  }
+  if (!bletx.isAvailable(true))
+    return;
+  blehid.keyboardReport((hid_keyboard_report_t*)report->data);
+  bletx.sent();
+  _reportQueue.pop();
+}
+
+// Send the key edges waiting for a free notification buffer
+void LSBLEKeyboard::update(void)
+{
+  sendQueuedReport();
 }
 
 
@@ -0,0 +1,216 @@
+/*
+* File: LSChord.h
+* Firmware: LipSync
+* Developed by: MakersMakingChange
+* Version: v4.1 (28 March 2025)
+  License: GPL v3.0 or later
+
+  Copyright (C) 2024 - 2025 Neil Squire Society
+  This program is free software: you can redistribute it and/or modify it under the terms of
+  the GNU General Public License as published by the Free Software Foundation,
+  either version 3 of the License, or (at your option) any later version.
+  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License along with this program.
+  If not, see <http://www.gnu.org/licenses/>
+*/
+
+//Header definition
+#ifndef _LSCHORD_H
+#define _LSCHORD_H
+
+#define CHORD_SOURCE_NUMBER 3                   // Sip and puff, buttons and switches
+
+// Input sources of the chord state bits
+#define CHORD_SAP_MASK (CONF_CHORD_SIP | CONF_CHORD_PUFF)
+#define CHORD_BUTTON_MASK (0x03 << CONF_CHORD_BUTTON_SHIFT)
+#define CHORD_SWITCH_MASK (0x07 << CONF_CHORD_SWITCH_SHIFT)
+
+class LSChord {
+  private:
+    InputStateMachine <LSInputPolicy> _chordStateMachine;  // Same debounce and merge time as buttons and switches
+    LSActionTable* _actionTable;
+    int _sourceState[CHORD_SOURCE_NUMBER];                 // Chord state bits held by each source
+    uint8_t _claimedSource;                                // Sources whose own actions are replaced by a chord
+    bool isMapped(int chordState);
+  public:
+    LSChord();
+    void begin(LSActionTable* actionTable);
+    void clear(unsigned long currentTime);
+    bool update(int source, inputStateStruct sourceState, unsigned long currentTime);
+    inputStateStruct getState();
+    bool isActive();
+    bool isClaimed(int source);
+    static int getSourceChordState(int source, int mainState);
+};
+
+//*********************************//
+// Function   : LSChord
+//
+// Description: Construct LSChord
+//
+// Arguments :  void
+//
+// Return     : void
+//*********************************//
+LSChord::LSChord() {
+  _actionTable = NULL;
+  clear(0);
+}
+
+//*********************************//
+// Function   : begin
+//
+// Description: Start chord recognition with the compiled chord action table.
+//
+// Arguments :  actionTable : LSActionTable* : Compiled chord action mapping
+//
+// Return     : void
+//*********************************//
+void LSChord::begin(LSActionTable* actionTable) {
+  _actionTable = actionTable;
+  clear(millis());
+}
+
+//*********************************//
+// Function   : clear
+//
+// Description: Forget the held inputs and claimed sources.
+//
+// Arguments :  currentTime : unsigned long : Current time in ms
+//
+// Return     : void
+//*********************************//
+void LSChord::clear(unsigned long currentTime) {
+  _chordStateMachine.clear(currentTime);
+  for (int sourceIndex = 0; sourceIndex < CHORD_SOURCE_NUMBER; sourceIndex++) {
+    _sourceState[sourceIndex] = 0;
+  }
+  _claimedSource = 0;
+}
+
+//*********************************//
+// Function   : update
+//
+// Description: Combine the latest input state of a source with the inputs held on the other sources.
+//              Once the combined state is a mapped chord of two or more sources, these sources are claimed
+//              until each of them is released, so their own actions are not performed.
+//
+// Arguments :  source : int : Input source (sip and puff, buttons or switches)
+//              sourceState : inputStateStruct : Latest input state of the source
+//              currentTime : unsigned long : Current time in ms
+//
+// Return     : bool : true if a new chord state was entered
+//*********************************//
+bool LSChord::update(int source, inputStateStruct sourceState, unsigned long currentTime) {
+  if (source < 0 || source >= CHORD_SOURCE_NUMBER) {
+    return false;
+  }
+
+  if (sourceState.secondaryState == INPUT_SEC_STATE_STARTED) {
+    _sourceState[source] = getSourceChordState(source, sourceState.mainState);
+  } else {
+    _sourceState[source] = 0;
+    _claimedSource &= ~(1 << source);  // A released source is free for its own actions again
+  }
+
+  int chordState = _sourceState[CONF_GESTURE_SOURCE_SAP] | _sourceState[CONF_GESTURE_SOURCE_BUTTON] | _sourceState[CONF_GESTURE_SOURCE_SWITCH];
+  bool newState = _chordStateMachine.update(chordState, currentTime);
+
+  if (isActive() && _chordStateMachine.getState().secondaryState == INPUT_SEC_STATE_STARTED) {
+    for (int sourceIndex = 0; sourceIndex < CHORD_SOURCE_NUMBER; sourceIndex++) {
+      if (_sourceState[sourceIndex] != 0) {
+        _claimedSource |= (1 << sourceIndex);
+      }
+    }
+  }
+  return newState;
+}
+
+//*********************************//
+// Function   : getState
+//
+// Description: Get the chord state.
+//
+// Arguments :  void
+//
+// Return     : inputStateStruct : Chord state bits, secondary state and elapsed time
+//*********************************//
+inputStateStruct LSChord::getState() {
+  return _chordStateMachine.getState();
+}
+
+//*********************************//
+// Function   : isActive
+//
+// Description: Check if the chord state is a mapped chord that is started or was just released.
+//
+// Arguments :  void
+//
+// Return     : bool : true if the chord state should be evaluated with the chord action table
+//*********************************//
+bool LSChord::isActive() {
+  inputStateStruct chordState = _chordStateMachine.getState();
+  return (chordState.secondaryState != INPUT_SEC_STATE_WAITING && isMapped(chordState.mainState));
+}
+
+//*********************************//
+// Function   : isClaimed
+//
+// Description: Check if a source is part of a chord and its own actions are replaced.
+//
+// Arguments :  source : int : Input source (sip and puff, buttons or switches)
+//
+// Return     : bool : true if the source is claimed by a chord
+//*********************************//
+bool LSChord::isClaimed(int source) {
+  if (source < 0 || source >= CHORD_SOURCE_NUMBER) {
+    return false;
+  }
+  return (_claimedSource & (1 << source)) != 0;
+}
+
+//*********************************//
+// Function   : getSourceChordState
+//
+// Description: Convert the main state of an input source to chord state bits.
+//              Hard sips and puffs hold the same bits as sips and puffs.
+//
+// Arguments :  source : int : Input source (sip and puff, buttons or switches)
+//              mainState : int : Main state of the source
+//
+// Return     : int : Chord state bits
+//*********************************//
+int LSChord::getSourceChordState(int source, int mainState) {
+  switch (source) {
+    case CONF_GESTURE_SOURCE_SAP:
+      if (mainState == PRESS_SAP_MAIN_STATE_SIP || mainState == PRESS_SAP_MAIN_STATE_HARD_SIP) {
+        return CONF_CHORD_SIP;
+      } else if (mainState == PRESS_SAP_MAIN_STATE_PUFF || mainState == PRESS_SAP_MAIN_STATE_HARD_PUFF) {
+        return CONF_CHORD_PUFF;
+      }
+      return 0;
+    case CONF_GESTURE_SOURCE_BUTTON:
+      return (mainState << CONF_CHORD_BUTTON_SHIFT) & CHORD_BUTTON_MASK;
+    case CONF_GESTURE_SOURCE_SWITCH:
+      return (mainState << CONF_CHORD_SWITCH_SHIFT) & CHORD_SWITCH_MASK;
+  }
+  return 0;
+}
+
+//*********************************//
+// Function   : isMapped
+//
+// Description: Check if a chord state holds inputs of two or more sources and has an action window.
+//
+// Arguments :  chordState : int : Chord state bits
+//
+// Return     : bool : true if the chord state is a mapped chord
+//*********************************//
+bool LSChord::isMapped(int chordState) {
+  int sourceCount = ((chordState & CHORD_SAP_MASK) != 0) + ((chordState & CHORD_BUTTON_MASK) != 0) + ((chordState & CHORD_SWITCH_MASK) != 0);
+  return (sourceCount >= 2 && _actionTable != NULL && _actionTable->getIntervalCount(chordState) > 0);
+}
+
+#endif
@@ -71,12 +71,15 @@ const String CONF_LIPSYNC_VERSION_STRING = String(CONF_LIPSYNC_VERSION_MAJOR) +
 #define CONF_OPERATING_MODE_MOUSE 1
 #define CONF_OPERATING_MODE_GAMEPAD 2
 #define CONF_OPERATING_MODE_SAFE 3
-#define CONF_OPERATING_MODE_MAX 3
+#define CONF_OPERATING_MODE_ABSOLUTE 4
+#define CONF_OPERATING_MODE_MAX 4
 
 #define CONF_OPERATING_MODE_DEFAULT CONF_OPERATING_MODE_MOUSE  // Default mode = Mouse
                                           // 0 = Operating Mode null
                                           // 1 = Mouse
                                           // 2 = Gamepad  
+                                          // 3 = Safe
+                                          // 4 = Absolute pointer ( USB only )
 
 // Communication mode values 
 #define CONF_COM_MODE_MIN  0
@@ -155,17 +158,26 @@ const String CONF_LIPSYNC_VERSION_STRING = String(CONF_LIPSYNC_VERSION_MAJOR) +
 #define CONF_ACTION_SELECT_MENU_ITEM 22    // Select current item in menu 
 #define CONF_ACTION_RESET 23               // Software Reset
 #define CONF_ACTION_FACTORY_RESET 24       // Factory Reset
+#define CONF_ACTION_MACRO_1 25             // Run macro 1
+#define CONF_ACTION_MACRO_2 26             // Run macro 2
+#define CONF_ACTION_MACRO_3 27             // Run macro 3
+#define CONF_ACTION_MACRO_4 28             // Run macro 4
+#define CONF_ACTION_NEXT_HOST 29           // Switch to the next Bluetooth host
+
+#define CONF_ACTION_NUMBER 30              // Number of output actions
 
 
 // Flash Memory settings - Don't change  
 #define CONF_SETTINGS_FILE    "/settings.txt"
-#define CONF_SETTINGS_JSON    "{\"MN\":0,\"VN1\":4,\"VN2\":1,\"VN3\":0,\"ID\":0,\"OM\":1,\"CM\":1,\"SS\":5,\"SL\":5,\"ST\":3.0,\"PT\":3.0,\"AV\":0,\"IZ\":0.07,\"OZ\":0.95,\"CA0\":[0.0,0.0],\"CA1\":[-13.0,13.0],\"CA2\":[13.0,13.0],\"CA3\":[13.0,-13.0],\"CA4\":[-13.0,-13.0],\"SM\":1,\"LM\":1,\"LL\":5,\"DM\":0}"
+#define CONF_ACTION_MAP_FILE  "/actions.bin"
+#define CONF_MACRO_FILE       "/macros.bin"
+#define CONF_BT_HOST_FILE     "/hosts.bin"
+#define CONF_SETTINGS_JSON    "{\"MN\":0,\"VN1\":4,\"VN2\":1,\"VN3\":0,\"ID\":0,\"OM\":1,\"CM\":1,\"SS\":5,\"SL\":5,\"ST\":3.0,\"PT\":3.0,\"AV\":0,\"IZ\":0.07,\"OZ\":0.95,\"CA0\":[0.0,0.0],\"CA1\":[-13.0,13.0],\"CA2\":[13.0,13.0],\"CA3\":[13.0,-13.0],\"CA4\":[-13.0,-13.0],\"SM\":1,\"LM\":1,\"LL\":5,\"DM\":0,\"AT\":0,\"AF\":50,\"HS\":0.0,\"HP\":0.0,\"PO\":0,\"PD\":1.0,\"PC\":1.0,\"GS\":0,\"DW\":0,\"DT\":1000,\"HR\":0,\"AP\":0,\"AR\":0,\"AG\":0,\"BH\":0}"
 
 // Polling rates for each module
 #define CONF_JOYSTICK_POLL_RATE 20          // 20 ms 
 #define CONF_SCROLL_POLL_RATE 30            // 30 ms
 #define CONF_PRESSURE_POLL_RATE 50          // 50 ms
-#define CONF_INPUT_POLL_RATE 20             // 20 ms
 #define CONF_BT_FEEDBACK_POLL_RATE 1000     // 1s         
 #define CONF_DEBUG_POLL_RATE 100            // 100 ms
 #define CONF_SCREEN_POLL_RATE 20            // 20 ms
@@ -200,13 +212,12 @@ const String CONF_LIPSYNC_VERSION_STRING = String(CONF_LIPSYNC_VERSION_MAJOR) +
 // Polling Timer IDs for each module
 #define CONF_TIMER_JOYSTICK 0
 #define CONF_TIMER_PRESSURE 1
-#define CONF_TIMER_INPUT 2
-#define CONF_TIMER_BLUETOOTH 3
-#define CONF_TIMER_DEBUG 4
-#define CONF_TIMER_SCROLL 5
-#define CONF_TIMER_SCREEN 6
-#define CONF_TIMER_USB 7
-#define CONF_TIMER_WATCHDOG 8
+#define CONF_TIMER_BLUETOOTH 2
+#define CONF_TIMER_DEBUG 3
+#define CONF_TIMER_SCROLL 4
+#define CONF_TIMER_SCREEN 5
+#define CONF_TIMER_USB 6
+#define CONF_TIMER_WATCHDOG 7
 
 #define CONF_TIMER_LED_STARTUP 0
 #define CONF_TIMER_LED_IBM 1
@@ -228,9 +239,10 @@ const String CONF_LIPSYNC_VERSION_STRING = String(CONF_LIPSYNC_VERSION_MAJOR) +
 #define CONF_DEBUG_MODE_BUTTON    3
 #define CONF_DEBUG_MODE_SWITCH    4
 #define CONF_DEBUG_MODE_SAP       5
+#define CONF_DEBUG_MODE_EVENT     6
 
 #define CONF_DEBUG_MODE_MIN 0
-#define CONF_DEBUG_MODE_MAX 5
+#define CONF_DEBUG_MODE_MAX 6
 
 // Debug Default settings
 #define CONF_DEBUG_MODE_DEFAULT  0        // Default debug mode state = Off 
@@ -240,6 +252,7 @@ const String CONF_LIPSYNC_VERSION_STRING = String(CONF_LIPSYNC_VERSION_MAJOR) +
                                           // 3 = Buttons debug mode is On
                                           // 4 = Switch debug mode is On
                                           // 5 = Sip & Puff state debug mode is On
+                                          // 6 = Input event record debug mode is On
 
 
 // Internal Test
@@ -279,6 +292,7 @@ const String CONF_LIPSYNC_VERSION_STRING = String(CONF_LIPSYNC_VERSION_MAJOR) +
 //***CAN BE CHANGED***//
 // API
 #define CONF_API_ENABLED true               // Enable or Disable API
+#define CONF_API_LONG_COMMAND_MAX_LENGTH 1024  // Maximum length of a command with a long parameter (e.g. action mapping tables)
 
 // Startup Default settings
 #define CONF_STARTUP_LED_STEP_TIME 500      // Time for each color
@@ -359,11 +373,147 @@ const String CONF_LIPSYNC_VERSION_STRING = String(CONF_LIPSYNC_VERSION_MAJOR) +
 #define CONF_PUFF_THRESHOLD 3.0                   // hPa
 #define CONF_PRESS_MIN_THRESHOLD 2.0              // hPa
 #define CONF_PRESS_MAX_THRESHOLD 150.0            // hPa
+#define CONF_SIP_HARD_THRESHOLD 0.0               // hPa - 0.0 disables hard sips
+#define CONF_PUFF_HARD_THRESHOLD 0.0              // hPa - 0.0 disables hard puffs
+
+// Adaptive sip and puff threshold settings
+#define CONF_PRESS_ADAPTIVE_MODE_OFF 0
+#define CONF_PRESS_ADAPTIVE_MODE_ON 1
+#define CONF_PRESS_ADAPTIVE_MODE_MIN 0
+#define CONF_PRESS_ADAPTIVE_MODE_MAX 1
+#define CONF_PRESS_ADAPTIVE_MODE_DEFAULT CONF_PRESS_ADAPTIVE_MODE_OFF
+
+#define CONF_PRESS_ADAPTIVE_FRACTION_MIN 20       // Percentage of the typical sip or puff peak pressure used as threshold
+#define CONF_PRESS_ADAPTIVE_FRACTION_MAX 90
+#define CONF_PRESS_ADAPTIVE_FRACTION_DEFAULT 50
+
+#define CONF_PRESS_ADAPTIVE_MIN_THRESHOLD CONF_PRESS_MIN_THRESHOLD  // hPa - Lowest adapted threshold
+#define CONF_PRESS_ADAPTIVE_MAX_THRESHOLD 30.0                      // hPa - Highest adapted threshold
+#define CONF_PRESS_ADAPTIVE_SAVE_INTERVAL 300000                    // 5 minutes - Minimum time between saving adapted thresholds
+
+// Proportional pressure output settings
+#define CONF_PRESS_OUTPUT_MODE_OFF 0              // Sip and puff perform actions
+#define CONF_PRESS_OUTPUT_MODE_AXIS 1             // Pressure controls the gamepad Z axis (gamepad mode)
+#define CONF_PRESS_OUTPUT_MODE_SCROLL 2           // Pressure controls the scroll speed, puff scrolls up and sip scrolls down (mouse mode)
+#define CONF_PRESS_OUTPUT_MODE_SPEED 3            // Pressure controls the cursor speed, puff speeds up and sip slows down (mouse mode)
+#define CONF_PRESS_OUTPUT_MODE_MIN 0
+#define CONF_PRESS_OUTPUT_MODE_MAX 3
+#define CONF_PRESS_OUTPUT_MODE_DEFAULT CONF_PRESS_OUTPUT_MODE_OFF
+
+#define CONF_PRESS_OUTPUT_DEADBAND_MIN 0.5        // hPa
+#define CONF_PRESS_OUTPUT_DEADBAND_MAX 10.0       // hPa
+#define CONF_PRESS_OUTPUT_DEADBAND_DEFAULT 1.0    // hPa
+
+#define CONF_PRESS_OUTPUT_CURVE_MIN 0.5           // Output curve exponent (1.0 = linear)
+#define CONF_PRESS_OUTPUT_CURVE_MAX 3.0
+#define CONF_PRESS_OUTPUT_CURVE_DEFAULT 1.0
+
+#define CONF_PRESS_OUTPUT_SPEED_FACTOR_MAX 2.0    // Cursor speed multiplier at full puff (full sip stops the cursor)
                                                                                       
 // Sip and puff main states 
 #define PRESS_SAP_MAIN_STATE_NONE 0   // No action 
 #define PRESS_SAP_MAIN_STATE_SIP 1    // Sip action sapPressure < -sip threshold
 #define PRESS_SAP_MAIN_STATE_PUFF 2   // Puff action sapPressure > puff threshold
+#define PRESS_SAP_MAIN_STATE_HARD_SIP 3    // Hard sip action sapPressure < -hard sip threshold
+#define PRESS_SAP_MAIN_STATE_HARD_PUFF 4   // Hard puff action sapPressure > hard puff threshold
+
+#define PRESS_SAP_MAIN_STATE_SOFT_SIP PRESS_SAP_MAIN_STATE_SIP      // Sip below the hard sip threshold
+#define PRESS_SAP_MAIN_STATE_SOFT_PUFF PRESS_SAP_MAIN_STATE_PUFF    // Puff below the hard puff threshold
+
+// Gesture sequence settings
+#define CONF_GESTURE_SOURCE_SAP 0                 // Sip and puff
+#define CONF_GESTURE_SOURCE_BUTTON 1              // Hub buttons
+#define CONF_GESTURE_SOURCE_SWITCH 2              // External assistive switches
+#define CONF_GESTURE_SOURCE_SEQUENCE 3            // Completed gesture sequence (recognizer output only)
+
+#define CONF_GESTURE_TOKEN(source, mainState) ((uint8_t)(((source) << 5) | (mainState)))  // Gesture token of an input source and main state
+
+// Chord states ( Inputs of different sources held together, one bit per input )
+#define CONF_CHORD_SIP 0x01                       // Sip or hard sip
+#define CONF_CHORD_PUFF 0x02                      // Puff or hard puff
+#define CONF_CHORD_BUTTON_SHIFT 2                 // Buttons 1 and 2 : bits 2 and 3
+#define CONF_CHORD_SWITCH_SHIFT 4                 // Switches 1 to 3 : bits 4 to 6
+#define CONF_CHORD_STATE_NUMBER 128
+
+#define CONF_CHORD_STATE(sap, button, switch) ((sap) | ((button) << CONF_CHORD_BUTTON_SHIFT) | ((switch) << CONF_CHORD_SWITCH_SHIFT))  // Chord state of sip and puff bits, button and switch main states
+
+#define CONF_GESTURE_MODE_OFF 0                   // Gesture sequences are disabled
+#define CONF_GESTURE_MODE_ON 1                    // Gesture sequences are recognized in mouse and gamepad mode
+#define CONF_GESTURE_MODE_MIN 0
+#define CONF_GESTURE_MODE_MAX 1
+#define CONF_GESTURE_MODE_DEFAULT CONF_GESTURE_MODE_OFF
+
+// Dwell click settings
+#define CONF_DWELL_MODE_OFF 0                     // Dwell click is disabled
+#define CONF_DWELL_MODE_LEFT_CLICK 1              // Left click after the cursor rests
+#define CONF_DWELL_MODE_RIGHT_CLICK 2             // Right click after the cursor rests
+#define CONF_DWELL_MODE_DOUBLE_CLICK 3            // Left double click after the cursor rests
+#define CONF_DWELL_MODE_DRAG 4                    // Press or release the left button (drag toggle) after the cursor rests
+#define CONF_DWELL_MODE_MIN 0
+#define CONF_DWELL_MODE_MAX 4
+#define CONF_DWELL_MODE_DEFAULT CONF_DWELL_MODE_OFF
+
+#define CONF_DWELL_TIME_MIN 300                   // ms
+#define CONF_DWELL_TIME_MAX 5000                  // ms
+#define CONF_DWELL_TIME_DEFAULT 1000              // ms - Time the cursor rests before a dwell click
+
+#define CONF_DWELL_REST_RADIUS 4                  // Cursor motion (mouse units) within this radius is a rest
+#define CONF_DWELL_CANCEL_RADIUS 20               // Radius (mouse units) around the last click the cursor leaves before the next countdown
+#define CONF_DWELL_LED_COLOR LED_CLR_TEAL         // Color of the countdown LEDs
+
+// High resolution mouse settings
+#define CONF_HIGH_RES_MODE_OFF 0                  // 8-bit cursor motion and wheel detents
+#define CONF_HIGH_RES_MODE_ON 1                   // 16-bit cursor motion and high resolution wheels ( USB mouse )
+#define CONF_HIGH_RES_MODE_MIN 0
+#define CONF_HIGH_RES_MODE_MAX 1
+#define CONF_HIGH_RES_MODE_DEFAULT CONF_HIGH_RES_MODE_OFF
+
+// Absolute pointer settings
+#define CONF_ABS_MODE_INTEGRATE 0                 // Joystick deflection moves the pointer like a mouse
+#define CONF_ABS_MODE_DIRECT 1                    // Joystick deflection is the pointer position ( spring return to the region center )
+#define CONF_ABS_MODE_MIN 0
+#define CONF_ABS_MODE_MAX 1
+#define CONF_ABS_MODE_DEFAULT CONF_ABS_MODE_INTEGRATE
+
+#define CONF_ABS_REGION_MIN 0                     // Index of absoluteRegionProperty
+#define CONF_ABS_REGION_MAX 5
+#define CONF_ABS_REGION_DEFAULT 0                 // Full screen
+
+#define CONF_ABS_GRID_MIN 0                       // 0 = No snapping
+#define CONF_ABS_GRID_MAX 16                      // Grid cells per axis
+#define CONF_ABS_GRID_DEFAULT 0
+
+#define CONF_ABS_MOTION_SCALE 16                  // Absolute units per mouse unit in integrate mode
+#define CONF_ABS_LED_COLOR LED_CLR_GREEN          // Color of the mode indication
+
+#define CONF_GESTURE_TAP_TIME 1000                // ms - Only gestures released before this time can be part of a sequence
+#define CONF_GESTURE_SEQUENCE_TIMEOUT 400         // ms - Time to wait for the next gesture of a sequence
+
+// Macro settings
+#define CONF_MACRO_NUMBER 4                       // Number of macros ( CONF_ACTION_MACRO_1 to CONF_ACTION_MACRO_4 )
+#define CONF_MACRO_DELAY_UNIT 10                  // ms - Unit of the step delay
+#define CONF_MACRO_RETRY_DELAY 1                  // ms - Time to wait for the HID interface to accept the next step
+#define CONF_MACRO_RETRY_TIMEOUT 1000             // ms - Time a busy HID interface can hold back a step before the macro is stopped
+
+// Macro step types
+#define CONF_MACRO_STEP_WAIT 0                    // No report, delay only
+#define CONF_MACRO_STEP_MOUSE_PRESS 1             // Press mouse buttons (parameter 1)
+#define CONF_MACRO_STEP_MOUSE_RELEASE 2           // Release mouse buttons (parameter 1)
+#define CONF_MACRO_STEP_MOUSE_MOVE 3              // Move cursor by x (parameter 1) and y (parameter 2), signed
+#define CONF_MACRO_STEP_MOUSE_SCROLL 4            // Scroll by wheel (parameter 1), signed
+#define CONF_MACRO_STEP_KEY_PRESS 5               // Press key code (parameter 2) with modifiers (parameter 1)
+#define CONF_MACRO_STEP_KEY_RELEASE 6             // Release key code (parameter 2)
+#define CONF_MACRO_STEP_KEY_RELEASE_ALL 7         // Release all keys and modifiers
+#define CONF_MACRO_STEP_GAMEPAD_PRESS 8           // Press gamepad button 1 to 8 (parameter 1)
+#define CONF_MACRO_STEP_GAMEPAD_RELEASE 9         // Release gamepad button 1 to 8 (parameter 1)
+#define CONF_MACRO_STEP_GAMEPAD_RELEASE_ALL 10    // Release all gamepad buttons
+#define CONF_MACRO_STEP_NUMBER 11
+
+// Mouse buttons and keyboard usage codes used by the default macros
+#define CONF_MOUSE_BUTTON_LEFT 0x01
+#define CONF_KEY_MODIFIER_LEFTCTRL 0x01
+#define CONF_KEY_C 0x06
+#define CONF_KEY_V 0x19
 
 // Inputs and related LED feedback settings
 #define CONF_INPUT_LED_DELAY 150          // Led blink time for input actions 
@@ -382,6 +532,11 @@ const String CONF_LIPSYNC_VERSION_STRING = String(CONF_LIPSYNC_VERSION_MAJOR) +
 #define CONF_BT_LED_COLOR LED_CLR_BLUE 
 #define CONF_BT_LED_BRIGHTNESS CONF_LED_BRIGHTNESS
 
+// Bluetooth host slots
+#define CONF_BT_HOST_MIN 0
+#define CONF_BT_HOST_MAX (BLE_HOST_SLOTS - 1)
+#define CONF_BT_HOST_DEFAULT 0
+
 // Error codes
 #define CONF_ERROR_NONE 0
 #define CONF_ERROR_USB  1
@@ -407,6 +562,17 @@ const accStruct accProperty[]{
   { 9, 1.0, 0, 0 }
 };
 
+// Absolute pointer regions
+//  {LEFT, TOP, RIGHT, BOTTOM} in percent of the screen
+const absoluteRegionStruct absoluteRegionProperty[]{
+  { 0,  0,  100, 100 },   // 0 : Full screen
+  { 0,  0,  50,  100 },   // 1 : Left half
+  { 50, 0,  100, 100 },   // 2 : Right half
+  { 0,  0,  100, 50 },    // 3 : Top half
+  { 0,  50, 100, 100 },   // 4 : Bottom half
+  { 25, 25, 75,  75 }     // 5 : Center
+};
+
 /* LIPSYNC INPUT AND OUTPUT MAPPING */
 
 // Sip and Puff Action Mapping
@@ -422,7 +588,15 @@ const inputActionStruct sapActionProperty[]{
   // Sip Actions
   { PRESS_SAP_MAIN_STATE_SIP,         CONF_ACTION_RIGHT_CLICK,  CONF_ACTION_B2_PRESS,   CONF_ACTION_NEXT_MENU_ITEM, CONF_ACTION_NEXT_MENU_ITEM,       0, 1000 },
   { PRESS_SAP_MAIN_STATE_SIP,         CONF_ACTION_SCROLL,       CONF_ACTION_B4_PRESS,   CONF_ACTION_NOTHING, CONF_ACTION_NOTHING,                  1000, 3000 },  
-  { PRESS_SAP_MAIN_STATE_SIP,         CONF_ACTION_MIDDLE_CLICK, CONF_ACTION_B5_PRESS,   CONF_ACTION_NOTHING, CONF_ACTION_NOTHING,                  3000, 8000 }
+  { PRESS_SAP_MAIN_STATE_SIP,         CONF_ACTION_MIDDLE_CLICK, CONF_ACTION_B5_PRESS,   CONF_ACTION_NOTHING, CONF_ACTION_NOTHING,                  3000, 8000 },
+
+  // Hard puff actions (only used when a hard puff threshold is set)
+  { PRESS_SAP_MAIN_STATE_HARD_PUFF,   CONF_ACTION_DRAG,         CONF_ACTION_B3_PRESS,   CONF_ACTION_SELECT_MENU_ITEM, CONF_ACTION_SELECT_MENU_ITEM,    0,  3000 },
+  { PRESS_SAP_MAIN_STATE_HARD_PUFF,   CONF_ACTION_START_MENU,   CONF_ACTION_START_MENU, CONF_ACTION_STOP_MENU, CONF_ACTION_NOTHING,                 3000,  8000 },
+
+  // Hard sip actions (only used when a hard sip threshold is set)
+  { PRESS_SAP_MAIN_STATE_HARD_SIP,    CONF_ACTION_SCROLL,       CONF_ACTION_B4_PRESS,   CONF_ACTION_NEXT_MENU_ITEM, CONF_ACTION_NEXT_MENU_ITEM,       0, 3000 },
+  { PRESS_SAP_MAIN_STATE_HARD_SIP,    CONF_ACTION_MIDDLE_CLICK, CONF_ACTION_B5_PRESS,   CONF_ACTION_NOTHING, CONF_ACTION_NOTHING,                  3000, 8000 }
 };
 
 // Buttons built in to hub: S1 = Next, S2 = Select
@@ -459,6 +633,48 @@ const inputActionStruct switchActionProperty[]{
   { INPUT_MAIN_STATE_S13_PRESSED,      CONF_ACTION_START_MENU,  CONF_ACTION_START_MENU,     CONF_ACTION_STOP_MENU,  CONF_ACTION_NOTHING,          0, 3000 },
 };
 
+// Chords of inputs held together over sip and puff, buttons and switches. The chord replaces the actions of its inputs.
+const inputActionStruct chordActionProperty[]{
+  { CONF_CHORD_STATE(CONF_CHORD_PUFF, INPUT_MAIN_STATE_NONE, INPUT_MAIN_STATE_S1_PRESSED),  CONF_ACTION_MACRO_1,  CONF_ACTION_B7_PRESS,  CONF_ACTION_NOTHING,  CONF_ACTION_NOTHING,  0,  3000 },
+  { CONF_CHORD_STATE(CONF_CHORD_SIP, INPUT_MAIN_STATE_NONE, INPUT_MAIN_STATE_S1_PRESSED),   CONF_ACTION_MACRO_2,  CONF_ACTION_B8_PRESS,  CONF_ACTION_NOTHING,  CONF_ACTION_NOTHING,  0,  3000 },
+};
+
+// Gesture Sequence Mapping
+// Sequences of short gestures (released before CONF_GESTURE_TAP_TIME) that replace the actions of the individual gestures.
+// A sequence is committed as soon as no longer sequence can follow it, otherwise after CONF_GESTURE_SEQUENCE_TIMEOUT.
+//  {LENGTH, {GESTURES}, MOUSE MODE ACTION, GAMEPAD MODE ACTION}
+const gestureSequenceStruct gestureSequenceProperty[]{
+  { 2, { CONF_GESTURE_TOKEN(CONF_GESTURE_SOURCE_SAP, PRESS_SAP_MAIN_STATE_PUFF),
+         CONF_GESTURE_TOKEN(CONF_GESTURE_SOURCE_SAP, PRESS_SAP_MAIN_STATE_PUFF) },                  CONF_ACTION_DRAG,          CONF_ACTION_B6_PRESS },
+  { 2, { CONF_GESTURE_TOKEN(CONF_GESTURE_SOURCE_SAP, PRESS_SAP_MAIN_STATE_SIP),
+         CONF_GESTURE_TOKEN(CONF_GESTURE_SOURCE_SAP, PRESS_SAP_MAIN_STATE_PUFF) },                  CONF_ACTION_CURSOR_CENTER, CONF_ACTION_CURSOR_CENTER },
+  { 3, { CONF_GESTURE_TOKEN(CONF_GESTURE_SOURCE_SWITCH, INPUT_MAIN_STATE_S1_PRESSED),
+         CONF_GESTURE_TOKEN(CONF_GESTURE_SOURCE_SWITCH, INPUT_MAIN_STATE_S1_PRESSED),
+         CONF_GESTURE_TOKEN(CONF_GESTURE_SOURCE_SWITCH, INPUT_MAIN_STATE_S1_PRESSED) },             CONF_ACTION_START_MENU,    CONF_ACTION_START_MENU }
+};
+
+// Macro Mapping
+// Sequences of HID reports performed by CONF_ACTION_MACRO_1 to CONF_ACTION_MACRO_4.
+//  {STEP COUNT, {{STEP TYPE, PARAMETER 1, PARAMETER 2, DELAY AFTER STEP (x CONF_MACRO_DELAY_UNIT)}, ...}}
+const macroStruct macroProperty[]{
+  // Macro 1 : Copy ( Ctrl + C )
+  { 2, { { CONF_MACRO_STEP_KEY_PRESS,           CONF_KEY_MODIFIER_LEFTCTRL, CONF_KEY_C, 2 },
+         { CONF_MACRO_STEP_KEY_RELEASE_ALL,     0,                          0,          0 } } },
+  // Macro 2 : Paste ( Ctrl + V )
+  { 2, { { CONF_MACRO_STEP_KEY_PRESS,           CONF_KEY_MODIFIER_LEFTCTRL, CONF_KEY_V, 2 },
+         { CONF_MACRO_STEP_KEY_RELEASE_ALL,     0,                          0,          0 } } },
+  // Macro 3 : Double left click
+  { 4, { { CONF_MACRO_STEP_MOUSE_PRESS,         CONF_MOUSE_BUTTON_LEFT,     0,          2 },
+         { CONF_MACRO_STEP_MOUSE_RELEASE,       CONF_MOUSE_BUTTON_LEFT,     0,          5 },
+         { CONF_MACRO_STEP_MOUSE_PRESS,         CONF_MOUSE_BUTTON_LEFT,     0,          2 },
+         { CONF_MACRO_STEP_MOUSE_RELEASE,       CONF_MOUSE_BUTTON_LEFT,     0,          0 } } },
+  // Macro 4 : Gamepad button 1 then button 2
+  { 4, { { CONF_MACRO_STEP_GAMEPAD_PRESS,       1,                          0,         15 },
+         { CONF_MACRO_STEP_GAMEPAD_RELEASE,     1,                          0,          5 },
+         { CONF_MACRO_STEP_GAMEPAD_PRESS,       2,                          0,         15 },
+         { CONF_MACRO_STEP_GAMEPAD_RELEASE,     2,                          0,          0 } } }
+};
+
 // LED Action for all available output actions. This maps what happens with the lights when different actions are triggered.
 // ledOutputActionNumber, ledNumber, ledStartColor, ledEndColor, ledEndAction
 const ledActionStruct ledActionProperty[]{
@@ -486,5 +702,10 @@ const ledActionStruct ledActionProperty[]{
   { CONF_ACTION_NEXT_MENU_ITEM,     CONF_LED_LEFT,    LED_CLR_RED,    LED_CLR_NONE, LED_ACTION_BLINK },
   { CONF_ACTION_SELECT_MENU_ITEM,   CONF_LED_RIGHT,   LED_CLR_RED,    LED_CLR_NONE, LED_ACTION_BLINK },
   { CONF_ACTION_RESET,              CONF_LED_MICRO,   LED_CLR_RED,    LED_CLR_RED,  LED_ACTION_NONE },
-  { CONF_ACTION_FACTORY_RESET,      CONF_LED_MICRO,   LED_CLR_RED,    LED_CLR_RED,  LED_ACTION_NONE }
+  { CONF_ACTION_FACTORY_RESET,      CONF_LED_MICRO,   LED_CLR_RED,    LED_CLR_RED,  LED_ACTION_NONE },
+  { CONF_ACTION_MACRO_1,            CONF_LED_MICRO,   LED_CLR_NONE,   LED_CLR_BLUE, LED_ACTION_BLINK },
+  { CONF_ACTION_MACRO_2,            CONF_LED_MICRO,   LED_CLR_NONE,   LED_CLR_BLUE, LED_ACTION_BLINK },
+  { CONF_ACTION_MACRO_3,            CONF_LED_MICRO,   LED_CLR_NONE,   LED_CLR_BLUE, LED_ACTION_BLINK },
+  { CONF_ACTION_MACRO_4,            CONF_LED_MICRO,   LED_CLR_NONE,   LED_CLR_BLUE, LED_ACTION_BLINK },
+  { CONF_ACTION_NEXT_HOST,          CONF_LED_MICRO,   LED_CLR_NONE,   LED_CLR_BLUE, LED_ACTION_BLINK }
 };
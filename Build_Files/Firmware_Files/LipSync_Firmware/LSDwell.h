@@ -0,0 +1,191 @@
+/*
+* File: LSDwell.h
+* Firmware: LipSync
+* Developed by: MakersMakingChange
+* Version: v4.1 (28 March 2025)
+  License: GPL v3.0 or later
+
+  Copyright (C) 2024 - 2025 Neil Squire Society
+  This program is free software: you can redistribute it and/or modify it under the terms of
+  the GNU General Public License as published by the Free Software Foundation,
+  either version 3 of the License, or (at your option) any later version.
+  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License along with this program.
+  If not, see <http://www.gnu.org/licenses/>
+*/
+
+//Header definition
+#ifndef _LSDWELL_H
+#define _LSDWELL_H
+
+// The dwell detector has no Arduino dependencies. Time is passed in by the caller,
+// so it can be run on the host with a fake clock.
+
+#define DWELL_STAGE_NUMBER 3                    // Countdown stages, the click is performed at the last stage
+
+// Dwell events
+#define DWELL_EVENT_NONE 0
+#define DWELL_EVENT_CANCEL 1                    // The cursor moved during the countdown
+#define DWELL_EVENT_STAGE 2                     // The countdown reached the next stage
+#define DWELL_EVENT_CLICK 3                     // The cursor rested for the dwell time
+
+class LSDwell {
+  private:
+    unsigned long _dwellTime;
+    long _restRadiusSquare;
+    long _cancelRadiusSquare;
+    long _restX;                                // Cursor motion since it stopped
+    long _restY;
+    long _clickX;                               // Cursor motion since the last click
+    long _clickY;
+    unsigned long _restStartTime;
+    bool _armed;                                // True once the cursor left the cancel zone of the last click
+    int _stage;
+    void restartRest(unsigned long currentTime);
+  public:
+    LSDwell();
+    void begin(unsigned long dwellTime, int restRadius, int cancelRadius);
+    void setDwellTime(unsigned long dwellTime);
+    void clear();
+    int update(int moveX, int moveY, unsigned long currentTime);
+    int getStage();
+};
+
+//*********************************//
+// Function   : LSDwell
+//
+// Description: Construct LSDwell
+//
+// Arguments :  void
+//
+// Return     : void
+//*********************************//
+LSDwell::LSDwell() {
+  begin(0, 0, 0);
+}
+
+//*********************************//
+// Function   : begin
+//
+// Description: Set the dwell time and zones and wait for the cursor to move.
+//
+// Arguments :  dwellTime : unsigned long : Time (ms) the cursor rests before a click
+//              restRadius : int : Cursor motion within this radius is a rest
+//              cancelRadius : int : Radius around the last click the cursor leaves before the next countdown
+//
+// Return     : void
+//*********************************//
+void LSDwell::begin(unsigned long dwellTime, int restRadius, int cancelRadius) {
+  _dwellTime = dwellTime;
+  _restRadiusSquare = (long)restRadius * restRadius;
+  _cancelRadiusSquare = (long)cancelRadius * cancelRadius;
+  clear();
+}
+
+//*********************************//
+// Function   : setDwellTime
+//
+// Description: Set the time the cursor rests before a click.
+//
+// Arguments :  dwellTime : unsigned long : Dwell time (ms)
+//
+// Return     : void
+//*********************************//
+void LSDwell::setDwellTime(unsigned long dwellTime) {
+  _dwellTime = dwellTime;
+}
+
+//*********************************//
+// Function   : clear
+//
+// Description: Stop the countdown. The cursor has to leave the cancel zone before the next countdown,
+//              so a click or another input action is not followed by a dwell click at the same place.
+//
+// Arguments :  void
+//
+// Return     : void
+//*********************************//
+void LSDwell::clear() {
+  _restX = _restY = 0;
+  _clickX = _clickY = 0;
+  _restStartTime = 0;
+  _armed = false;
+  _stage = 0;
+}
+
+//*********************************//
+// Function   : update
+//
+// Description: Process the cursor motion of one joystick sample. The motion is accumulated,
+//              so each sample takes constant time.
+//
+// Arguments :  moveX : int : Cursor x motion of the sample
+//              moveY : int : Cursor y motion of the sample
+//              currentTime : unsigned long : Current time in ms
+//
+// Return     : int : DWELL_EVENT_NONE, _CANCEL, _STAGE or _CLICK
+//*********************************//
+int LSDwell::update(int moveX, int moveY, unsigned long currentTime) {
+  if (!_armed) {
+    _clickX += moveX;
+    _clickY += moveY;
+    if (_clickX * _clickX + _clickY * _clickY > _cancelRadiusSquare) {
+      _armed = true;
+      restartRest(currentTime);
+    }
+    return DWELL_EVENT_NONE;
+  }
+
+  _restX += moveX;
+  _restY += moveY;
+  if (_restX * _restX + _restY * _restY > _restRadiusSquare) {
+    bool counting = (_stage > 0);
+    restartRest(currentTime);  // Still moving : the rest starts from here
+    return counting ? DWELL_EVENT_CANCEL : DWELL_EVENT_NONE;
+  }
+
+  unsigned long restTime = currentTime - _restStartTime;
+  if (restTime >= _dwellTime) {
+    clear();
+    return DWELL_EVENT_CLICK;
+  }
+
+  int stage = (int)(restTime * DWELL_STAGE_NUMBER / _dwellTime);
+  if (stage > _stage) {
+    _stage = stage;
+    return DWELL_EVENT_STAGE;
+  }
+  return DWELL_EVENT_NONE;
+}
+
+//*********************************//
+// Function   : getStage
+//
+// Description: Get the countdown stage.
+//
+// Arguments :  void
+//
+// Return     : int : 0 if no countdown is shown, up to DWELL_STAGE_NUMBER - 1
+//*********************************//
+int LSDwell::getStage() {
+  return _stage;
+}
+
+//*********************************//
+// Function   : restartRest
+//
+// Description: Start a new rest at the current cursor position.
+//
+// Arguments :  currentTime : unsigned long : Current time in ms
+//
+// Return     : void
+//*********************************//
+void LSDwell::restartRest(unsigned long currentTime) {
+  _restX = _restY = 0;
+  _restStartTime = currentTime;
+  _stage = 0;
+}
+
+#endif
@@ -0,0 +1,249 @@
+/*
+* File: LSEventQueue.h
+* Firmware: LipSync
+* Developed by: MakersMakingChange
+* Version: v4.1 (28 March 2025)
+  License: GPL v3.0 or later
+
+  Copyright (C) 2024 - 2025 Neil Squire Society
+  This program is free software: you can redistribute it and/or modify it under the terms of
+  the GNU General Public License as published by the Free Software Foundation,
+  either version 3 of the License, or (at your option) any later version.
+  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License along with this program.
+  If not, see <http://www.gnu.org/licenses/>
+*/
+
+// Header definition
+#ifndef _LSEVENTQUEUE_H
+#define _LSEVENTQUEUE_H
+
+// The event queue has no Arduino dependencies. Event times are set by the producer,
+// so recorded events can be replayed on the host.
+#include <stdint.h>
+#include <stdio.h>
+
+#define EVENT_QUEUE_SIZE 16                   // Maximum number of pending events
+
+// Event types
+#define EVENT_TYPE_NONE 0
+#define EVENT_TYPE_JOYSTICK 1                 // Joystick output point : value1 = x, value2 = y
+#define EVENT_TYPE_INPUT 2                    // Input state of a source : value1 = main state, value2 = secondary state, value3 = elapsed time
+#define EVENT_TYPE_PRESSURE 3                 // Proportional pressure output : value1 = output x EVENT_PRESSURE_SCALE
+
+#define EVENT_PRESSURE_SCALE 1000             // Fixed point scale of the proportional pressure output
+
+// Coalescing of a new event with the last pending event of the same type and source
+#define EVENT_COALESCE_NONE 0                 // Keep both events
+#define EVENT_COALESCE_SUM 1                  // Add the values ( relative motion )
+#define EVENT_COALESCE_REPLACE 2              // Keep the new values only ( absolute position or level )
+
+#define EVENT_RECORD_PREFIX "EVENT"           // Prefix of a recorded event line
+#define EVENT_RECORD_MAX_LENGTH 64            // Maximum length of a recorded event line
+
+// Input event structure
+typedef struct {
+  unsigned long eventTime;                    // Time in ms the event was produced
+  uint8_t eventType;
+  uint8_t eventSource;                        // Input source of input events ( CONF_GESTURE_SOURCE_* ), 0 otherwise
+  long value1;
+  long value2;
+  long value3;
+} inputEventStruct;
+
+class LSEventQueue {
+  private:
+    inputEventStruct _event[EVENT_QUEUE_SIZE];
+    int _head;                                // Index of the oldest event
+    int _count;
+    unsigned long _droppedCount;
+    int getIndex(int position);
+  public:
+    LSEventQueue();
+    void clear();
+    bool push(inputEventStruct event, int coalesce);
+    bool pop(inputEventStruct* event);
+    int getCount();
+    unsigned long getDroppedCount();
+    static int formatEvent(const inputEventStruct& event, char* buffer, int bufferSize);
+    static bool parseEvent(const char* line, inputEventStruct* event);
+};
+
+//*********************************//
+// Function   : LSEventQueue
+//
+// Description: Construct LSEventQueue
+//
+// Arguments :  void
+//
+// Return     : void
+//*********************************//
+LSEventQueue::LSEventQueue() {
+  clear();
+  _droppedCount = 0;
+}
+
+//*********************************//
+// Function   : clear
+//
+// Description: Remove all pending events
+//
+// Arguments :  void
+//
+// Return     : void
+//*********************************//
+void LSEventQueue::clear() {
+  _head = 0;
+  _count = 0;
+}
+
+//*********************************//
+// Function   : push
+//
+// Description: Add an event, ordered by event time. Events with the same time keep the order they were pushed in.
+//              Motion and level events are coalesced with the last pending event of the same type and source
+//              unless an input state event is pending after it.
+//
+// Arguments :  event : inputEventStruct : New event
+//              coalesce : int : EVENT_COALESCE_NONE, _SUM or _REPLACE
+//
+// Return     : bool : false if the queue is full and the event was dropped
+//*********************************//
+bool LSEventQueue::push(inputEventStruct event, int coalesce) {
+  if (coalesce != EVENT_COALESCE_NONE) {
+    for (int position = _count - 1; position >= 0; position--) {
+      inputEventStruct& pending = _event[getIndex(position)];
+      if (pending.eventType != event.eventType || pending.eventSource != event.eventSource) {
+        if (pending.eventType == EVENT_TYPE_INPUT) {
+          break;  // Never move motion across an input state change
+        }
+        continue;
+      }
+      if (coalesce == EVENT_COALESCE_SUM) {
+        pending.value1 += event.value1;
+        pending.value2 += event.value2;
+        pending.value3 += event.value3;
+      } else {
+        pending.value1 = event.value1;
+        pending.value2 = event.value2;
+        pending.value3 = event.value3;
+      }
+      return true;
+    }
+  }
+
+  if (_count >= EVENT_QUEUE_SIZE) {
+    _droppedCount++;
+    return false;
+  }
+
+  // Insert sorted by time ( elapsed time comparison handles the millis overflow )
+  int position = _count;
+  while (position > 0 && (long)(_event[getIndex(position - 1)].eventTime - event.eventTime) > 0) {
+    _event[getIndex(position)] = _event[getIndex(position - 1)];
+    position--;
+  }
+  _event[getIndex(position)] = event;
+  _count++;
+  return true;
+}
+
+//*********************************//
+// Function   : pop
+//
+// Description: Remove the oldest event
+//
+// Arguments :  event : inputEventStruct* : Removed event
+//
+// Return     : bool : false if no event is pending
+//*********************************//
+bool LSEventQueue::pop(inputEventStruct* event) {
+  if (_count == 0) {
+    return false;
+  }
+  *event = _event[_head];
+  _head = getIndex(1);
+  _count--;
+  return true;
+}
+
+//*********************************//
+// Function   : getCount
+//
+// Description: Get the number of pending events
+//
+// Arguments :  void
+//
+// Return     : int : Number of pending events
+//*********************************//
+int LSEventQueue::getCount() {
+  return _count;
+}
+
+//*********************************//
+// Function   : getDroppedCount
+//
+// Description: Get the number of events dropped because the queue was full
+//
+// Arguments :  void
+//
+// Return     : unsigned long : Number of dropped events
+//*********************************//
+unsigned long LSEventQueue::getDroppedCount() {
+  return _droppedCount;
+}
+
+//*********************************//
+// Function   : formatEvent
+//
+// Description: Write an event as a record line : EVENT,time,type,source,value1,value2,value3
+//
+// Arguments :  event : const inputEventStruct& : Event
+//              buffer : char* : Line buffer
+//              bufferSize : int : Size of the buffer
+//
+// Return     : int : Length of the line
+//*********************************//
+int LSEventQueue::formatEvent(const inputEventStruct& event, char* buffer, int bufferSize) {
+  return snprintf(buffer, bufferSize, "%s,%lu,%u,%u,%ld,%ld,%ld", EVENT_RECORD_PREFIX,
+                  event.eventTime, event.eventType, event.eventSource, event.value1, event.value2, event.value3);
+}
+
+//*********************************//
+// Function   : parseEvent
+//
+// Description: Read an event from a record line written by formatEvent
+//
+// Arguments :  line : const char* : Record line
+//              event : inputEventStruct* : Parsed event
+//
+// Return     : bool : true if the line is a valid record
+//*********************************//
+bool LSEventQueue::parseEvent(const char* line, inputEventStruct* event) {
+  unsigned int eventType;
+  unsigned int eventSource;
+  if (sscanf(line, EVENT_RECORD_PREFIX ",%lu,%u,%u,%ld,%ld,%ld", &event->eventTime, &eventType, &eventSource,
+             &event->value1, &event->value2, &event->value3) != 6) {
+    return false;
+  }
+  event->eventType = eventType;
+  event->eventSource = eventSource;
+  return true;
+}
+
+//*********************************//
+// Function   : getIndex
+//
+// Description: Get the buffer index of a queue position
+//
+// Arguments :  position : int : Position from the oldest event
+//
+// Return     : int : Buffer index
+//*********************************//
+int LSEventQueue::getIndex(int position) {
+  return (_head + position) % EVENT_QUEUE_SIZE;
+}
+
+#endif
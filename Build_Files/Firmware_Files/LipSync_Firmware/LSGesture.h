@@ -0,0 +1,362 @@
+/*
+* File: LSGesture.h
+* Firmware: LipSync
+* Developed by: MakersMakingChange
+* Version: v4.1 (28 March 2025)
+  License: GPL v3.0 or later
+
+  Copyright (C) 2024 - 2025 Neil Squire Society
+  This program is free software: you can redistribute it and/or modify it under the terms of
+  the GNU General Public License as published by the Free Software Foundation,
+  either version 3 of the License, or (at your option) any later version.
+  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License along with this program.
+  If not, see <http://www.gnu.org/licenses/>
+*/
+
+//Header definition
+#ifndef _LSGESTURE_H
+#define _LSGESTURE_H
+
+#define GESTURE_MAX_NODES 32                                    // Maximum number of automaton nodes (sum of all sequence lengths + 1)
+#define GESTURE_MAX_OUTPUTS (GESTURE_SEQUENCE_MAX_LENGTH + 1)   // Maximum number of outputs produced by one update
+#define GESTURE_ROOT_NODE 0
+#define GESTURE_NO_NODE -1
+
+// Automaton node ( One gesture of one or more sequences sharing the same prefix )
+typedef struct {
+  uint8_t token;          // Gesture token leading to this node
+  int8_t firstChild;      // First node that can follow this node
+  int8_t nextSibling;     // Next node with the same parent
+  int8_t sequenceIndex;   // Index of the sequence ending at this node, or -1
+} gestureNodeStruct;
+
+// Recognizer output ( Gesture released by the recognizer or completed sequence )
+typedef struct {
+  uint8_t source;           // Input source, CONF_GESTURE_SOURCE_SEQUENCE for a completed sequence
+  inputStateStruct state;   // Released input state, mainState is the sequence index for a completed sequence
+} gestureEventStruct;
+
+class LSGesture {
+  private:
+    gestureNodeStruct _node[GESTURE_MAX_NODES];
+    int _nodeCount;
+    int _currentNode;                                           // Node of the last held gesture
+    unsigned long _tapTime;
+    unsigned long _sequenceTimeout;
+    unsigned long _lastGestureTime;
+    gestureEventStruct _heldGesture[GESTURE_SEQUENCE_MAX_LENGTH]; // Gestures held while a sequence is pending
+    int _heldLength;
+    gestureEventStruct _output[GESTURE_MAX_OUTPUTS];
+    int _outputLength;
+    int findChild(int nodeIndex, uint8_t token);
+    int addChild(int nodeIndex, uint8_t token);
+    void commitPending();
+    void addOutput(uint8_t source, inputStateStruct state);
+  public:
+    LSGesture();
+    void begin(const gestureSequenceStruct sequenceProperty[], int sequenceSize, unsigned long tapTime, unsigned long sequenceTimeout);
+    void clear();
+    bool update(uint8_t source, inputStateStruct releasedState, unsigned long currentTime);
+    void checkTimeout(unsigned long currentTime);
+    bool isPending();
+    void flush();
+    bool isGestureToken(uint8_t token);
+    int getOutputLength();
+    gestureEventStruct getOutput(int outputIndex);
+};
+
+//*********************************//
+// Function   : LSGesture
+//
+// Description: Construct LSGesture
+//
+// Arguments :  void
+//
+// Return     : void
+//*********************************//
+LSGesture::LSGesture() {
+  _nodeCount = 1;
+  _node[GESTURE_ROOT_NODE] = { 0, GESTURE_NO_NODE, GESTURE_NO_NODE, -1 };
+  _tapTime = 0;
+  _sequenceTimeout = 0;
+  clear();
+}
+
+//*********************************//
+// Function   : begin
+//
+// Description: Compile the gesture sequence table into a prefix tree automaton.
+//              Sequences sharing a prefix share nodes, so each gesture is matched
+//              by scanning only the children of the current node.
+//
+// Arguments :  sequenceProperty : const gestureSequenceStruct[] : Gesture sequence table
+//              sequenceSize : int : Number of sequences in the table
+//              tapTime : unsigned long : Gestures released before this time (ms) can be part of a sequence
+//              sequenceTimeout : unsigned long : Time (ms) to wait for the next gesture of a sequence
+//
+// Return     : void
+//*********************************//
+void LSGesture::begin(const gestureSequenceStruct sequenceProperty[], int sequenceSize, unsigned long tapTime, unsigned long sequenceTimeout) {
+  _nodeCount = 1;
+  _node[GESTURE_ROOT_NODE] = { 0, GESTURE_NO_NODE, GESTURE_NO_NODE, -1 };
+  _tapTime = tapTime;
+  _sequenceTimeout = sequenceTimeout;
+  clear();
+
+  for (int sequenceIndex = 0; sequenceIndex < sequenceSize; sequenceIndex++) {
+    int sequenceLength = sequenceProperty[sequenceIndex].sequenceLength;
+    if (sequenceLength < 1 || sequenceLength > GESTURE_SEQUENCE_MAX_LENGTH) {
+      continue;  // Invalid sequence
+    }
+
+    int nodeIndex = GESTURE_ROOT_NODE;
+    for (int gestureIndex = 0; gestureIndex < sequenceLength && nodeIndex != GESTURE_NO_NODE; gestureIndex++) {
+      uint8_t token = sequenceProperty[sequenceIndex].sequenceGesture[gestureIndex];
+      int childIndex = findChild(nodeIndex, token);
+      nodeIndex = (childIndex != GESTURE_NO_NODE) ? childIndex : addChild(nodeIndex, token);
+    }
+
+    // First sequence wins if the same sequence is defined twice
+    if (nodeIndex != GESTURE_NO_NODE && _node[nodeIndex].sequenceIndex < 0) {
+      _node[nodeIndex].sequenceIndex = sequenceIndex;
+    }
+  }
+}
+
+//*********************************//
+// Function   : clear
+//
+// Description: Drop any pending sequence and outputs.
+//
+// Arguments :  void
+//
+// Return     : void
+//*********************************//
+void LSGesture::clear() {
+  _currentNode = GESTURE_ROOT_NODE;
+  _heldLength = 0;
+  _outputLength = 0;
+  _lastGestureTime = 0;
+}
+
+//*********************************//
+// Function   : update
+//
+// Description: Feed a released input gesture to the recognizer.
+//              Gestures that cannot start or continue a sequence are passed through,
+//              gestures that may be part of a sequence are held.
+//              Held gestures or completed sequences are available as outputs,
+//              which must be performed before a passed through gesture.
+//
+// Arguments :  source : uint8_t : Input source of the gesture
+//              releasedState : inputStateStruct : Released input state
+//              currentTime : unsigned long : Current time in ms
+//
+// Return     : bool : true if the gesture is held by the recognizer, false if it should be performed
+//*********************************//
+bool LSGesture::update(uint8_t source, inputStateStruct releasedState, unsigned long currentTime) {
+  _outputLength = 0;
+
+  bool isTap = (releasedState.elapsedTime < _tapTime);
+  uint8_t token = CONF_GESTURE_TOKEN(source, releasedState.mainState);
+  int nextNode = isTap ? findChild(_currentNode, token) : GESTURE_NO_NODE;
+
+  // Pending sequence is broken: commit it and try the gesture as the start of a new sequence
+  if (nextNode == GESTURE_NO_NODE && _currentNode != GESTURE_ROOT_NODE) {
+    commitPending();
+    nextNode = isTap ? findChild(GESTURE_ROOT_NODE, token) : GESTURE_NO_NODE;
+  }
+
+  if (nextNode == GESTURE_NO_NODE) {
+    return false;  // Not part of any sequence, perform without delay
+  }
+
+  // Hold gesture
+  _heldGesture[_heldLength].source = source;
+  _heldGesture[_heldLength].state = releasedState;
+  _heldLength++;
+  _currentNode = nextNode;
+  _lastGestureTime = currentTime;
+
+  // Commit early when no longer sequence can follow
+  if (_node[_currentNode].firstChild == GESTURE_NO_NODE) {
+    commitPending();
+  }
+
+  return true;
+}
+
+//*********************************//
+// Function   : checkTimeout
+//
+// Description: Commit the pending sequence if the next gesture did not arrive in time.
+//
+// Arguments :  currentTime : unsigned long : Current time in ms
+//
+// Return     : void
+//*********************************//
+void LSGesture::checkTimeout(unsigned long currentTime) {
+  _outputLength = 0;
+  if (_currentNode != GESTURE_ROOT_NODE && (currentTime - _lastGestureTime) >= _sequenceTimeout) {
+    commitPending();
+  }
+}
+
+//*********************************//
+// Function   : isPending
+//
+// Description: Check if gestures are held while waiting for the rest of a sequence.
+//
+// Arguments :  void
+//
+// Return     : bool : true if a sequence is pending
+//*********************************//
+bool LSGesture::isPending() {
+  return (_currentNode != GESTURE_ROOT_NODE);
+}
+
+//*********************************//
+// Function   : flush
+//
+// Description: Commit the pending sequence without waiting for the sequence timeout.
+//
+// Arguments :  void
+//
+// Return     : void
+//*********************************//
+void LSGesture::flush() {
+  _outputLength = 0;
+  if (_currentNode != GESTURE_ROOT_NODE) {
+    commitPending();
+  }
+}
+
+//*********************************//
+// Function   : isGestureToken
+//
+// Description: Check if a gesture token is part of any sequence.
+//
+// Arguments :  token : uint8_t : Gesture token
+//
+// Return     : bool : true if the token appears in a sequence
+//*********************************//
+bool LSGesture::isGestureToken(uint8_t token) {
+  for (int nodeIndex = 1; nodeIndex < _nodeCount; nodeIndex++) {
+    if (_node[nodeIndex].token == token) {
+      return true;
+    }
+  }
+  return false;
+}
+
+//*********************************//
+// Function   : getOutputLength
+//
+// Description: Number of outputs produced by the last update or timeout check.
+//
+// Arguments :  void
+//
+// Return     : int : Number of outputs
+//*********************************//
+int LSGesture::getOutputLength() {
+  return _outputLength;
+}
+
+//*********************************//
+// Function   : getOutput
+//
+// Description: Output produced by the last update or timeout check, in order.
+//
+// Arguments :  outputIndex : int : Index of output
+//
+// Return     : gestureEventStruct : Released gesture or completed sequence
+//*********************************//
+gestureEventStruct LSGesture::getOutput(int outputIndex) {
+  return _output[outputIndex];
+}
+
+//*********************************//
+// Function   : findChild
+//
+// Description: Find the node following a node for a gesture token.
+//
+// Arguments :  nodeIndex : int : Parent node
+//              token : uint8_t : Gesture token
+//
+// Return     : int : Child node, or GESTURE_NO_NODE
+//*********************************//
+int LSGesture::findChild(int nodeIndex, uint8_t token) {
+  for (int childIndex = _node[nodeIndex].firstChild; childIndex != GESTURE_NO_NODE; childIndex = _node[childIndex].nextSibling) {
+    if (_node[childIndex].token == token) {
+      return childIndex;
+    }
+  }
+  return GESTURE_NO_NODE;
+}
+
+//*********************************//
+// Function   : addChild
+//
+// Description: Add a node following a node for a gesture token.
+//
+// Arguments :  nodeIndex : int : Parent node
+//              token : uint8_t : Gesture token
+//
+// Return     : int : New node, or GESTURE_NO_NODE if the automaton is full
+//*********************************//
+int LSGesture::addChild(int nodeIndex, uint8_t token) {
+  if (_nodeCount >= GESTURE_MAX_NODES) {
+    return GESTURE_NO_NODE;
+  }
+  int childIndex = _nodeCount++;
+  _node[childIndex] = { token, GESTURE_NO_NODE, _node[nodeIndex].firstChild, -1 };
+  _node[nodeIndex].firstChild = childIndex;
+  return childIndex;
+}
+
+//*********************************//
+// Function   : commitPending
+//
+// Description: Output the sequence ending at the current node, or release the held
+//              gestures if they do not form a complete sequence.
+//
+// Arguments :  void
+//
+// Return     : void
+//*********************************//
+void LSGesture::commitPending() {
+  int sequenceIndex = _node[_currentNode].sequenceIndex;
+  if (sequenceIndex >= 0) {
+    inputStateStruct sequenceState = { sequenceIndex, INPUT_SEC_STATE_RELEASED, 0 };
+    addOutput(CONF_GESTURE_SOURCE_SEQUENCE, sequenceState);
+  } else {
+    for (int heldIndex = 0; heldIndex < _heldLength; heldIndex++) {
+      addOutput(_heldGesture[heldIndex].source, _heldGesture[heldIndex].state);
+    }
+  }
+  _heldLength = 0;
+  _currentNode = GESTURE_ROOT_NODE;
+}
+
+//*********************************//
+// Function   : addOutput
+//
+// Description: Append an output for the caller to perform.
+//
+// Arguments :  source : uint8_t : Input source or CONF_GESTURE_SOURCE_SEQUENCE
+//              state : inputStateStruct : Released input state
+//
+// Return     : void
+//*********************************//
+void LSGesture::addOutput(uint8_t source, inputStateStruct state) {
+  if (_outputLength < GESTURE_MAX_OUTPUTS) {
+    _output[_outputLength].source = source;
+    _output[_outputLength].state = state;
+    _outputLength++;
+  }
+}
+
+#endif
@@ -22,14 +22,30 @@
 
 #define INPUT_BUFF_SIZE 5
 
-#define INPUT_SEC_STATE_WAITING 0             // OFF->OFF (and ON->ON?)
-#define INPUT_SEC_STATE_STARTED 1             // OFF->ON
-#define INPUT_SEC_STATE_RELEASED 2            // ON ->OFF
+#define INPUT_EDGE_BUFF_SIZE 16               // Number of input edges queued between updates
+#define INPUT_MAX_PINS 8                      // Maximum number of interrupt pins over all inputs (GPIOTE channels)
+
+#define INPUT_DEBOUNCE_TIME 5                 // ms - Input word must be stable this long before an edge is accepted
 
 #define INPUT_REACTION_TIME 20
 
+#define INPUT_REFRESH_TIME 20                 // ms - Elapsed time update rate while an input is active
+
 #define INPUT_ACTION_TIMEOUT 60000
 
+// State machine policy for buttons and switches:
+// a different combination pressed within the reaction time is merged into the started input
+struct LSInputPolicy {
+  static constexpr int noneState = INPUT_MAIN_STATE_NONE;
+  static constexpr unsigned long debounceTime = INPUT_REACTION_TIME;
+  static constexpr unsigned long idleTimeout = INPUT_ACTION_TIMEOUT;
+  static bool mergeState(int prevMainState, int newMainState, unsigned long elapsedTime) {
+    return (newMainState != INPUT_MAIN_STATE_NONE && elapsedTime < INPUT_REACTION_TIME);
+  }
+};
+
+typedef void (*inputInterruptPtr)(void);
+
 class LSInput {
   public:
     LSInput(int* inputPinArray, int inputNumber);
@@ -37,19 +53,39 @@ class LSInput {
     void begin();                                    
     void clear();  
     void update();    
+    bool isUpdateDue(unsigned long currentTime);
     inputStateStruct getInputState();
+    unsigned long getEventTime();
   
   private: 
     LSCircularBuffer <inputStateStruct> inputBuffer;
     int *_inputPinArray;
     int _inputNumber;
-    int inputState[3];
-    int inputAllState;
-    inputStateStruct inputCurrState = {0, 0, 0};
-    inputStateStruct inputPrevState = {0, 0, 0};
-    LSTimer <void> inputStateTimer;
-    int inputStateTimerId;
+    int _stableInputState;
+    unsigned long _lastUpdateTime;
+    InputStateMachine <LSInputPolicy> inputStateMachine;
+
+    // Input edges captured by the pin interrupts
+    volatile int _edgeInputState[INPUT_EDGE_BUFF_SIZE];
+    volatile unsigned long _edgeTime[INPUT_EDGE_BUFF_SIZE];
+    volatile uint8_t _edgeHead;
+    volatile uint8_t _edgeTail;
+    volatile int _lastEdgeInputState;
+    int readInputState();
+    void pushEdge(unsigned long edgeTime);
+
+    // Pin interrupt trampolines. Each interrupt slot calls the input which owns the pin
+    static LSInput* _interruptOwner[INPUT_MAX_PINS];
+    static int _interruptCount;
+    static const inputInterruptPtr _interruptHandler[INPUT_MAX_PINS];
+    template<int slot> static void inputInterrupt() { _interruptOwner[slot]->pushEdge(millis()); }
+};
 
+LSInput* LSInput::_interruptOwner[INPUT_MAX_PINS];
+int LSInput::_interruptCount = 0;
+const inputInterruptPtr LSInput::_interruptHandler[INPUT_MAX_PINS] = {
+  &LSInput::inputInterrupt<0>, &LSInput::inputInterrupt<1>, &LSInput::inputInterrupt<2>, &LSInput::inputInterrupt<3>,
+  &LSInput::inputInterrupt<4>, &LSInput::inputInterrupt<5>, &LSInput::inputInterrupt<6>, &LSInput::inputInterrupt<7>
 };
 
 LSInput::LSInput(int* inputPinArray, int inputNumber)
@@ -65,6 +101,9 @@ LSInput::LSInput(int* inputPinArray, int inputNumber)
     _inputPinArray[i] = inputPinArray[i];
   }
 
+  _edgeHead = _edgeTail = 0;
+  _stableInputState = _lastEdgeInputState = INPUT_MAIN_STATE_NONE;
+  _lastUpdateTime = 0;
 }
 
 LSInput::~LSInput()
@@ -74,91 +113,112 @@ LSInput::~LSInput()
 
 void LSInput::begin() {
   clear();  
+
+  // Capture a timestamped edge on every change of each pin
+  for (int i = 0; i < _inputNumber && _interruptCount < INPUT_MAX_PINS; i++){
+    _interruptOwner[_interruptCount] = this;
+    attachInterrupt(digitalPinToInterrupt(_inputPinArray[i]), _interruptHandler[_interruptCount], CHANGE);
+    _interruptCount++;
+  }
 }
 
 void LSInput::clear() {
-    
-  inputStateStruct inputPrevState = {INPUT_MAIN_STATE_NONE, INPUT_SEC_STATE_WAITING, 0};
 
-  inputBuffer.pushElement(inputPrevState);
+  noInterrupts();
+  _edgeTail = _edgeHead;  // Drop queued edges
+  interrupts();
 
-  inputStateTimerId = inputStateTimer.startTimer();
-}
+  _stableInputState = _lastEdgeInputState = readInputState();
 
+  inputStateMachine.clear(millis());
 
-void LSInput::update() {
-  inputStateTimer.run();
+  inputBuffer.pushElement(inputStateMachine.getState());
+}
 
-  inputAllState = 0;
+// Read all pins and create a single bitmask to represent the collective states
+int LSInput::readInputState() {
+  int inputAllState = 0;
+  for (int i = 0; i < _inputNumber; i++){
+    if (!digitalRead(_inputPinArray[i])) {
+      inputAllState |= (1 << i);  // inputAllState = inputState[0] + 2 * inputState[1] + 4 * inputState[2]
+    }
+  }
+  return inputAllState;
+}
 
+// Called from the pin interrupt: queue the new input state with the time of the edge
+void LSInput::pushEdge(unsigned long edgeTime) {
+  int inputAllState = readInputState();
+  if (inputAllState == _lastEdgeInputState) {
+    return;  // No change (edge of a bounce that already settled)
+  }
+  _lastEdgeInputState = inputAllState;
+
+  uint8_t nextHead = (_edgeHead + 1) % INPUT_EDGE_BUFF_SIZE;
+  if (nextHead == _edgeTail) {
+    // Queue full: replace the newest edge so the latest input state is kept
+    uint8_t lastHead = (_edgeHead + INPUT_EDGE_BUFF_SIZE - 1) % INPUT_EDGE_BUFF_SIZE;
+    _edgeInputState[lastHead] = inputAllState;
+    _edgeTime[lastHead] = edgeTime;
+    return;
+  }
+  _edgeInputState[_edgeHead] = inputAllState;
+  _edgeTime[_edgeHead] = edgeTime;
+  _edgeHead = nextHead;
+}
 
-  // for each input pin, do a digital read and create a single number to represent the collective states
-  for (int i = 0; i < _inputNumber; i++){
-    inputState[i] = !digitalRead(_inputPinArray[i]);
-    inputAllState+= pow(2,i) * inputState[i];  // create single integer to represent combination of button presses
-  }  
-  
-  inputPrevState = inputBuffer.getLastElement();
-  
+// Check if edges are queued, or if an active input needs its elapsed time updated
+bool LSInput::isUpdateDue(unsigned long currentTime) {
+  if (_edgeTail != _edgeHead) {
+    return true;
+  }
+  return (inputStateMachine.getState().secondaryState != INPUT_SEC_STATE_WAITING
+          && (currentTime - _lastUpdateTime) >= INPUT_REFRESH_TIME);
+}
 
-  // inputAllState = inputState[0] + 2 * inputState[1] + 4 * inputState[2];
- 
-  // prev: none, waiting  current : none 
-  // prev: press x,started  current : press x 
-  if((inputAllState == inputPrevState.mainState // current button states are the same as previous
-      && inputPrevState.secondaryState != INPUT_SEC_STATE_RELEASED)) { // and last state was not a release
-    
-    inputCurrState = {inputAllState, inputPrevState.secondaryState, inputStateTimer.elapsedTime(inputStateTimerId)};
-
-    inputBuffer.updateLastElement(inputCurrState);  // add state to buffer
-
-  } // prev: press x,started  current : press y and elapsed time < reaction time in ms   (120 ms debounce?)
-  else if(inputAllState != INPUT_MAIN_STATE_NONE                      // Something is currently pressed
-          && inputPrevState.secondaryState == INPUT_SEC_STATE_STARTED // AND previous state was input start
-          && inputPrevState.elapsedTime < INPUT_REACTION_TIME){       // AND time elapsed is less than (debounce?) threshold
-
-    inputCurrState = {inputAllState, inputPrevState.secondaryState, inputStateTimer.elapsedTime(inputStateTimerId)};
-
-    inputBuffer.updateLastElement(inputCurrState);  // add state to buffer
-  } 
-
-  // (current button states are different than previous OR last state was released) OR (current button states are different AND current button state is all off)
-  else { 
-      // prev: none,waiting  current : press x 
-      if(inputPrevState.secondaryState == INPUT_SEC_STATE_WAITING) {
-        
-        inputCurrState = {inputAllState, INPUT_SEC_STATE_STARTED, 0};
-        
-      } // prev: press x,started  current : none  OR prev: press x,started  current : press y and elapsed time >= 150
-      else if(inputPrevState.secondaryState == INPUT_SEC_STATE_STARTED 
-           && inputPrevState.elapsedTime >= INPUT_REACTION_TIME) {
-        
-        inputCurrState = {inputPrevState.mainState, INPUT_SEC_STATE_RELEASED, inputPrevState.elapsedTime};
-      } // prev: press x,released  current : none 
-      else if(inputPrevState.secondaryState == INPUT_SEC_STATE_RELEASED && inputAllState == INPUT_MAIN_STATE_NONE) {
-        
-        inputCurrState = {inputAllState, INPUT_SEC_STATE_WAITING, 0};
-        
-      } // prev: press x,released  current : press y 
-      else if(inputPrevState.secondaryState == INPUT_SEC_STATE_RELEASED 
-              && inputAllState != INPUT_MAIN_STATE_NONE){
-
-        inputCurrState = {inputAllState, INPUT_SEC_STATE_STARTED, 0};
-      }     
-       
-      inputBuffer.pushElement(inputCurrState); // Push the new state   
-
-      
-      inputStateTimer.restartTimer(inputStateTimerId);  // Reset and start the timer
+void LSInput::update() {
+  unsigned long currentTime = millis();
+  bool newState = false;
+
+  // Feed the state machine with the exact time of each debounced edge.
+  // Stop at the first new state so that every started and released state is seen once
+  while (!newState && _edgeTail != _edgeHead) {
+    // The interrupt replaces the newest edge when the queue is full, so read the edges it may write with interrupts off
+    uint8_t nextTail = (_edgeTail + 1) % INPUT_EDGE_BUFF_SIZE;
+    noInterrupts();
+    int edgeInputState = _edgeInputState[_edgeTail];
+    unsigned long edgeTime = _edgeTime[_edgeTail];
+    bool hasNextEdge = (nextTail != _edgeHead);
+    unsigned long nextEdgeTime = _edgeTime[nextTail];
+    interrupts();
+    unsigned long stableTime = hasNextEdge ? nextEdgeTime : currentTime;
+
+    if ((long)(stableTime - edgeTime) < INPUT_DEBOUNCE_TIME) {
+      if (!hasNextEdge) {
+        break;  // Input state is still settling
+      }
+      _edgeTail = nextTail;  // Bounce : replaced by a later edge
+      continue;
+    }
+
+    _edgeTail = nextTail;
+    if (edgeInputState != _stableInputState) {
+      _stableInputState = edgeInputState;
+      newState = inputStateMachine.update(_stableInputState, edgeTime);
+    }
   }
-  
-  // No action in 1 minute : reset timer
-  if(inputPrevState.secondaryState == INPUT_SEC_STATE_WAITING
-    && inputStateTimer.elapsedTime(inputStateTimerId) > INPUT_ACTION_TIMEOUT) {
-      // Reset and start the timer         
-      inputStateTimer.restartTimer(inputStateTimerId);
+
+  // Update the elapsed time of the current state
+  if (!newState) {
+    newState = inputStateMachine.update(_stableInputState, currentTime);
+  }
+  _lastUpdateTime = currentTime;
+
+  if (newState) {
+    inputBuffer.pushElement(inputStateMachine.getState());        // Push the new state 
+  } else {
+    inputBuffer.updateLastElement(inputStateMachine.getState());  // Update time of the current state
   }
-  
 }
 
 inputStateStruct LSInput::getInputState() {
@@ -166,4 +226,9 @@ inputStateStruct LSInput::getInputState() {
   return inputCurrState;
 }
 
-#endif 
+// Time of the latest input state, the edge time of a state that just started or released
+unsigned long LSInput::getEventTime() {
+  return inputStateMachine.getEventTime();
+}
+
+#endif
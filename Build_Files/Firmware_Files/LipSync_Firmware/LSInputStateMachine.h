@@ -0,0 +1,254 @@
+/*
+* File: LSInputStateMachine.h
+* Firmware: LipSync
+* Developed by: MakersMakingChange
+* Version: v4.1 (28 March 2025)
+  License: GPL v3.0 or later
+
+  Copyright (C) 2024 - 2025 Neil Squire Society
+  This program is free software: you can redistribute it and/or modify it under the terms of
+  the GNU General Public License as published by the Free Software Foundation,
+  either version 3 of the License, or (at your option) any later version.
+  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License along with this program.
+  If not, see <http://www.gnu.org/licenses/>
+*/
+
+// Header definition
+#ifndef _LSINPUTSTATEMACHINE_H
+#define _LSINPUTSTATEMACHINE_H
+
+// The state machine has no Arduino dependencies. Time is passed in by the caller,
+// so it can be run on the host with a fake clock.
+#include <stdint.h>
+#include "LSUtils.h"
+
+// Input secondary states
+#define INPUT_SEC_STATE_WAITING 0             // OFF->OFF
+#define INPUT_SEC_STATE_STARTED 1             // OFF->ON
+#define INPUT_SEC_STATE_RELEASED 2            // ON ->OFF
+
+#define INPUT_SEC_STATE_NUMBER 3
+
+// Input events ( How the new input word relates to the current state )
+#define INPUT_EVENT_SAME 0                    // Input word is unchanged
+#define INPUT_EVENT_MERGE 1                   // Input word changed but belongs to the started input (policy)
+#define INPUT_EVENT_BOUNCE 2                  // Input word changed before the debounce time
+#define INPUT_EVENT_ON 3                      // Input word changed to an active input
+#define INPUT_EVENT_OFF 4                     // Input word changed to no input
+
+#define INPUT_EVENT_NUMBER 5
+
+// Transition actions
+#define INPUT_TRANSITION_KEEP 0               // Keep state, update elapsed time
+#define INPUT_TRANSITION_MERGE 1              // Keep state and time, replace main state
+#define INPUT_TRANSITION_START 2              // New started state
+#define INPUT_TRANSITION_RELEASE 3            // Release started state, elapsed time is the full input duration
+#define INPUT_TRANSITION_WAIT 4               // New waiting state
+
+// Transition structure
+typedef struct {
+  uint8_t transitionAction;
+  uint8_t nextSecondaryState;
+} inputTransitionStruct;
+
+// Transition table, indexed by [secondary state][event]
+//  {ACTION, NEXT SECONDARY STATE}
+constexpr inputTransitionStruct inputTransitionTable[INPUT_SEC_STATE_NUMBER][INPUT_EVENT_NUMBER] = {
+  // WAITING :      SAME                                                 MERGE                                                  BOUNCE                                                 ON                                                      OFF
+  { { INPUT_TRANSITION_KEEP, INPUT_SEC_STATE_WAITING },   { INPUT_TRANSITION_KEEP, INPUT_SEC_STATE_WAITING },    { INPUT_TRANSITION_KEEP, INPUT_SEC_STATE_WAITING },    { INPUT_TRANSITION_START, INPUT_SEC_STATE_STARTED },    { INPUT_TRANSITION_KEEP, INPUT_SEC_STATE_WAITING } },
+  // STARTED
+  { { INPUT_TRANSITION_KEEP, INPUT_SEC_STATE_STARTED },   { INPUT_TRANSITION_MERGE, INPUT_SEC_STATE_STARTED },   { INPUT_TRANSITION_KEEP, INPUT_SEC_STATE_STARTED },    { INPUT_TRANSITION_RELEASE, INPUT_SEC_STATE_RELEASED }, { INPUT_TRANSITION_RELEASE, INPUT_SEC_STATE_RELEASED } },
+  // RELEASED
+  { { INPUT_TRANSITION_START, INPUT_SEC_STATE_STARTED },  { INPUT_TRANSITION_START, INPUT_SEC_STATE_STARTED },   { INPUT_TRANSITION_START, INPUT_SEC_STATE_STARTED },   { INPUT_TRANSITION_START, INPUT_SEC_STATE_STARTED },    { INPUT_TRANSITION_WAIT, INPUT_SEC_STATE_WAITING } }
+};
+
+// The definition of the InputStateMachine class.
+// Policy provides:
+//   static constexpr int noneState                 : Input word with no active input
+//   static constexpr unsigned long debounceTime    : Time (ms) a started input is held before it can change or release
+//   static constexpr unsigned long idleTimeout     : Time (ms) after which the waiting timer is restarted
+//   static bool mergeState(int prevMainState, int newMainState, unsigned long elapsedTime) :
+//                                                    true if the new input word belongs to the started input
+template<typename Policy>
+class InputStateMachine {
+  public:
+    InputStateMachine();
+    void clear(unsigned long currentTime);
+    bool update(int inputWord, unsigned long currentTime);
+    bool update(int inputWord, unsigned long currentTime, unsigned long eventTime);
+    inputStateStruct getState();
+    unsigned long getEventTime();
+
+  private:
+    inputStateStruct _state;
+    unsigned long _stateStartTime;
+    unsigned long _eventTime;
+    int getEvent(int inputWord, unsigned long elapsedTime);
+};
+
+//*********************************//
+// Function   : InputStateMachine
+//
+// Description: Construct InputStateMachine
+//
+// Arguments :  void
+//
+// Return     : void
+//*********************************//
+template<typename Policy>
+InputStateMachine<Policy>::InputStateMachine()
+{
+  clear(0);
+}
+
+//*********************************//
+// Function   : clear
+//
+// Description: Set the waiting state and restart the state time
+//
+// Arguments :  currentTime : unsigned long : Current time in ms
+//
+// Return     : void
+//*********************************//
+template<typename Policy>
+void InputStateMachine<Policy>::clear(unsigned long currentTime)
+{
+  _state = {Policy::noneState, INPUT_SEC_STATE_WAITING, 0};
+  _stateStartTime = currentTime;
+  _eventTime = currentTime;
+}
+
+//*********************************//
+// Function   : update
+//
+// Description: Process the latest input word. All inputs of a source are processed together
+//              as one input word, e.g. a bitmask of pressed buttons.
+//
+// Arguments :  inputWord : int : Current input word
+//              currentTime : unsigned long : Current time in ms
+//
+// Return     : newState : bool : true if a new state was entered, false if the current state was updated
+//*********************************//
+template<typename Policy>
+bool InputStateMachine<Policy>::update(int inputWord, unsigned long currentTime)
+{
+  return update(inputWord, currentTime, currentTime);
+}
+
+//*********************************//
+// Function   : update
+//
+// Description: Process the latest input word. A new started state is timed from the event time,
+//              which can be earlier than the current time if the input was detected late.
+//
+// Arguments :  inputWord : int : Current input word
+//              currentTime : unsigned long : Current time in ms
+//              eventTime : unsigned long : Time in ms the input started
+//
+// Return     : newState : bool : true if a new state was entered, false if the current state was updated
+//*********************************//
+template<typename Policy>
+bool InputStateMachine<Policy>::update(int inputWord, unsigned long currentTime, unsigned long eventTime)
+{
+  unsigned long elapsedTime = currentTime - _stateStartTime;
+  const inputTransitionStruct transition = inputTransitionTable[_state.secondaryState][getEvent(inputWord, elapsedTime)];
+  bool newState = true;
+  _eventTime = currentTime;
+
+  switch (transition.transitionAction) {
+    case INPUT_TRANSITION_KEEP:
+      _state.elapsedTime = elapsedTime;
+      newState = false;
+      break;
+    case INPUT_TRANSITION_MERGE:
+      _state = {inputWord, transition.nextSecondaryState, elapsedTime};
+      newState = false;
+      break;
+    case INPUT_TRANSITION_START:
+      _stateStartTime = _eventTime = eventTime;
+      _state = {inputWord, transition.nextSecondaryState, currentTime - eventTime};
+      break;
+    case INPUT_TRANSITION_RELEASE:
+      _stateStartTime = currentTime;
+      _state = {_state.mainState, transition.nextSecondaryState, elapsedTime};
+      break;
+    case INPUT_TRANSITION_WAIT:
+      _stateStartTime = currentTime;
+      _state = {Policy::noneState, transition.nextSecondaryState, 0};
+      break;
+  }
+
+  // No action before the idle timeout : restart the waiting time
+  if (_state.secondaryState == INPUT_SEC_STATE_WAITING && _state.elapsedTime > Policy::idleTimeout) {
+    _stateStartTime = currentTime;
+    _state.elapsedTime = 0;
+  }
+
+  return newState;
+}
+
+//*********************************//
+// Function   : getState
+//
+// Description: Get the current state
+//
+// Arguments :  void
+//
+// Return     : state : inputStateStruct : Current main state, secondary state and elapsed time
+//*********************************//
+template<typename Policy>
+inputStateStruct InputStateMachine<Policy>::getState()
+{
+  return _state;
+}
+
+//*********************************//
+// Function   : getEventTime
+//
+// Description: Get the time of the current state : the start time of a new started state, 
+//              otherwise the time of the last update
+//
+// Arguments :  void
+//
+// Return     : eventTime : unsigned long : Time in ms
+//*********************************//
+template<typename Policy>
+unsigned long InputStateMachine<Policy>::getEventTime()
+{
+  return _eventTime;
+}
+
+//*********************************//
+// Function   : getEvent
+//
+// Description: Classify the input word against the current state
+//
+// Arguments :  inputWord : int : Current input word
+//              elapsedTime : unsigned long : Time in ms since the current state started
+//
+// Return     : event : int : INPUT_EVENT_SAME, _MERGE, _BOUNCE, _ON or _OFF
+//*********************************//
+template<typename Policy>
+int InputStateMachine<Policy>::getEvent(int inputWord, unsigned long elapsedTime)
+{
+  if (_state.secondaryState == INPUT_SEC_STATE_RELEASED) {
+    return (inputWord != Policy::noneState) ? INPUT_EVENT_ON : INPUT_EVENT_OFF;  // A release lasts one update
+  }
+  if (inputWord == _state.mainState) {
+    return INPUT_EVENT_SAME;
+  }
+  if (_state.secondaryState == INPUT_SEC_STATE_STARTED) {
+    if (Policy::mergeState(_state.mainState, inputWord, elapsedTime)) {
+      return INPUT_EVENT_MERGE;
+    }
+    if (elapsedTime < Policy::debounceTime) {
+      return INPUT_EVENT_BOUNCE;
+    }
+  }
+  return (inputWord != Policy::noneState) ? INPUT_EVENT_ON : INPUT_EVENT_OFF;
+}
+
+#endif
@@ -0,0 +1,351 @@
+/*
+* File: LSMacro.h
+* Firmware: LipSync
+* Developed by: MakersMakingChange
+* Version: v4.1 (28 March 2025)
+  License: GPL v3.0 or later
+
+  Copyright (C) 2024 - 2025 Neil Squire Society
+  This program is free software: you can redistribute it and/or modify it under the terms of
+  the GNU General Public License as published by the Free Software Foundation,
+  either version 3 of the License, or (at your option) any later version.
+  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License along with this program.
+  If not, see <http://www.gnu.org/licenses/>
+*/
+
+//Header definition
+#ifndef _LSMACRO_H
+#define _LSMACRO_H
+
+#define MACRO_NONE -1                           // No macro is running
+
+// Binary record : {ID0, ID1, VERSION, MACRO COUNT} {STEP COUNT, STEPS...} ... {CHECKSUM}
+#define MACRO_RECORD_ID0 'L'
+#define MACRO_RECORD_ID1 'M'
+#define MACRO_RECORD_VERSION 1
+#define MACRO_RECORD_HEADER_SIZE 4
+#define MACRO_STEP_SIZE 4                       // type, parameter 1, parameter 2, delay
+#define MACRO_RECORD_MAX_SIZE (MACRO_RECORD_HEADER_SIZE + CONF_MACRO_NUMBER * (1 + MACRO_MAX_STEPS * MACRO_STEP_SIZE) + 1)
+
+// Validation results
+#define MACRO_VALID 0
+#define MACRO_ERROR_INDEX 1                     // Unknown macro
+#define MACRO_ERROR_SIZE 2                      // Too many steps
+#define MACRO_ERROR_STEP 3                      // Step type or parameter out of range
+#define MACRO_ERROR_RECORD 4                    // Binary record header, length or checksum is invalid
+
+class LSMacro {
+  private:
+    macroStruct _macro[CONF_MACRO_NUMBER];
+    int _runningMacro;
+    int _stepIndex;
+    int validateMacro(const macroStepStruct step[], int stepCount);
+  public:
+    LSMacro();
+    void resetMacro(int macroIndex);
+    int setMacro(int macroIndex, const macroStepStruct step[], int stepCount);
+    const macroStruct* getMacro(int macroIndex);
+    bool start(int macroIndex);
+    void stop();
+    bool isRunning();
+    const macroStepStruct* getStep();
+    void nextStep();
+    int encode(uint8_t* buffer, int bufferSize);
+    int decode(const uint8_t* buffer, int length);
+};
+
+//*********************************//
+// Function   : LSMacro
+//
+// Description: Construct LSMacro with the default macros of LSConfig.h
+//
+// Arguments :  void
+//
+// Return     : void
+//*********************************//
+LSMacro::LSMacro() {
+  _runningMacro = MACRO_NONE;
+  _stepIndex = 0;
+  for (int macroIndex = 0; macroIndex < CONF_MACRO_NUMBER; macroIndex++) {
+    resetMacro(macroIndex);
+  }
+}
+
+//*********************************//
+// Function   : resetMacro
+//
+// Description: Restore the default steps of a macro. Macros without a default are empty.
+//
+// Arguments :  macroIndex : int : Macro (0 to CONF_MACRO_NUMBER - 1)
+//
+// Return     : void
+//*********************************//
+void LSMacro::resetMacro(int macroIndex) {
+  if (macroIndex < 0 || macroIndex >= CONF_MACRO_NUMBER) {
+    return;
+  }
+  if (macroIndex < (int)(sizeof(macroProperty) / sizeof(macroStruct))) {
+    setMacro(macroIndex, macroProperty[macroIndex].step, macroProperty[macroIndex].stepCount);
+  } else {
+    setMacro(macroIndex, NULL, 0);
+  }
+}
+
+//*********************************//
+// Function   : setMacro
+//
+// Description: Validate and replace the steps of a macro. The macro is left unchanged if it's invalid.
+//              A running macro is stopped.
+//
+// Arguments :  macroIndex : int : Macro (0 to CONF_MACRO_NUMBER - 1)
+//              step : const macroStepStruct[] : New steps
+//              stepCount : int : Number of steps
+//
+// Return     : int : MACRO_VALID or validation error
+//*********************************//
+int LSMacro::setMacro(int macroIndex, const macroStepStruct step[], int stepCount) {
+  if (macroIndex < 0 || macroIndex >= CONF_MACRO_NUMBER) {
+    return MACRO_ERROR_INDEX;
+  }
+
+  int result = validateMacro(step, stepCount);
+  if (result == MACRO_VALID) {
+    if (_runningMacro == macroIndex) {
+      stop();
+    }
+    memset(&_macro[macroIndex], 0, sizeof(macroStruct));
+    if (stepCount > 0) {
+      memcpy(_macro[macroIndex].step, step, stepCount * sizeof(macroStepStruct));
+    }
+    _macro[macroIndex].stepCount = stepCount;
+  }
+  return result;
+}
+
+//*********************************//
+// Function   : getMacro
+//
+// Description: Get the steps of a macro.
+//
+// Arguments :  macroIndex : int : Macro (0 to CONF_MACRO_NUMBER - 1)
+//
+// Return     : const macroStruct* : Macro, or NULL if the macro doesn't exist
+//*********************************//
+const macroStruct* LSMacro::getMacro(int macroIndex) {
+  if (macroIndex < 0 || macroIndex >= CONF_MACRO_NUMBER) {
+    return NULL;
+  }
+  return &_macro[macroIndex];
+}
+
+//*********************************//
+// Function   : start
+//
+// Description: Start a macro from its first step. Any running macro is replaced.
+//
+// Arguments :  macroIndex : int : Macro (0 to CONF_MACRO_NUMBER - 1)
+//
+// Return     : bool : true if the macro has steps to perform
+//*********************************//
+bool LSMacro::start(int macroIndex) {
+  if (macroIndex < 0 || macroIndex >= CONF_MACRO_NUMBER || _macro[macroIndex].stepCount == 0) {
+    return false;
+  }
+  _runningMacro = macroIndex;
+  _stepIndex = 0;
+  return true;
+}
+
+//*********************************//
+// Function   : stop
+//
+// Description: Stop the running macro.
+//
+// Arguments :  void
+//
+// Return     : void
+//*********************************//
+void LSMacro::stop() {
+  _runningMacro = MACRO_NONE;
+  _stepIndex = 0;
+}
+
+//*********************************//
+// Function   : isRunning
+//
+// Description: Check if a macro has steps left to perform.
+//
+// Arguments :  void
+//
+// Return     : bool : true if a macro is running
+//*********************************//
+bool LSMacro::isRunning() {
+  return _runningMacro != MACRO_NONE;
+}
+
+//*********************************//
+// Function   : getStep
+//
+// Description: Get the current step of the running macro.
+//
+// Arguments :  void
+//
+// Return     : const macroStepStruct* : Current step, or NULL if no macro is running
+//*********************************//
+const macroStepStruct* LSMacro::getStep() {
+  if (!isRunning()) {
+    return NULL;
+  }
+  return &_macro[_runningMacro].step[_stepIndex];
+}
+
+//*********************************//
+// Function   : nextStep
+//
+// Description: Move to the next step of the running macro. The macro stops after its last step.
+//
+// Arguments :  void
+//
+// Return     : void
+//*********************************//
+void LSMacro::nextStep() {
+  if (!isRunning()) {
+    return;
+  }
+  _stepIndex++;
+  if (_stepIndex >= _macro[_runningMacro].stepCount) {
+    stop();
+  }
+}
+
+//*********************************//
+// Function   : encode
+//
+// Description: Write all macros to a compact binary record.
+//
+// Arguments :  buffer : uint8_t* : Record buffer
+//              bufferSize : int : Size of the buffer
+//
+// Return     : int : Length of the record, or 0 if the buffer is too small
+//*********************************//
+int LSMacro::encode(uint8_t* buffer, int bufferSize) {
+  if (bufferSize < MACRO_RECORD_MAX_SIZE) {
+    return 0;
+  }
+
+  int length = 0;
+  buffer[length++] = MACRO_RECORD_ID0;
+  buffer[length++] = MACRO_RECORD_ID1;
+  buffer[length++] = MACRO_RECORD_VERSION;
+  buffer[length++] = CONF_MACRO_NUMBER;
+
+  for (int macroIndex = 0; macroIndex < CONF_MACRO_NUMBER; macroIndex++) {
+    buffer[length++] = _macro[macroIndex].stepCount;
+    for (int stepIndex = 0; stepIndex < _macro[macroIndex].stepCount; stepIndex++) {
+      const macroStepStruct& step = _macro[macroIndex].step[stepIndex];
+      buffer[length++] = step.stepType;
+      buffer[length++] = step.stepParameter1;
+      buffer[length++] = step.stepParameter2;
+      buffer[length++] = step.stepDelay;
+    }
+  }
+
+  uint8_t checksum = 0;
+  for (int byteIndex = 0; byteIndex < length; byteIndex++) {
+    checksum += buffer[byteIndex];
+  }
+  buffer[length++] = checksum;
+
+  return length;
+}
+
+//*********************************//
+// Function   : decode
+//
+// Description: Load macros from a binary record. Each macro is validated before it replaces the
+//              current macro; invalid macros and macros missing from the record are left unchanged.
+//
+// Arguments :  buffer : const uint8_t* : Record
+//              length : int : Length of the record
+//
+// Return     : int : MACRO_VALID, or the first error found
+//*********************************//
+int LSMacro::decode(const uint8_t* buffer, int length) {
+  if (length < MACRO_RECORD_HEADER_SIZE + 1
+      || buffer[0] != MACRO_RECORD_ID0
+      || buffer[1] != MACRO_RECORD_ID1
+      || buffer[2] != MACRO_RECORD_VERSION) {
+    return MACRO_ERROR_RECORD;
+  }
+
+  uint8_t checksum = 0;
+  for (int byteIndex = 0; byteIndex < length - 1; byteIndex++) {
+    checksum += buffer[byteIndex];
+  }
+  if (checksum != buffer[length - 1]) {
+    return MACRO_ERROR_RECORD;
+  }
+
+  int result = MACRO_VALID;
+  int position = MACRO_RECORD_HEADER_SIZE;
+  int macroCount = min((int)buffer[3], CONF_MACRO_NUMBER);
+  for (int macroIndex = 0; macroIndex < macroCount; macroIndex++) {
+    if (position + 1 > length - 1) {
+      return MACRO_ERROR_RECORD;
+    }
+    int stepCount = buffer[position++];
+    if (stepCount > MACRO_MAX_STEPS || position + stepCount * MACRO_STEP_SIZE > length - 1) {
+      return MACRO_ERROR_RECORD;
+    }
+
+    macroStepStruct tempStep[MACRO_MAX_STEPS];
+    for (int stepIndex = 0; stepIndex < stepCount; stepIndex++) {
+      tempStep[stepIndex] = { buffer[position], buffer[position + 1], buffer[position + 2], buffer[position + 3] };
+      position += MACRO_STEP_SIZE;
+    }
+
+    int macroResult = setMacro(macroIndex, tempStep, stepCount);
+    if (result == MACRO_VALID) {
+      result = macroResult;
+    }
+  }
+  return result;
+}
+
+//*********************************//
+// Function   : validateMacro
+//
+// Description: Check the step types and parameters of a macro.
+//
+// Arguments :  step : const macroStepStruct[] : Steps
+//              stepCount : int : Number of steps
+//
+// Return     : int : MACRO_VALID or validation error
+//*********************************//
+int LSMacro::validateMacro(const macroStepStruct step[], int stepCount) {
+  if (stepCount < 0 || stepCount > MACRO_MAX_STEPS) {
+    return MACRO_ERROR_SIZE;
+  }
+
+  for (int stepIndex = 0; stepIndex < stepCount; stepIndex++) {
+    switch (step[stepIndex].stepType) {
+      case CONF_MACRO_STEP_GAMEPAD_PRESS:
+      case CONF_MACRO_STEP_GAMEPAD_RELEASE:
+        if (step[stepIndex].stepParameter1 < 1 || step[stepIndex].stepParameter1 > 8) {
+          return MACRO_ERROR_STEP;  // Gamepad buttons 1 to 8
+        }
+        break;
+      default:
+        if (step[stepIndex].stepType >= CONF_MACRO_STEP_NUMBER) {
+          return MACRO_ERROR_STEP;
+        }
+        break;
+    }
+  }
+  return MACRO_VALID;
+}
+
+#endif
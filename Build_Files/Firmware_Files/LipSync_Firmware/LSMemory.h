@@ -52,6 +52,8 @@ class LSMemory {
     void writeFloat(String fileString, String key, float value);
     void writeString(String fileString, String key, String value);
     void writePoint(String fileString, String key, pointFloatType value);
+    int readBinary(String fileString, uint8_t* buffer, int bufferSize);
+    bool writeBinary(String fileString, const uint8_t* buffer, int length);
 };
 
 
@@ -401,4 +403,59 @@ void LSMemory::writePoint(String fileString, String key, pointFloatType value){
   writeObject(fileString,key,obj);
 }
 
+//*********************************//
+// Function   : readBinary 
+// 
+// Description: Reads a binary record from a file into a buffer.
+// 
+// Arguments :  fileString : String : the name of the file
+//              buffer : uint8_t* : buffer to store the record
+//              bufferSize : int : size of the buffer
+// 
+// Return     : readLength : int : Number of bytes read, or 0 if the file doesn't exist
+//*********************************//
+int LSMemory::readBinary(String fileString, uint8_t* buffer, int bufferSize){
+  const char* fileName = fileString.c_str();
+  int readLength = 0;
+
+  if (file.open(fileName, FILE_O_READ)) {
+    readLength = file.read(buffer, bufferSize);
+    file.close();
+  }
+  return readLength;
+}
+
+//*********************************//
+// Function   : writeBinary 
+// 
+// Description: Replaces a file with a binary record. The record is written to a temporary file 
+//              which is renamed once complete, so a reset during the write keeps the previous record.
+// 
+// Arguments :  fileString : String : the name of the file
+//              buffer : const uint8_t* : record to write
+//              length : int : number of bytes to write
+// 
+// Return     : bool : true if the record was written
+//*********************************//
+bool LSMemory::writeBinary(String fileString, const uint8_t* buffer, int length){
+  String tempFileString = fileString + ".tmp";
+  const char* fileName = fileString.c_str();
+  const char* tempFileName = tempFileString.c_str();
+
+  InternalFS.remove(tempFileName);
+  if (!file.open(tempFileName, FILE_O_WRITE)) {
+    return false;
+  }
+  int writeLength = file.write(buffer, length);
+  file.close();
+
+  if (writeLength != length) {
+    InternalFS.remove(tempFileName);
+    return false;
+  }
+
+  InternalFS.remove(fileName);
+  return InternalFS.rename(tempFileName, fileName);
+}
+
 #endif 
@@ -0,0 +1,206 @@
+/*
+* File: LSPointer.h
+* Firmware: LipSync
+* Developed by: MakersMakingChange
+* Version: v4.1 (28 March 2025)
+  License: GPL v3.0 or later
+
+  Copyright (C) 2024 - 2025 Neil Squire Society
+  This program is free software: you can redistribute it and/or modify it under the terms of
+  the GNU General Public License as published by the Free Software Foundation,
+  either version 3 of the License, or (at your option) any later version.
+  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License along with this program.
+  If not, see <http://www.gnu.org/licenses/>
+*/
+
+// Header definition
+#ifndef _LSPOINTER_H
+#define _LSPOINTER_H
+
+// The pointer has no Arduino dependencies. The position is kept in absolute units
+// of the USB absolute pointer report, 0 to POINTER_MAX on each axis of the screen.
+#include <stdint.h>
+
+#define POINTER_MAX 32767                     // Logical maximum of the absolute pointer report
+#define POINTER_PERCENT_MAX 100
+
+class LSPointer {
+  private:
+    long _x;
+    long _y;
+    long _regionMin[2];                       // Region limits in absolute units ( x, y )
+    long _regionMax[2];
+    int _gridCells;                           // Grid cells per axis, 0 if the position is not snapped
+    long snap(long position, int axis);
+  public:
+    LSPointer();
+    void setRegion(int leftPercent, int topPercent, int rightPercent, int bottomPercent);
+    void setGrid(int gridCells);
+    void center();
+    void move(long dx, long dy);
+    void setDeflection(long x, long y, long deflectionMax);
+    long getX();
+    long getY();
+};
+
+//*********************************//
+// Function   : LSPointer
+//
+// Description: Construct LSPointer with the full screen region and no grid
+//
+// Arguments :  void
+//
+// Return     : void
+//*********************************//
+LSPointer::LSPointer() {
+  _gridCells = 0;
+  setRegion(0, 0, POINTER_PERCENT_MAX, POINTER_PERCENT_MAX);
+}
+
+//*********************************//
+// Function   : setRegion
+//
+// Description: Limit the pointer to a rectangle of the screen and center it in the rectangle.
+//
+// Arguments :  leftPercent : int : Left edge in percent of the screen width
+//              topPercent : int : Top edge in percent of the screen height
+//              rightPercent : int : Right edge in percent of the screen width
+//              bottomPercent : int : Bottom edge in percent of the screen height
+//
+// Return     : void
+//*********************************//
+void LSPointer::setRegion(int leftPercent, int topPercent, int rightPercent, int bottomPercent) {
+  int percent[2][2] = { { leftPercent, rightPercent }, { topPercent, bottomPercent } };
+  for (int axis = 0; axis < 2; axis++) {
+    for (int edge = 0; edge < 2; edge++) {
+      if (percent[axis][edge] < 0) {
+        percent[axis][edge] = 0;
+      } else if (percent[axis][edge] > POINTER_PERCENT_MAX) {
+        percent[axis][edge] = POINTER_PERCENT_MAX;
+      }
+    }
+    if (percent[axis][1] < percent[axis][0]) {
+      percent[axis][1] = percent[axis][0];
+    }
+    _regionMin[axis] = (long)percent[axis][0] * POINTER_MAX / POINTER_PERCENT_MAX;
+    _regionMax[axis] = (long)percent[axis][1] * POINTER_MAX / POINTER_PERCENT_MAX;
+  }
+  center();
+}
+
+//*********************************//
+// Function   : setGrid
+//
+// Description: Snap the reported position to the center of the grid cells dividing the region.
+//
+// Arguments :  gridCells : int : Grid cells per axis, 0 to report the position without snapping
+//
+// Return     : void
+//*********************************//
+void LSPointer::setGrid(int gridCells) {
+  _gridCells = (gridCells > 0) ? gridCells : 0;
+}
+
+//*********************************//
+// Function   : center
+//
+// Description: Move the pointer to the center of the region.
+//
+// Arguments :  void
+//
+// Return     : void
+//*********************************//
+void LSPointer::center() {
+  _x = (_regionMin[0] + _regionMax[0]) / 2;
+  _y = (_regionMin[1] + _regionMax[1]) / 2;
+}
+
+//*********************************//
+// Function   : move
+//
+// Description: Integrate a relative motion into the position. The position stays within the region.
+//
+// Arguments :  dx : long : Horizontal motion in absolute units
+//              dy : long : Vertical motion in absolute units
+//
+// Return     : void
+//*********************************//
+void LSPointer::move(long dx, long dy) {
+  _x += dx;
+  _y += dy;
+  _x = (_x < _regionMin[0]) ? _regionMin[0] : ((_x > _regionMax[0]) ? _regionMax[0] : _x);
+  _y = (_y < _regionMin[1]) ? _regionMin[1] : ((_y > _regionMax[1]) ? _regionMax[1] : _y);
+}
+
+//*********************************//
+// Function   : setDeflection
+//
+// Description: Map a joystick deflection directly to the position. No deflection is the center of the region
+//              and full deflection is its edge, so the pointer returns to the center when the joystick is released.
+//
+// Arguments :  x : long : Horizontal deflection from -deflectionMax to deflectionMax
+//              y : long : Vertical deflection from -deflectionMax to deflectionMax
+//              deflectionMax : long : Full deflection
+//
+// Return     : void
+//*********************************//
+void LSPointer::setDeflection(long x, long y, long deflectionMax) {
+  center();
+  if (deflectionMax > 0) {
+    move(x * ((_regionMax[0] - _regionMin[0]) / 2) / deflectionMax,
+         y * ((_regionMax[1] - _regionMin[1]) / 2) / deflectionMax);
+  }
+}
+
+//*********************************//
+// Function   : getX
+//
+// Description: Get the horizontal position to report.
+//
+// Arguments :  void
+//
+// Return     : long : Horizontal position from 0 to POINTER_MAX
+//*********************************//
+long LSPointer::getX() {
+  return snap(_x, 0);
+}
+
+//*********************************//
+// Function   : getY
+//
+// Description: Get the vertical position to report.
+//
+// Arguments :  void
+//
+// Return     : long : Vertical position from 0 to POINTER_MAX
+//*********************************//
+long LSPointer::getY() {
+  return snap(_y, 1);
+}
+
+//*********************************//
+// Function   : snap
+//
+// Description: Snap a position to the center of its grid cell.
+//
+// Arguments :  position : long : Position within the region
+//              axis : int : 0 = x, 1 = y
+//
+// Return     : long : Snapped position
+//*********************************//
+long LSPointer::snap(long position, int axis) {
+  long size = _regionMax[axis] - _regionMin[axis];
+  if (_gridCells == 0 || size == 0) {
+    return position;
+  }
+  long cell = (position - _regionMin[axis]) * _gridCells / size;
+  if (cell >= _gridCells) {
+    cell = _gridCells - 1;  // The far edge belongs to the last cell
+  }
+  return _regionMin[axis] + (2 * cell + 1) * size / (2 * _gridCells);
+}
+
+#endif
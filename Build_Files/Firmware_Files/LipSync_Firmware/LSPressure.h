@@ -45,9 +45,32 @@
 #define PRESS_MODE_MAX 2              // Used for switching pressure mode
 
 // Sip and puff secondary states 
-#define PRESS_SAP_SEC_STATE_WAITING 0   // Waiting : No sip or puff
-#define PRESS_SAP_SEC_STATE_STARTED 1   // Started : Sip or puff being performed  (Off->On)
-#define PRESS_SAP_SEC_STATE_RELEASED 2  // Released : Sip or puff was just released (On->Off)
+#define PRESS_SAP_SEC_STATE_WAITING INPUT_SEC_STATE_WAITING     // Waiting : No sip or puff
+#define PRESS_SAP_SEC_STATE_STARTED INPUT_SEC_STATE_STARTED     // Started : Sip or puff being performed  (Off->On)
+#define PRESS_SAP_SEC_STATE_RELEASED INPUT_SEC_STATE_RELEASED   // Released : Sip or puff was just released (On->Off)
+
+// Sip and puff onset detection
+#define PRESS_SAP_ONSET_ENABLED false     // Start a gesture from a steep pressure rise before the threshold ( opt-in, not validated against false triggers )
+#define PRESS_SAP_ONSET_MAX_LEAD 150      // Longest time (ms) a slope triggered gesture is timed before its detection, 3 samples at 50 ms polling
+#define PRESS_SAP_ONSET_ARM_FACTOR 0.5    // Fraction of the sip or puff threshold above which a steep pressure rise starts the gesture
+#define PRESS_SAP_ONSET_SLOPE 0.4         // Minimum pressure change per sample (hPa) that counts as a steep rise
+#define PRESS_SAP_RELEASE_FACTOR 0.4      // Fraction of the sip or puff threshold below which a started gesture is released (hysteresis)
+
+// Adaptive sip and puff thresholds
+#define PRESS_SAP_HIST_BINS 40            // Number of bins in the peak pressure histograms
+#define PRESS_SAP_HIST_BIN_WIDTH 1.0      // Width of each histogram bin (hPa)
+#define PRESS_SAP_HIST_MIN_EVENTS 10      // Number of sips or puffs needed before the threshold is adapted
+#define PRESS_SAP_HIST_MAX_EVENTS 100     // Number of sips or puffs after which the histogram counts are halved to follow changes in effort
+#define PRESS_SAP_HARD_MAX_FACTOR 0.75    // Highest fraction of the hard threshold an adapted soft threshold may reach
+
+// Baseline tracking 
+#define PRESS_BASELINE_REST_FACTOR 0.25   // Fraction of the sip or puff threshold within which a sample can be used as rest pressure
+#define PRESS_BASELINE_REST_SLOPE 0.1     // Maximum pressure change per sample (hPa) for a rest sample
+#define PRESS_BASELINE_TRACK_RATE 0.01    // Fraction of the rest pressure error corrected per sample (5 s time constant at 50 ms polling)
+#define PRESS_BASELINE_DRIFT_TIMEOUT 10000  // Time (ms) a steady pressure outside the rest window is held before the baseline is re-zeroed to it
+
+// Proportional pressure output
+#define PRESS_OUTPUT_FULL_SCALE_FACTOR 4.0  // Multiple of the sip or puff threshold that gives full proportional output
 
 #define PRESS_SAP_ACTION_TIMEOUT 60000  // Reset timer
 #define PRESS_SAP_SENSOR_TIMEOUT 3000 // Timeout for sensor reading
@@ -59,6 +82,18 @@ typedef struct {
   float sapPressure;                    // Pressure difference used in sip and puff processing [hPa]
 } pressureStruct;
 
+// State machine policy for sip and puff:
+// a started sip or puff that becomes hard is merged into the started gesture and keeps its time
+struct LSPressurePolicy {
+  static constexpr int noneState = PRESS_SAP_MAIN_STATE_NONE;
+  static constexpr unsigned long debounceTime = 0;
+  static constexpr unsigned long idleTimeout = PRESS_SAP_ACTION_TIMEOUT;
+  static bool mergeState(int prevMainState, int newMainState, unsigned long elapsedTime) {
+    return ((prevMainState == PRESS_SAP_MAIN_STATE_PUFF && newMainState == PRESS_SAP_MAIN_STATE_HARD_PUFF) ||
+            (prevMainState == PRESS_SAP_MAIN_STATE_SIP && newMainState == PRESS_SAP_MAIN_STATE_HARD_SIP));
+  }
+};
+
 extern bool g_mouthpiecePressureSensorConnected;  // Mouthpiece pressure sensor connection state
 extern bool g_ambientPressureSensorConnected;     // Ambient pressure sensor connection state
 
@@ -80,6 +115,8 @@ class LSPressure {
     float measureOffsetPressure();                      // Measure the offset pressure between pressure sensors: offsetPressure = (sapPressureAbs- ambientPressure)
     void setSipThreshold(float s);                      // Set sip threshold
     void setPuffThreshold(float p);                     // Set puff threshold
+    void setHardSipThreshold(float s);                  // Set hard sip threshold (0 to disable hard sips)
+    void setHardPuffThreshold(float p);                 // Set hard puff threshold (0 to disable hard puffs)
     void updatePressure();                              // Update the pressure buffer with new readings 
     void updateState();                                 // Update the and puff buffer with new states 
     float getSapPressureAbs();                          // Get last main pressure from pressure buffer
@@ -87,6 +124,14 @@ class LSPressure {
     float getSapPressure();                             // Get the Pressure Difference sapPressure = (sapPressureAbs- ambientPressure- offsetPressure)
     pressureStruct getAllPressure();                    // Get the latest pressure values 
     inputStateStruct getState();                        // Get the latest sip and puff state  
+    unsigned long getOnsetTime();                       // Get the time (ms) the current or last sip or puff started
+    unsigned long getEventTime();                       // Get the time (ms) of the latest sip and puff state
+    bool canEscalate(int mainState);                    // Check if a started sip or puff can still become hard
+    float getProportionalOutput(float deadband, float curve);  // Get the latest pressure as a proportional output from -1.0 (sip) to 1.0 (puff)
+    float getSipThreshold();                            // Get sip threshold
+    float getPuffThreshold();                           // Get puff threshold
+    void setAdaptiveThreshold(bool enabled, float fraction, float minThreshold, float maxThreshold);  // Set adaptive threshold mode and its limits
+    bool isAdaptiveThresholdSaveDue(unsigned long saveInterval);  // Check if the adaptive thresholds changed and should be saved
 
   private: 
       Adafruit_LPS35HW _lps35hw = Adafruit_LPS35HW();     // Create an object of Adafruit_LPS35HW class for Sip and Puff pressure
@@ -102,13 +147,39 @@ class LSPressure {
       float _offsetPressure;                              // Offset Pressure [hPa] (Difference between two sensors)
       float _sapPressure;                                 // Calculated Pressure Difference sapPressure = (sapPressureAbs- ambientPressure- offsetPressure)
       float _refTolVal;                                   // The tolerance value in hPa used to check and update reference pressure 
-      LSTimer <void> _sapStateTimer;                      // Timer used to measure time for each sip and puff action. 
-      int _sapStateTimerId;                                // The id for the sap state timer
+      InputStateMachine <LSPressurePolicy> _sapStateMachine;  // State machine used to time each sip and puff action
       inputStateStruct _sapCurrState;                      // The current state of sip and puff
       inputStateStruct _sapPrevState;                      // The previous state of sip and puff
       float _sipThreshold;                                 // Sip Threshold 
       float _puffThreshold;                                // Puff Threshold 
+      float _hardSipThreshold;                             // Hard Sip Threshold (0 = disabled)
+      float _hardPuffThreshold;                            // Hard Puff Threshold (0 = disabled)
       int _sapMainState;                                   // The value which represents the current main state (example: PRESS_SAP_MAIN_STATE_PUFF) 
+      bool _sipArmed;                                      // True while the pressure is beyond the sip arming level
+      bool _puffArmed;                                     // True while the pressure is beyond the puff arming level
+      unsigned long _sipArmTime;                           // Time (ms) the pressure crossed the sip arming level
+      unsigned long _puffArmTime;                          // Time (ms) the pressure crossed the puff arming level
+      unsigned long _sapOnsetTime;                         // Time (ms) the current or last sip or puff started
+      unsigned long _sapTriggerTime;                       // Time (ms) a sip or puff detected by the latest sample is timed from
+      int detectMainState(float pressureValue);            // Classify the latest pressure value as none, sip, puff, hard sip or hard puff
+      bool isPuffState(int mainState);                     // Check if main state is a soft or hard puff
+      bool isSipState(int mainState);                      // Check if main state is a soft or hard sip
+      void updateBaseline(float pressureValue);            // Track the rest pressure using samples taken while no sip or puff is performed
+      unsigned long _baselineDriftTime;                    // Time (ms) the pressure started to stay steady outside the rest window
+      float _sapPeakPressure;                              // Peak pressure magnitude of the current sip or puff (hPa)
+      uint16_t _sipPeakHistogram[PRESS_SAP_HIST_BINS];     // Histogram of sip peak pressures
+      uint16_t _puffPeakHistogram[PRESS_SAP_HIST_BINS];    // Histogram of puff peak pressures
+      uint16_t _sipPeakCount;                              // Number of sips in the sip histogram
+      uint16_t _puffPeakCount;                             // Number of puffs in the puff histogram
+      bool _adaptiveEnabled;                               // True if thresholds follow the observed sip and puff effort
+      float _adaptiveFraction;                             // Fraction of the typical peak pressure used as threshold
+      float _adaptiveMinThreshold;                         // Lower limit of adapted thresholds (hPa)
+      float _adaptiveMaxThreshold;                         // Upper limit of adapted thresholds (hPa)
+      bool _adaptiveChanged;                               // True if a threshold was adapted since the last save
+      LSTimer <void> _adaptiveSaveTimer;                   // Timer used to limit how often adapted thresholds are saved
+      int _adaptiveSaveTimerId;                            // The id for the adaptive threshold save timer
+      void updatePeakHistogram(int mainState, float peakPressure);  // Add a sip or puff peak pressure and adapt the threshold
+      float getTypicalPeakPressure(uint16_t histogram[], uint16_t count);  // Get the median peak pressure of a histogram
 };
 
 
@@ -125,6 +196,15 @@ LSPressure::LSPressure()
 {
   _pressureBuffer.begin(PRESS_BUFF_SIZE);        // Initialize Pressure Buffer
   _sapBuffer.begin(PRESS_SAP_BUFF_SIZE);         // Initialize Sip and Puff Action Buffer 
+
+  // Clear peak pressure histograms
+  memset(_sipPeakHistogram, 0, sizeof(_sipPeakHistogram));
+  memset(_puffPeakHistogram, 0, sizeof(_puffPeakHistogram));
+  _sipPeakCount = _puffPeakCount = 0;
+  _sapPeakPressure = 0.0;
+  _adaptiveEnabled = false;
+  _adaptiveChanged = false;
+  _adaptiveSaveTimerId = -1;
 }
 
 //*********************************//
@@ -169,6 +249,8 @@ void LSPressure::begin()
   // Set default pressure thresholds
   setSipThreshold(PRESS_SAP_DEFAULT_THRESHOLD);
   setPuffThreshold(PRESS_SAP_DEFAULT_THRESHOLD);
+  setHardSipThreshold(0.0);
+  setHardPuffThreshold(0.0);
 
   //delay(5);
   //_lps35hw.setDataRate(LPS35HW_RATE_25_HZ);  // Options: 1 Hz, 10Hz, 25Hz, 50Hz, 75Hz
@@ -196,12 +278,16 @@ void LSPressure::clear()
     _pressureBuffer.pushElement({0.0, 0.0, 0.0});  // Clear Pressure Buffer by pushing zero readings to buffers 
   }
 
-  // Push initial state to state Queue
-  _sapCurrState = _sapPrevState = {PRESS_SAP_MAIN_STATE_NONE, PRESS_SAP_SEC_STATE_WAITING, 0};
+  // Reset the state machine and push initial state to state Queue
+  _sapStateMachine.clear(millis());
+  _sapCurrState = _sapPrevState = _sapStateMachine.getState();
   _sapBuffer.pushElement(_sapCurrState);
+  _sapMainState = PRESS_SAP_MAIN_STATE_NONE;
 
-  // Reset and start the timer   
-  _sapStateTimerId =  _sapStateTimer.startTimer();
+  // Clear onset detection
+  _sipArmed = _puffArmed = false;
+  _sipArmTime = _puffArmTime = _sapOnsetTime = _sapTriggerTime = millis();
+  _baselineDriftTime = millis();
 
 }
 
@@ -424,6 +510,201 @@ void LSPressure::setPuffThreshold(float p)
   _puffThreshold = p;
 }
 
+//*********************************//
+// Function   : setHardSipThreshold 
+// 
+// Description: Set hard sip pressure threshold in hPa. Sips beyond this threshold are reported as hard sips.
+//              Hard sips are disabled if the threshold is zero or not above the sip threshold.
+//
+// Arguments :  s : float : Hard sip pressure threshold
+// 
+// Return     : void
+//*********************************//
+void LSPressure::setHardSipThreshold(float s)
+{
+  _hardSipThreshold = s;
+}
+
+//*********************************//
+// Function   : setHardPuffThreshold 
+// 
+// Description: Set hard puff pressure threshold in hPa. Puffs beyond this threshold are reported as hard puffs.
+//              Hard puffs are disabled if the threshold is zero or not above the puff threshold.
+//
+// Arguments :  p : float : Hard puff pressure threshold
+// 
+// Return     : void
+//*********************************//
+void LSPressure::setHardPuffThreshold(float p)
+{
+  _hardPuffThreshold = p;
+}
+
+//*********************************//
+// Function   : getSipThreshold 
+// 
+// Description: Get sip pressure threshold in hPa
+//
+// Arguments :  void
+// 
+// Return     : s : float : Sip pressure threshold
+//*********************************//
+float LSPressure::getSipThreshold()
+{
+  return _sipThreshold;
+}
+
+//*********************************//
+// Function   : getPuffThreshold 
+// 
+// Description: Get puff pressure threshold in hPa
+//
+// Arguments :  void
+// 
+// Return     : p : float : Puff pressure threshold
+//*********************************//
+float LSPressure::getPuffThreshold()
+{
+  return _puffThreshold;
+}
+
+//*********************************//
+// Function   : setAdaptiveThreshold 
+// 
+// Description: Enable or disable adaptive thresholds. When enabled, the sip and puff thresholds 
+//              are placed at a fraction of the typical (median) peak pressure of recent sips and puffs.
+//
+// Arguments :  enabled : bool : True to adapt thresholds to the observed effort
+//              fraction : float : Fraction of the typical peak pressure used as threshold
+//              minThreshold : float : Lower limit of adapted thresholds (hPa)
+//              maxThreshold : float : Upper limit of adapted thresholds (hPa)
+// 
+// Return     : void
+//*********************************//
+void LSPressure::setAdaptiveThreshold(bool enabled, float fraction, float minThreshold, float maxThreshold)
+{
+  _adaptiveEnabled = enabled;
+  _adaptiveFraction = fraction;
+  _adaptiveMinThreshold = minThreshold;
+  _adaptiveMaxThreshold = maxThreshold;
+  
+  if (_adaptiveSaveTimerId < 0) {
+    _adaptiveSaveTimerId = _adaptiveSaveTimer.startTimer();
+  }
+}
+
+//*********************************//
+// Function   : isAdaptiveThresholdSaveDue 
+// 
+// Description: Check if the thresholds were adapted and the save interval has passed since the last save.
+//              Restarts the save interval when it returns true.
+//
+// Arguments :  saveInterval : unsigned long : Minimum time between saves (ms)
+// 
+// Return     : saveDue : bool : True if the adapted thresholds should be saved
+//*********************************//
+bool LSPressure::isAdaptiveThresholdSaveDue(unsigned long saveInterval)
+{
+  if (!_adaptiveChanged || _adaptiveSaveTimerId < 0 || _adaptiveSaveTimer.elapsedTime(_adaptiveSaveTimerId) < saveInterval) {
+    return false;
+  }
+  _adaptiveChanged = false;
+  _adaptiveSaveTimer.restartTimer(_adaptiveSaveTimerId);
+  return true;
+}
+
+//*********************************//
+// Function   : updatePeakHistogram 
+// 
+// Description: Add the peak pressure of a released sip or puff to its histogram and, in adaptive mode,
+//              move the threshold to a fraction of the typical peak pressure. Counts are halved once 
+//              PRESS_SAP_HIST_MAX_EVENTS is reached so the threshold follows fatigue over a session.
+//              Hard gestures are left out of the histogram, and an adapted threshold is kept 
+//              below PRESS_SAP_HARD_MAX_FACTOR x hard threshold when hard thresholds are set.
+//
+// Arguments :  mainState : int : Soft or hard sip or puff main state
+//              peakPressure : float : Peak pressure magnitude of the gesture (hPa)
+// 
+// Return     : void
+//*********************************//
+void LSPressure::updatePeakHistogram(int mainState, float peakPressure)
+{
+  uint16_t* histogram;
+  uint16_t* count;
+
+  if (isPuffState(mainState)) {
+    histogram = _puffPeakHistogram;
+    count = &_puffPeakCount;
+  } else if (isSipState(mainState)) {
+    histogram = _sipPeakHistogram;
+    count = &_sipPeakCount;
+  } else {
+    return;
+  }
+
+  // Hard sips and puffs are deliberately stronger and would pull the soft threshold up
+  float hardThreshold = isPuffState(mainState) ? _hardPuffThreshold : _hardSipThreshold;
+  bool hardEnabled = hardThreshold > (isPuffState(mainState) ? _puffThreshold : _sipThreshold);
+  if (mainState == PRESS_SAP_MAIN_STATE_HARD_PUFF || mainState == PRESS_SAP_MAIN_STATE_HARD_SIP ||
+     (hardEnabled && peakPressure > hardThreshold)) {
+    return;
+  }
+
+  int binIndex = constrain((int)(peakPressure / PRESS_SAP_HIST_BIN_WIDTH), 0, PRESS_SAP_HIST_BINS - 1);
+  histogram[binIndex]++;
+  (*count)++;
+
+  // Forget older gestures
+  if (*count >= PRESS_SAP_HIST_MAX_EVENTS) {
+    *count = 0;
+    for (int i = 0; i < PRESS_SAP_HIST_BINS; i++) {
+      histogram[i] = histogram[i] / 2;
+      *count += histogram[i];
+    }
+  }
+
+  if (!_adaptiveEnabled || *count < PRESS_SAP_HIST_MIN_EVENTS) {
+    return;
+  }
+
+  float tempThreshold = constrain(_adaptiveFraction * getTypicalPeakPressure(histogram, *count), _adaptiveMinThreshold, _adaptiveMaxThreshold);
+
+  // Keep a gap between the soft and hard thresholds
+  if (hardEnabled) {
+    tempThreshold = min(tempThreshold, (float)(PRESS_SAP_HARD_MAX_FACTOR * hardThreshold));
+  }
+
+  if (isPuffState(mainState) && tempThreshold != _puffThreshold) {
+    setPuffThreshold(tempThreshold);
+    _adaptiveChanged = true;
+  } else if (isSipState(mainState) && tempThreshold != _sipThreshold) {
+    setSipThreshold(tempThreshold);
+    _adaptiveChanged = true;
+  }
+}
+
+//*********************************//
+// Function   : getTypicalPeakPressure 
+// 
+// Description: Get the median peak pressure of a histogram, using the center of the median bin
+//
+// Arguments :  histogram : uint16_t[] : Peak pressure histogram
+//              count : uint16_t : Number of gestures in the histogram
+// 
+// Return     : pressure : float : Median peak pressure (hPa)
+//*********************************//
+float LSPressure::getTypicalPeakPressure(uint16_t histogram[], uint16_t count)
+{
+  uint16_t cumulativeCount = 0;
+  for (int i = 0; i < PRESS_SAP_HIST_BINS; i++) {
+    cumulativeCount += histogram[i];
+    if (2 * cumulativeCount >= count) {
+      return (i + 0.5) * PRESS_SAP_HIST_BIN_WIDTH;
+    }
+  }
+  return PRESS_SAP_HIST_BINS * PRESS_SAP_HIST_BIN_WIDTH;
+}
+
 //*********************************//
 // Function   : update 
 // 
@@ -488,68 +769,189 @@ void LSPressure::updatePressure()
 // 
 // Return     : void
 //*********************************//
-void LSPressure::updateState()  //  TODO 2025-Feb-22 This code should be abstracted out as inputHandler as it is repeated for buttons and switches
+void LSPressure::updateState()
 {
-  _sapStateTimer.run();                       // Update main state timer
-  _sapPrevState = _sapBuffer.getLastElement();  // Get the previous state
+  _sapPrevState = _sapStateMachine.getState();  // Get the previous state
   
   float pressureValue = getSapPressure();    // Get latest pressure value
 
-  // check for sip and puff conditions
-  if (pressureValue > _puffThreshold) {
-    _sapMainState = PRESS_SAP_MAIN_STATE_PUFF; // Puff detected
+  _sapMainState = detectMainState(pressureValue);   // Check for sip and puff conditions
+
+  // Update the state machine. A new sip or puff is timed from its onset so the elapsed time covers the whole gesture
+  unsigned long onsetTime = _sapTriggerTime;
+  if (_sapStateMachine.update(_sapMainState, millis(), onsetTime)) {
+    _sapCurrState = _sapStateMachine.getState();
+    _sapBuffer.pushElement(_sapCurrState);        // Push the new state
+    if (_sapCurrState.secondaryState == PRESS_SAP_SEC_STATE_STARTED) {
+      _sapOnsetTime = onsetTime;
+    }
+  } else {
+    _sapCurrState = _sapStateMachine.getState();
+    _sapBuffer.updateLastElement(_sapCurrState);  // Update time of the current state
   }
-  else if (pressureValue < -1 * _sipThreshold) {
 
-    _sapMainState = PRESS_SAP_MAIN_STATE_SIP; // Sip detected
+  // Track the peak pressure of each sip and puff for adaptive thresholds
+  if (_sapCurrState.secondaryState == PRESS_SAP_SEC_STATE_STARTED) {
+    if (_sapPrevState.secondaryState != PRESS_SAP_SEC_STATE_STARTED) {
+      _sapPeakPressure = 0.0;
+    }
+    _sapPeakPressure = max(_sapPeakPressure, fabs(pressureValue));
   }
-  else {                                      // Neither sip nor puff detected
-    _sapMainState = PRESS_SAP_MAIN_STATE_NONE;
+  else if (_sapCurrState.secondaryState == PRESS_SAP_SEC_STATE_RELEASED && _sapPrevState.secondaryState == PRESS_SAP_SEC_STATE_STARTED) {
+    updatePeakHistogram(_sapCurrState.mainState, _sapPeakPressure);
   }
 
-  // Update the state using logic
-  // None:None, Sip:Sip, Puff:Puff
-  if(_sapPrevState.mainState == _sapMainState){ // Current state is same as previous
-    _sapCurrState = {_sapMainState, _sapPrevState.secondaryState, _sapStateTimer.elapsedTime(_sapStateTimerId)};
-    _sapBuffer.updateLastElement(_sapCurrState);
-  } 
-  else {  // None:Sip , None:Puff , Sip:None, Puff:None 
-      // State: Sip or puff
-      // Previous state: {none, waiting, time} Note: There can't be sip or puff and waiting 
-      // New state: {Sip or puff, started, 0}
-      if(_sapPrevState.secondaryState == PRESS_SAP_SEC_STATE_WAITING) {
-        _sapCurrState = {_sapMainState, PRESS_SAP_SEC_STATE_STARTED, 0};
-      } 
-      // State: none
-      // Previous state: {Sip or puff, started, time} Note: There can't be none and started 
-      // New state: {Sip or puff, released, time}      
-      else if(_sapPrevState.secondaryState == PRESS_SAP_SEC_STATE_STARTED){
-        _sapCurrState = {_sapPrevState.mainState, PRESS_SAP_SEC_STATE_RELEASED, _sapPrevState.elapsedTime};
-      }
-      // State: None
-      // Previous state: {Sip or puff, released, time}
-      // New state: {none, waiting, 0}
-      else if(_sapPrevState.secondaryState == PRESS_SAP_SEC_STATE_RELEASED && _sapMainState == PRESS_SAP_MAIN_STATE_NONE) {
-        _sapCurrState = {_sapMainState, PRESS_SAP_SEC_STATE_WAITING, 0};
-      }
-      // State: Sip or puff
-      // Previous state: {none, released, time}
-      // New state: {Sip or puff, started, 0}
-      else if(_sapPrevState.secondaryState == PRESS_SAP_SEC_STATE_RELEASED && _sapMainState != PRESS_SAP_MAIN_STATE_NONE) {
-        _sapCurrState = {_sapMainState, PRESS_SAP_SEC_STATE_STARTED, 0};
-      }      
-      // Push the new state   
-      _sapBuffer.pushElement(_sapCurrState);
-      // Reset and start the timer
-      _sapStateTimer.restartTimer(_sapStateTimerId);  
+  // Track the rest pressure while waiting for a sip or puff
+  if (_sapCurrState.secondaryState == PRESS_SAP_SEC_STATE_WAITING) {
+    updateBaseline(pressureValue);
+  } else {
+    _baselineDriftTime = millis();
   }
+}
 
-  // No action in 1 minute : reset timer
-  //if(_sapPrevState.secondaryState==PRESS_SAP_SEC_STATE_WAITING && _sapStateTimer.elapsedTime(_sapStateTimerId)>PRESS_SAP_ACTION_TIMEOUT){  //TODO 2025-Feb-22 Remove?
-  if(_sapStateTimer.elapsedTime(_sapStateTimerId) > PRESS_SAP_ACTION_TIMEOUT) {
-      updateOffsetPressure();   // Update pressure offset value   
-      _sapStateTimer.restartTimer(_sapStateTimerId);    // Reset and start the timer      
+//*********************************//
+// Function   : updateBaseline 
+// 
+// Description: Move the offset pressure a small step towards the current rest pressure.
+//              Only samples close to zero, with little change and outside the sip and puff 
+//              arming levels are used, so sips and puffs don't shift the baseline.
+//              If the pressure stays steady outside that window for PRESS_BASELINE_DRIFT_TIMEOUT,
+//              the baseline is re-zeroed to it so a large drift can't lock tracking out.
+//              In absolute pressure mode, the reference pressure is tracked instead.
+//
+// Arguments :  pressureValue : float : Latest pressure difference (hPa)
+// 
+// Return     : void
+//*********************************//
+void LSPressure::updateBaseline(float pressureValue)
+{
+  float pressureSlope = pressureValue - _pressureBuffer.getElement(1).sapPressure;
+  float trackRate = PRESS_BASELINE_TRACK_RATE;
+  unsigned long currentTime = millis();
+
+  bool restSample = !_sipArmed && !_puffArmed &&
+      pressureValue <= PRESS_BASELINE_REST_FACTOR * _puffThreshold && 
+      pressureValue >= -1 * PRESS_BASELINE_REST_FACTOR * _sipThreshold;
+
+  if (restSample || fabs(pressureSlope) > PRESS_BASELINE_REST_SLOPE) {
+    _baselineDriftTime = currentTime;   // Not drifting
+  }
+  
+  if (fabs(pressureSlope) > PRESS_BASELINE_REST_SLOPE) {
+    return;  // Not a rest sample
+  }
+
+  if (!restSample) {
+    // Steady pressure outside the rest window : re-zero to it once it has been held long enough
+    if (currentTime - _baselineDriftTime < PRESS_BASELINE_DRIFT_TIMEOUT) {
+      return;
+    }
+    trackRate = 1.0;
+    _baselineDriftTime = currentTime;
   }
+
+  if (_pressureMode == PRESS_MODE_DIFF) {
+    _offsetPressure += trackRate * pressureValue;
+  } else if (_pressureMode == PRESS_MODE_ABS) {
+    _ambientPressure += trackRate * pressureValue;
+  }
+}
+
+//*********************************//
+// Function   : detectMainState 
+// 
+// Description: Classify the latest pressure value as none, sip or puff.
+//              A gesture starts when the pressure crosses the threshold. If PRESS_SAP_ONSET_ENABLED
+//              is set, it also starts earlier when the pressure is past the arming level 
+//              (PRESS_SAP_ONSET_ARM_FACTOR x threshold) and has risen steeply over the last two samples.
+//              Such a gesture is timed from the arming level crossing, at most PRESS_SAP_ONSET_MAX_LEAD
+//              before its detection. A started gesture is only released once the pressure falls 
+//              below PRESS_SAP_RELEASE_FACTOR x threshold.
+//              If hard thresholds are set, a gesture that passes them is reported as a hard sip 
+//              or hard puff until it is released.
+//
+// Arguments :  pressureValue : float : Latest pressure difference (hPa)
+// 
+// Return     : mainState : int : PRESS_SAP_MAIN_STATE_NONE, _SIP, _PUFF, _HARD_SIP or _HARD_PUFF
+//*********************************//
+int LSPressure::detectMainState(float pressureValue)
+{
+  float prevPressureValue = _pressureBuffer.getElement(1).sapPressure;
+  float pressureSlope = pressureValue - prevPressureValue;
+  float prevPressureSlope = prevPressureValue - _pressureBuffer.getElement(2).sapPressure;
+  unsigned long currentTime = millis();
+
+  // Track when the pressure crossed the arming levels 
+  bool puffArmed = pressureValue > PRESS_SAP_ONSET_ARM_FACTOR * _puffThreshold;
+  bool sipArmed = pressureValue < -1 * PRESS_SAP_ONSET_ARM_FACTOR * _sipThreshold;
+  if (puffArmed && !_puffArmed) { _puffArmTime = currentTime; }
+  if (sipArmed && !_sipArmed) { _sipArmTime = currentTime; }
+  _puffArmed = puffArmed;
+  _sipArmed = sipArmed;
+
+  bool hardPuffEnabled = _hardPuffThreshold > _puffThreshold;
+  bool hardSipEnabled = _hardSipThreshold > _sipThreshold;
+  bool hardPuff = hardPuffEnabled && pressureValue > _hardPuffThreshold;
+  bool hardSip = hardSipEnabled && pressureValue < -1 * _hardSipThreshold;
+
+  // Hold a started puff or sip until the pressure falls below the release level.
+  // A soft puff or sip is raised to hard once it passes the hard threshold, and stays hard until released.
+  if (isPuffState(_sapMainState) && pressureValue > PRESS_SAP_RELEASE_FACTOR * _puffThreshold) {
+    return (hardPuff || _sapMainState == PRESS_SAP_MAIN_STATE_HARD_PUFF) ? PRESS_SAP_MAIN_STATE_HARD_PUFF : PRESS_SAP_MAIN_STATE_PUFF;
+  }
+  if (isSipState(_sapMainState) && pressureValue < -1 * PRESS_SAP_RELEASE_FACTOR * _sipThreshold) {
+    return (hardSip || _sapMainState == PRESS_SAP_MAIN_STATE_HARD_SIP) ? PRESS_SAP_MAIN_STATE_HARD_SIP : PRESS_SAP_MAIN_STATE_SIP;
+  }
+
+  _sapTriggerTime = currentTime;
+
+  // Puff detected by threshold, or by a sustained steep rise past the arming level
+  if (pressureValue > _puffThreshold) {
+    return hardPuff ? PRESS_SAP_MAIN_STATE_HARD_PUFF : PRESS_SAP_MAIN_STATE_PUFF;
+  }
+  if (PRESS_SAP_ONSET_ENABLED && puffArmed && pressureSlope >= PRESS_SAP_ONSET_SLOPE && prevPressureSlope > 0.0) {
+    _sapTriggerTime = (currentTime - _puffArmTime > PRESS_SAP_ONSET_MAX_LEAD) ? currentTime - PRESS_SAP_ONSET_MAX_LEAD : _puffArmTime;
+    return PRESS_SAP_MAIN_STATE_PUFF;
+  }
+  
+  // Sip detected by threshold, or by a sustained steep fall past the arming level
+  if (pressureValue < -1 * _sipThreshold) {
+    return hardSip ? PRESS_SAP_MAIN_STATE_HARD_SIP : PRESS_SAP_MAIN_STATE_SIP;
+  }
+  if (PRESS_SAP_ONSET_ENABLED && sipArmed && pressureSlope <= -1 * PRESS_SAP_ONSET_SLOPE && prevPressureSlope < 0.0) {
+    _sapTriggerTime = (currentTime - _sipArmTime > PRESS_SAP_ONSET_MAX_LEAD) ? currentTime - PRESS_SAP_ONSET_MAX_LEAD : _sipArmTime;
+    return PRESS_SAP_MAIN_STATE_SIP;
+  }
+
+  return PRESS_SAP_MAIN_STATE_NONE;  // Neither sip nor puff detected
+}
+
+//*********************************//
+// Function   : isPuffState 
+// 
+// Description: Check if a sip and puff main state is a soft or hard puff
+//
+// Arguments :  mainState : int : Sip and puff main state
+// 
+// Return     : isPuff : bool : True for PRESS_SAP_MAIN_STATE_PUFF and PRESS_SAP_MAIN_STATE_HARD_PUFF
+//*********************************//
+bool LSPressure::isPuffState(int mainState)
+{
+  return (mainState == PRESS_SAP_MAIN_STATE_PUFF || mainState == PRESS_SAP_MAIN_STATE_HARD_PUFF);
+}
+
+//*********************************//
+// Function   : isSipState 
+// 
+// Description: Check if a sip and puff main state is a soft or hard sip
+//
+// Arguments :  mainState : int : Sip and puff main state
+// 
+// Return     : isSip : bool : True for PRESS_SAP_MAIN_STATE_SIP and PRESS_SAP_MAIN_STATE_HARD_SIP
+//*********************************//
+bool LSPressure::isSipState(int mainState)
+{
+  return (mainState == PRESS_SAP_MAIN_STATE_SIP || mainState == PRESS_SAP_MAIN_STATE_HARD_SIP);
 }
 
 //*********************************//
@@ -592,6 +994,33 @@ float LSPressure::getSapPressure()
 }
 
 
+//*********************************//
+// Function   : getProportionalOutput 
+// 
+// Description: Map the latest pressure difference to a proportional output. Pressure within the deadband gives zero,
+//              and PRESS_OUTPUT_FULL_SCALE_FACTOR times the sip or puff threshold gives full output.
+//              The normalized magnitude is raised to the power of curve (1.0 = linear, >1.0 = finer control at low pressure).
+//
+// Arguments :  deadband : float : Pressure magnitude (hPa) below which the output is zero
+//              curve : float : Exponent of the output curve
+// 
+// Return     : output : float : Proportional output from -1.0 (full sip) to 1.0 (full puff)
+//*********************************//
+float LSPressure::getProportionalOutput(float deadband, float curve)
+{
+  float pressureValue = getSapPressure();
+  float fullScale = PRESS_OUTPUT_FULL_SCALE_FACTOR * ((pressureValue > 0.0) ? _puffThreshold : _sipThreshold);
+
+  if (fabs(pressureValue) <= deadband || fullScale <= deadband) {
+    return 0.0;
+  }
+
+  float output = constrain((fabs(pressureValue) - deadband) / (fullScale - deadband), 0.0, 1.0);
+  output = pow(output, curve);
+
+  return (pressureValue > 0.0) ? output : -1 * output;
+}
+
 //*********************************//
 // Function   : getAllPressureure 
 // 
@@ -619,5 +1048,45 @@ inputStateStruct LSPressure::getState()
   return _sapBuffer.getLastElement();
 }
 
+//*********************************//
+// Function   : getOnsetTime 
+// 
+// Description: Get the time the current or last sip or puff started, as found by onset detection
+// Arguments :  void
+// 
+// Return     : onsetTime : unsigned long : Onset time in millis()
+//*********************************//
+unsigned long LSPressure::getOnsetTime()
+{
+  return _sapOnsetTime;
+}
+
+//*********************************//
+// Function   : getEventTime 
+// 
+// Description: Get the time of the latest sip and puff state, the onset time of a sip or puff that just started
+// Arguments :  void
+// 
+// Return     : eventTime : unsigned long : Event time in millis()
+//*********************************//
+unsigned long LSPressure::getEventTime()
+{
+  return _sapStateMachine.getEventTime();
+}
+
+//*********************************//
+// Function   : canEscalate 
+// 
+// Description: Check if a started sip or puff can still become a hard sip or hard puff
+// Arguments :  mainState : int : Sip and puff main state
+// 
+// Return     : canEscalate : bool : True for a soft sip or puff when the matching hard threshold is enabled
+//*********************************//
+bool LSPressure::canEscalate(int mainState)
+{
+  return ((mainState == PRESS_SAP_MAIN_STATE_PUFF && _hardPuffThreshold > _puffThreshold) ||
+          (mainState == PRESS_SAP_MAIN_STATE_SIP && _hardSipThreshold > _sipThreshold));
+}
+
 
 #endif 
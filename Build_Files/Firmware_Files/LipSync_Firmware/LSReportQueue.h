@@ -0,0 +1,487 @@
+/*
+* File: LSReportQueue.h
+* Firmware: LipSync
+* Developed by: MakersMakingChange
+* Version: v4.1 (28 March 2025)
+  License: GPL v3.0 or later
+
+  Copyright (C) 2024 - 2025 Neil Squire Society
+  This program is free software: you can redistribute it and/or modify it under the terms of
+  the GNU General Public License as published by the Free Software Foundation,
+  either version 3 of the License, or (at your option) any later version.
+  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License along with this program.
+  If not, see <http://www.gnu.org/licenses/>
+*/
+
+// Header definition
+#ifndef _LSREPORTQUEUE_H
+#define _LSREPORTQUEUE_H
+
+// The report queue has no Arduino dependencies. Reports are pushed by the main loop and
+// popped by the sender, which may run in the USB task : only the producer moves the tail
+// and only the consumer moves the head.
+#include <stdint.h>
+#include <string.h>
+
+#define REPORT_QUEUE_SIZE 8                   // Maximum number of pending reports ( power of 2 )
+#define REPORT_QUEUE_RESERVED 2               // Reports kept free for button transitions, motion only reports can't use them
+#define REPORT_MAX_LENGTH 8                   // Largest report : keyboard report
+
+// Mouse report : buttons, x, y, wheel, pan
+#define REPORT_MOUSE_LENGTH 5                 // 8-bit x and y
+#define REPORT_MOUSE_HIGH_RES_LENGTH 7        // 16-bit x and y
+#define REPORT_MOUSE_MOTION_NUMBER 4
+#define REPORT_POINTER_LENGTH 7               // 16-bit absolute x and y, same layout as the 16-bit mouse report
+
+// Byte offset and saturation of the x, y, wheel and pan fields of each mouse report format
+static const uint8_t reportMouseOffset[2][REPORT_MOUSE_MOTION_NUMBER] = { { 1, 2, 3, 4 }, { 1, 3, 5, 6 } };
+static const long reportMouseMax[2][REPORT_MOUSE_MOTION_NUMBER] = { { 127, 127, 127, 127 }, { 32767, 32767, 127, 127 } };
+
+// HID report structure
+typedef struct {
+  uint8_t reportId;
+  uint8_t length;
+  uint8_t data[REPORT_MAX_LENGTH];
+} hidReportStruct;
+
+class LSReportQueue {
+  private:
+    hidReportStruct _report[REPORT_QUEUE_SIZE];
+    volatile uint8_t _head;                   // Free running index of the oldest report
+    volatile uint8_t _tail;                   // Free running index of the next free report
+    volatile unsigned long _droppedCount;
+    uint8_t _pointerButtons;                  // Buttons of the last pointer report
+    bool _pointerTransition;                  // true if the last pointer report changed the buttons
+    uint8_t _mouseButtons;                    // Buttons of the last mouse report queued
+    long _mouseMotion[REPORT_MOUSE_MOTION_NUMBER];  // Mouse motion left over while the queue was full
+    uint8_t _mouseReportId;                   // Report id and format of the motion left over
+    bool _mouseHighResolution;
+    bool pushReport(uint8_t reportId, const void* data, uint8_t length, bool transition);
+    static long getMotion(const uint8_t* data, int format, int motionIndex);
+    static void setMotion(uint8_t* data, int format, int motionIndex, long value);
+  public:
+    LSReportQueue();
+    void clear();
+    bool push(uint8_t reportId, const void* data, uint8_t length);
+    bool pushMouse(uint8_t reportId, bool highResolution, uint8_t buttons, long x, long y, long wheel, long pan, bool coalesce);
+    bool pushPointer(uint8_t reportId, uint8_t buttons, long x, long y, long wheel, long pan, bool coalesce);
+    bool pushState(uint8_t reportId, const void* data, uint8_t length, bool coalesce);
+    bool hasPendingMotion();
+    bool flushMouse(bool coalesce);
+    hidReportStruct* peek();
+    void pop();
+    bool isEmpty();
+    int getCount();
+    unsigned long getDroppedCount();
+};
+
+//*********************************//
+// Function   : LSReportQueue
+//
+// Description: Construct LSReportQueue
+//
+// Arguments :  void
+//
+// Return     : void
+//*********************************//
+LSReportQueue::LSReportQueue() {
+  clear();
+  _droppedCount = 0;
+  _pointerButtons = 0;
+  _pointerTransition = false;
+  _mouseButtons = 0;
+  _mouseReportId = 0;
+  _mouseHighResolution = false;
+}
+
+//*********************************//
+// Function   : clear
+//
+// Description: Remove all pending reports and the motion left over. Only call it when the sender is not running.
+//
+// Arguments :  void
+//
+// Return     : void
+//*********************************//
+void LSReportQueue::clear() {
+  _head = _tail;
+  memset(_mouseMotion, 0, sizeof(_mouseMotion));
+}
+
+//*********************************//
+// Function   : push
+//
+// Description: Add a report after the pending reports. The report is handled as a transition, such as a
+//              keyboard report, and can use the reports kept free for button transitions.
+//
+// Arguments :  reportId : uint8_t : HID report id, 0 if the interface has no report ids
+//              data : const void* : Report data
+//              length : uint8_t : Report length, up to REPORT_MAX_LENGTH
+//
+// Return     : bool : false if the queue is full or the report is too long and the report was dropped
+//*********************************//
+bool LSReportQueue::push(uint8_t reportId, const void* data, uint8_t length) {
+  return pushReport(reportId, data, length, true);
+}
+
+//*********************************//
+// Function   : pushReport
+//
+// Description: Add a report after the pending reports. Reports that don't change the buttons leave
+//              REPORT_QUEUE_RESERVED reports free, so a full queue of motion never drops a button transition.
+//
+// Arguments :  reportId : uint8_t : HID report id, 0 if the interface has no report ids
+//              data : const void* : Report data
+//              length : uint8_t : Report length, up to REPORT_MAX_LENGTH
+//              transition : bool : true if the report changes the buttons
+//
+// Return     : bool : false if the queue is full or the report is too long and the report was dropped
+//*********************************//
+bool LSReportQueue::pushReport(uint8_t reportId, const void* data, uint8_t length, bool transition) {
+  int queueLimit = transition ? REPORT_QUEUE_SIZE : REPORT_QUEUE_SIZE - REPORT_QUEUE_RESERVED;
+  if (getCount() >= queueLimit || length > REPORT_MAX_LENGTH) {
+    _droppedCount++;
+    return false;
+  }
+  hidReportStruct* report = &_report[_tail % REPORT_QUEUE_SIZE];
+  report->reportId = reportId;
+  report->length = length;
+  memcpy(report->data, data, length);
+  _tail++;  // Publish the report once it is written
+  return true;
+}
+
+//*********************************//
+// Function   : pushMouse
+//
+// Description: Add a mouse report. The motion is added to the last pending report if it is a mouse report
+//              with the same buttons that already moves, so button transitions stay in order and the motion of reports
+//              waiting for the host is not lost. Motion beyond the saturation of a report is split into new reports.
+//              Only a report that changes the buttons can use the reports kept free for button transitions.
+//              Motion that finds the queue full is kept and added to the next report, see flushMouse.
+//
+// Arguments :  reportId : uint8_t : HID report id of the mouse report
+//              highResolution : bool : true for the report with 16-bit x and y
+//              buttons : uint8_t : Pressed buttons
+//              x : long : Cursor x motion
+//              y : long : Cursor y motion
+//              wheel : long : Vertical wheel motion
+//              pan : long : Horizontal wheel motion
+//              coalesce : bool : false if the last pending report may be being sent and can't be changed
+//
+// Return     : bool : false if the queue is full and a button transition was dropped
+//*********************************//
+bool LSReportQueue::pushMouse(uint8_t reportId, bool highResolution, uint8_t buttons, long x, long y, long wheel, long pan, bool coalesce) {
+  int format = highResolution ? 1 : 0;
+  uint8_t length = highResolution ? REPORT_MOUSE_HIGH_RES_LENGTH : REPORT_MOUSE_LENGTH;
+  long motion[REPORT_MOUSE_MOTION_NUMBER] = { x, y, wheel, pan };
+  bool hasMotion = false;
+  bool transition = (buttons != _mouseButtons);
+
+  // Motion left over for the same report goes first
+  bool sameReport = (reportId == _mouseReportId && highResolution == _mouseHighResolution);
+  for (int motionIndex = 0; motionIndex < REPORT_MOUSE_MOTION_NUMBER; motionIndex++) {
+    motion[motionIndex] += sameReport ? _mouseMotion[motionIndex] : 0;
+    _mouseMotion[motionIndex] = 0;
+    hasMotion = hasMotion || (motion[motionIndex] != 0);
+  }
+
+  if (coalesce && !isEmpty()) {
+    hidReportStruct* last = &_report[(uint8_t)(_tail - 1) % REPORT_QUEUE_SIZE];
+    if (last->reportId == reportId && last->length == length && last->data[0] == buttons) {
+      bool lastHasMotion = false;
+      for (int motionIndex = 0; motionIndex < REPORT_MOUSE_MOTION_NUMBER; motionIndex++) {
+        lastHasMotion = lastHasMotion || (getMotion(last->data, format, motionIndex) != 0);
+      }
+      if (lastHasMotion || !hasMotion) {  // A button transition report is sent without motion
+        hasMotion = false;
+        for (int motionIndex = 0; motionIndex < REPORT_MOUSE_MOTION_NUMBER; motionIndex++) {
+          long motionMax = reportMouseMax[format][motionIndex];
+          long sum = getMotion(last->data, format, motionIndex) + motion[motionIndex];
+          long value = (sum > motionMax) ? motionMax : ((sum < -motionMax) ? -motionMax : sum);
+          setMotion(last->data, format, motionIndex, value);
+          motion[motionIndex] = sum - value;
+          hasMotion = hasMotion || (motion[motionIndex] != 0);
+        }
+        if (!hasMotion) {
+          return true;
+        }
+      }
+    }
+  }
+
+  // New report, split while the motion is saturated
+  do {
+    if (getCount() >= (transition ? REPORT_QUEUE_SIZE : REPORT_QUEUE_SIZE - REPORT_QUEUE_RESERVED)) {
+      // Keep the motion that didn't fit for the next report, only a button transition is lost
+      memcpy(_mouseMotion, motion, sizeof(_mouseMotion));
+      _mouseReportId = reportId;
+      _mouseHighResolution = highResolution;
+      if (transition) {
+        _droppedCount++;
+      }
+      return !transition;
+    }
+    uint8_t data[REPORT_MAX_LENGTH];
+    data[0] = buttons;
+    hasMotion = false;
+    for (int motionIndex = 0; motionIndex < REPORT_MOUSE_MOTION_NUMBER; motionIndex++) {
+      long motionMax = reportMouseMax[format][motionIndex];
+      long value = (motion[motionIndex] > motionMax) ? motionMax : ((motion[motionIndex] < -motionMax) ? -motionMax : motion[motionIndex]);
+      setMotion(data, format, motionIndex, value);
+      motion[motionIndex] -= value;
+      hasMotion = hasMotion || (motion[motionIndex] != 0);
+    }
+    pushReport(reportId, data, length, transition);
+    _mouseButtons = buttons;
+    transition = false;  // Split reports only carry motion
+  } while (hasMotion);
+  return true;
+}
+
+//*********************************//
+// Function   : pushPointer
+//
+// Description: Add an absolute pointer report. The position replaces the position of the last pending report
+//              if it is a pointer report with the same buttons that did not change the buttons, so clicks stay
+//              at the position they were made at. The wheel motion is added and split like the mouse motion.
+//
+// Arguments :  reportId : uint8_t : HID report id of the pointer report
+//              buttons : uint8_t : Pressed buttons
+//              x : long : Horizontal position from 0 to 32767
+//              y : long : Vertical position from 0 to 32767
+//              wheel : long : Vertical wheel motion
+//              pan : long : Horizontal wheel motion
+//              coalesce : bool : false if the last pending report may be being sent and can't be changed
+//
+// Return     : bool : false if the queue is full and the report was dropped
+//*********************************//
+bool LSReportQueue::pushPointer(uint8_t reportId, uint8_t buttons, long x, long y, long wheel, long pan, bool coalesce) {
+  const int format = 1;  // Absolute x and y use the fields of the 16-bit mouse report
+  long motion[REPORT_MOUSE_MOTION_NUMBER] = { x, y, wheel, pan };
+  bool transition = (buttons != _pointerButtons);
+  bool hasMotion;
+  _pointerButtons = buttons;
+
+  if (coalesce && !transition && !_pointerTransition && !isEmpty()) {
+    hidReportStruct* last = &_report[(uint8_t)(_tail - 1) % REPORT_QUEUE_SIZE];
+    if (last->reportId == reportId && last->length == REPORT_POINTER_LENGTH && last->data[0] == buttons) {
+      setMotion(last->data, format, 0, x);
+      setMotion(last->data, format, 1, y);
+      hasMotion = false;
+      for (int motionIndex = 2; motionIndex < REPORT_MOUSE_MOTION_NUMBER; motionIndex++) {
+        long motionMax = reportMouseMax[format][motionIndex];
+        long sum = getMotion(last->data, format, motionIndex) + motion[motionIndex];
+        long value = (sum > motionMax) ? motionMax : ((sum < -motionMax) ? -motionMax : sum);
+        setMotion(last->data, format, motionIndex, value);
+        motion[motionIndex] = sum - value;
+        hasMotion = hasMotion || (motion[motionIndex] != 0);
+      }
+      if (!hasMotion) {
+        return true;
+      }
+    }
+  }
+  _pointerTransition = transition;
+
+  // New report at the same position, split while the wheel motion is saturated
+  do {
+    uint8_t data[REPORT_MAX_LENGTH];
+    data[0] = buttons;
+    setMotion(data, format, 0, x);
+    setMotion(data, format, 1, y);
+    hasMotion = false;
+    for (int motionIndex = 2; motionIndex < REPORT_MOUSE_MOTION_NUMBER; motionIndex++) {
+      long motionMax = reportMouseMax[format][motionIndex];
+      long value = (motion[motionIndex] > motionMax) ? motionMax : ((motion[motionIndex] < -motionMax) ? -motionMax : motion[motionIndex]);
+      setMotion(data, format, motionIndex, value);
+      motion[motionIndex] -= value;
+      hasMotion = hasMotion || (motion[motionIndex] != 0);
+    }
+    if (!pushReport(reportId, data, REPORT_POINTER_LENGTH, transition)) {
+      return false;
+    }
+    transition = false;  // Split reports only carry wheel motion
+  } while (hasMotion);
+  return true;
+}
+
+//*********************************//
+// Function   : pushState
+//
+// Description: Add a report of an absolute device state, such as a gamepad report with the buttons in its first byte.
+//              The last pending report is replaced if it has the same buttons, so only the axes are updated and
+//              no button transition is lost. A report with the same buttons that can't replace it doesn't use
+//              the reports kept free for button transitions.
+//
+// Arguments :  reportId : uint8_t : HID report id
+//              data : const void* : Report data, starting with the buttons
+//              length : uint8_t : Report length, up to REPORT_MAX_LENGTH
+//              coalesce : bool : false if the last pending report may be being sent and can't be changed
+//
+// Return     : bool : false if the queue is full or the report is too long and the report was dropped
+//*********************************//
+bool LSReportQueue::pushState(uint8_t reportId, const void* data, uint8_t length, bool coalesce) {
+  bool transition = true;
+  if (!isEmpty() && length > 0 && length <= REPORT_MAX_LENGTH) {
+    hidReportStruct* last = &_report[(uint8_t)(_tail - 1) % REPORT_QUEUE_SIZE];
+    if (last->reportId == reportId && last->length == length && last->data[0] == ((const uint8_t*)data)[0]) {
+      if (coalesce) {
+        memcpy(last->data, data, length);
+        return true;
+      }
+      transition = false;
+    }
+  }
+  return pushReport(reportId, data, length, transition);
+}
+
+//*********************************//
+// Function   : hasPendingMotion
+//
+// Description: Check if mouse motion was left over while the queue was full.
+//
+// Arguments :  void
+//
+// Return     : bool : true if motion waits for a free report
+//*********************************//
+bool LSReportQueue::hasPendingMotion() {
+  for (int motionIndex = 0; motionIndex < REPORT_MOUSE_MOTION_NUMBER; motionIndex++) {
+    if (_mouseMotion[motionIndex] != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+//*********************************//
+// Function   : flushMouse
+//
+// Description: Add the mouse motion left over while the queue was full, with the buttons of the last mouse report.
+//              Call it once reports were sent, so the motion moves on even if no new motion follows.
+//
+// Arguments :  coalesce : bool : false if the last pending report may be being sent and can't be changed
+//
+// Return     : bool : false if the queue is still full
+//*********************************//
+bool LSReportQueue::flushMouse(bool coalesce) {
+  if (!hasPendingMotion()) {
+    return true;
+  }
+  pushMouse(_mouseReportId, _mouseHighResolution, _mouseButtons, 0, 0, 0, 0, coalesce);
+  return !hasPendingMotion();
+}
+
+//*********************************//
+// Function   : peek
+//
+// Description: Get the oldest report without removing it.
+//
+// Arguments :  void
+//
+// Return     : hidReportStruct* : Oldest report, NULL if no report is pending
+//*********************************//
+hidReportStruct* LSReportQueue::peek() {
+  if (isEmpty()) {
+    return NULL;
+  }
+  return &_report[_head % REPORT_QUEUE_SIZE];
+}
+
+//*********************************//
+// Function   : pop
+//
+// Description: Remove the oldest report once it was sent.
+//
+// Arguments :  void
+//
+// Return     : void
+//*********************************//
+void LSReportQueue::pop() {
+  if (!isEmpty()) {
+    _head++;
+  }
+}
+
+//*********************************//
+// Function   : isEmpty
+//
+// Description: Check if no report is pending.
+//
+// Arguments :  void
+//
+// Return     : bool : true if no report is pending
+//*********************************//
+bool LSReportQueue::isEmpty() {
+  return _head == _tail;
+}
+
+//*********************************//
+// Function   : getCount
+//
+// Description: Get the number of pending reports.
+//
+// Arguments :  void
+//
+// Return     : int : Number of pending reports
+//*********************************//
+int LSReportQueue::getCount() {
+  return (uint8_t)(_tail - _head);
+}
+
+//*********************************//
+// Function   : getDroppedCount
+//
+// Description: Get the number of reports dropped because the queue was full.
+//
+// Arguments :  void
+//
+// Return     : unsigned long : Number of dropped reports
+//*********************************//
+unsigned long LSReportQueue::getDroppedCount() {
+  return _droppedCount;
+}
+
+//*********************************//
+// Function   : getMotion
+//
+// Description: Read a motion field of a mouse report.
+//
+// Arguments :  data : const uint8_t* : Mouse report data
+//              format : int : 0 for 8-bit x and y, 1 for 16-bit x and y
+//              motionIndex : int : 0 = x, 1 = y, 2 = wheel, 3 = pan
+//
+// Return     : long : Motion value
+//*********************************//
+long LSReportQueue::getMotion(const uint8_t* data, int format, int motionIndex) {
+  const uint8_t* field = data + reportMouseOffset[format][motionIndex];
+  if (reportMouseMax[format][motionIndex] > 127) {
+    return (int16_t)(field[0] | (field[1] << 8));  // Little endian
+  }
+  return (int8_t)field[0];
+}
+
+//*********************************//
+// Function   : setMotion
+//
+// Description: Write a motion field of a mouse report.
+//
+// Arguments :  data : uint8_t* : Mouse report data
+//              format : int : 0 for 8-bit x and y, 1 for 16-bit x and y
+//              motionIndex : int : 0 = x, 1 = y, 2 = wheel, 3 = pan
+//              value : long : Motion value within the saturation of the field
+//
+// Return     : void
+//*********************************//
+void LSReportQueue::setMotion(uint8_t* data, int format, int motionIndex, long value) {
+  uint8_t* field = data + reportMouseOffset[format][motionIndex];
+  field[0] = (uint8_t)(value & 0xFF);
+  if (reportMouseMax[format][motionIndex] > 127) {
+    field[1] = (uint8_t)((value >> 8) & 0xFF);
+  }
+}
+
+#endif
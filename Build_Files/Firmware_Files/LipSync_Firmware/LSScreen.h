@@ -58,12 +58,15 @@
 #define FACTORY_RESET_PAGE 57
 #define FACTORY_RESET_CONFIRM2_PAGE 571
 #define INFO_MENU 58
+#define BLUETOOTH_MENU 59
 
 #define SCROLL_DELAY_MILLIS 100 // [ms] This controls the scroll speed of long menu items //TODO 2025-Feb-28 Make this user adjustable
 
 #define _MODE_MOUSE_USB 1
 #define _MODE_MOUSE_BT 2
 #define _MODE_GAMEPAD_USB 3
+#define _MODE_GAMEPAD_BT 4
+#define _MODE_ABSOLUTE_USB 5
 
 const int CHAR_PIXEL_HEIGHT_S1 = 8;    // The height of a character on the screen, in pixels, for size 1 text
 const int CHAR_PIXEL_WIDTH_S1 = 6;     // The width of a character on the screen, in pixels, for size 1 text
@@ -110,7 +113,7 @@ public:
   void errorPageI2C();
   void errorPageCable();
   void warningUSBDebugOn();
-  void connectionTimingPage(unsigned long, unsigned long);
+  void connectionTimingPage(unsigned long, unsigned long, unsigned long, unsigned long);
   void restartPage();
   void safeModePage(int);
   void safeModeMenu();
@@ -202,13 +205,14 @@ private:
   String _mainMenuText[5] = { "Exit Menu", "Center Reset", "Mode", "Cursor Speed", "More" };
   String _exitConfirmText[4] = { "Exit", "settings?", "Confirm", "... Back" };
   String _calibMenuText[4] = { "Center Reset", "... Back", " ", " " };
-  String _modeMenuText[4] = { "MOUSE USB", "MOUSE BT", "GAMEPAD ", "... Back" };
+  String _modeMenuText[6] = { "MOUSE USB", "MOUSE BT", "GAMEPAD ", "GAMEPAD BT", "ABSOLUTE ", "... Back" };
   String _modeConfirmText[4] = { "Change", "mode?", "Confirm", "... Back" };
   String _cursorSpMenuText[4] = { "Speed: ", "Increase", "Decrease", "... Back" };
-  String _moreMenuText[9] = { "Sound",  "Light Brightness", "Scroll Speed",   "Sip & Puff",  "Full Calibration",   "Restart LipSync",  "Factory Reset",  "Info", "... Back",  };
+  String _moreMenuText[10] = { "Sound",  "Light Brightness", "Scroll Speed",   "Sip & Puff",  "Full Calibration",   "Restart LipSync",  "Factory Reset",  "Bluetooth Host", "Info", "... Back",  };
   String _soundMenuText[4] = { "Sound:", "<>", "Turn <>", "... Back" };
   String _lightBrightMenuText[4] = { "Lights: ", "Increase", "Decrease", "... Back" };
   String _scrollSpMenuText[4] = { "Speed: ", "Increase", "Decrease", "... Back" };
+  String _bluetoothMenuText[4] = { "Host: ", "Next Host", "Forget", "... Back" };
   String _sipPuffThreshMenuText[4] = { "Sip Threshold", "Puff Threshold", "... Back" };
   String _adjustSipThreshMenuText[4] = { "Sip: ", "Increase", "Decrease", "... Back" };
   String _adjustPuffThreshMenuText[4] = { "Puff: ", "Increase", "Decrease", "... Back" };
@@ -223,12 +227,13 @@ private:
   const int _mainMenuLen = 5;
   const int _exitConfirmLen = 2;
   const int _calibMenuLen = 2;
-  const int _modeMenuLen = 4;
+  const int _modeMenuLen = 6;
   const int _cursorSpMenuLen = 3;
-  const int _moreMenuLen = 9;
+  const int _moreMenuLen = 10;
   const int _soundMenuLen = 2;
   const int _lightBrightMenuLen = 3;
   const int _scrollSpMenuLen = 3;
+  const int _bluetoothMenuLen = 3;
   const int _sipPuffThreshMenuLen = 3;
   const int _adjustSipThreshMenuLen = 3;
   const int _adjustPuffThreshMenuLen = 3;
@@ -424,14 +429,24 @@ void LSScreen::splashScreen2() {
       }
       break;
     case CONF_OPERATING_MODE_GAMEPAD:
-      _display.setCursor(1, 48);
-      _display.print("USB");
-      _display.setTextSize(1);
-      _display.print(" ");
-      _display.setTextSize(2);
-      _display.print("Gamepad");  // text size changed for space so it would all fit on one line
-      //_display.print("USB"); _display.setTextSize(1); _display.print(" "); _display.setTextSize(2); _display.print("Gamepad"); // text size changed for space so it would all fit on one line
-      //drawCentreString("Gamepad", 48);
+      switch (_communicationMode) {
+        case CONF_COM_MODE_USB:
+          _display.setCursor(1, 48);
+          _display.print("USB");
+          _display.setTextSize(1);
+          _display.print(" ");
+          _display.setTextSize(2);
+          _display.print("Gamepad");  // text size changed for space so it would all fit on one line
+          //_display.print("USB"); _display.setTextSize(1); _display.print(" "); _display.setTextSize(2); _display.print("Gamepad"); // text size changed for space so it would all fit on one line
+          //drawCentreString("Gamepad", 48);
+          break;
+        case CONF_COM_MODE_BLE:
+          drawCentreString("BT Gamepad", 48);
+          break;
+      }
+      break;
+    case CONF_OPERATING_MODE_ABSOLUTE:
+      drawCentreString("Absolute", 48);
       break;
     case CONF_OPERATING_MODE_SAFE:
       // Currently bypassed since safe mode menus are called directly
@@ -568,6 +583,14 @@ void LSScreen::selectMenuItem() {
             _tempOperatingMode = CONF_OPERATING_MODE_GAMEPAD;
             _tempCommunicationMode = CONF_COM_MODE_USB;
             break;
+          case _MODE_GAMEPAD_BT:
+            _tempOperatingMode = CONF_OPERATING_MODE_GAMEPAD;
+            _tempCommunicationMode = CONF_COM_MODE_BLE;
+            break;
+          case _MODE_ABSOLUTE_USB:
+            _tempOperatingMode = CONF_OPERATING_MODE_ABSOLUTE;
+            _tempCommunicationMode = CONF_COM_MODE_USB;
+            break;
         }
         //_tempOperatingMode = _currentSelection;
         if ((_tempOperatingMode != _operatingMode) || (_tempCommunicationMode != _communicationMode)) {
@@ -634,10 +657,13 @@ void LSScreen::selectMenuItem() {
         case 6: // Factory Reset
           factoryResetConfirm1Page();
           break;
-        case 7: // Info
+        case 7: // Bluetooth host
+          bluetoothMenu();
+          break;
+        case 8: // Info
           infoMenu();
           break;
-        case 8: // Back
+        case 9: // Back
           mainMenu();
           break;
       }
@@ -862,6 +888,25 @@ void LSScreen::selectMenuItem() {
           break;
       }
       break;
+    case BLUETOOTH_MENU:
+      switch (_currentSelection) {
+        case 0:  // Next host
+          nextBluetoothHost(true, false);
+          _bluetoothMenuText[0] = "Host: " + String(blehosts.getSlot() + 1) + " ";
+          _display.setCursor(0, 0);
+          _display.print(_bluetoothMenuText[0]);
+          _display.display();
+          break;
+        case 1:  // Forget the host of the slot, a new host pairs in it
+          forgetBluetoothHost(true, false, blehosts.getSlot());
+          break;
+        case 2:  // Back
+          _currentMenu = MORE_MENU;
+          moreMenu();
+          break;
+      }
+      break;
+
     case INFO_MENU:
       switch(_currentSelection) {
         case 0: // Back
@@ -1143,29 +1188,34 @@ void LSScreen::modeMenu(void) {
 //*********************************//
 void LSScreen::modeMenuHighlight() {
 
-  _display.setTextColor(SSD1306_BLACK, SSD1306_WHITE);  // Draw 'inverse' coloured text
+  int currentMode = 0;
 
   switch (_operatingMode) {
     case CONF_OPERATING_MODE_MOUSE:
       switch (_communicationMode) {
         case CONF_COM_MODE_USB:
-          _display.setCursor(12, 0);
-          _display.print(_modeMenuText[_MODE_MOUSE_USB - 1]);
+          currentMode = _MODE_MOUSE_USB;
           break;
         case CONF_COM_MODE_BLE:
-          _display.setCursor(12, 16);
-          //display.print(" MOUSE BLUETOOTH ");
-          _display.print(_modeMenuText[_MODE_MOUSE_BT - 1]);
+          currentMode = _MODE_MOUSE_BT;
           break;
       }
       break;
     case CONF_OPERATING_MODE_GAMEPAD:
-      _display.setCursor(12, 16 * 2);
-      //display.print(" GAMEPAD ");
-      _display.print(_modeMenuText[_MODE_GAMEPAD_USB - 1]);
+      currentMode = (_communicationMode == CONF_COM_MODE_BLE) ? _MODE_GAMEPAD_BT : _MODE_GAMEPAD_USB;
+      break;
+    case CONF_OPERATING_MODE_ABSOLUTE:
+      currentMode = _MODE_ABSOLUTE_USB;
       break;
   }
 
+  int currentRow = currentMode - 1 - _countMenuScroll;  // The menu scrolls once the selection passes the last row
+  if (currentMode > 0 && currentRow >= 0 && currentRow < TEXT_ROWS) {
+    _display.setTextColor(SSD1306_BLACK, SSD1306_WHITE);  // Draw 'inverse' coloured text
+    _display.setCursor(12, 16 * currentRow);
+    _display.print(_modeMenuText[currentMode - 1]);
+  }
+
   _display.display();
   _display.setTextColor(SSD1306_WHITE, SSD1306_BLACK);  // Reset text colour to white on black
 }
@@ -1208,6 +1258,16 @@ void LSScreen::changeMode() {
   _display.display();
   delay(2000);
 
+  // USB modes share one HID interface and change without a reset
+  bool resetNeeded = (_communicationMode != _tempCommunicationMode)
+                     || !isUsbOperatingMode(_operatingMode) || !isUsbOperatingMode(_tempOperatingMode);
+
+  // The absolute pointer is USB only, so the operating mode is changed first when changing to Bluetooth
+  if (_tempCommunicationMode == CONF_COM_MODE_BLE && _operatingMode != _tempOperatingMode) {
+    _operatingMode = _tempOperatingMode;
+    setOperatingMode(false, false, _tempOperatingMode);  // Sets new operating mode and saves in memory
+  }
+
   if (_communicationMode != _tempCommunicationMode) {
     _communicationMode = _tempCommunicationMode;
     setCommunicationMode(false, false, _tempCommunicationMode);  // Sets new communication mode, saves in memory
@@ -1215,10 +1275,12 @@ void LSScreen::changeMode() {
 
   if (_operatingMode != _tempOperatingMode) {
     _operatingMode = _tempOperatingMode;
-    setOperatingMode(false, false, _tempOperatingMode);  // Sets new operating mode, saves in memory, and conducts software reset
+    setOperatingMode(false, false, _tempOperatingMode);  // Sets new operating mode and saves in memory
   }
 
-  softwareReset();  // TODO: is there a way to avoid software reset if just changing com mode?
+  if (resetNeeded) {
+    softwareReset();  // TODO: is there a way to avoid software reset if just changing com mode?
+  }
 
   _currentMenu = MAIN_MENU;
   mainMenu();
@@ -1272,6 +1334,29 @@ void LSScreen::scrollSpeedMenu(void) {
   displayMenu();
 }
 
+//*********************************//
+// Function   : bluetoothMenu
+//
+// Description: Format and display Bluetooth Host Menu
+//
+// Arguments :  void
+//
+// Return     : void
+//*********************************//
+void LSScreen::bluetoothMenu(void) {
+  _currentMenu = BLUETOOTH_MENU;
+
+  _bluetoothMenuText[0] = "Host: " + String(blehosts.getSlot() + 1);
+
+  _currentMenuLength = _bluetoothMenuLen;
+  _currentMenuText = _bluetoothMenuText;
+  _cursorStart = 1;
+  _currentSelection = 0;
+  _countMenuScroll = 0;
+
+  displayMenu();  //  Print items in current menu
+}
+
 //*********************************//
 // Function   : moreMenu
 //
@@ -1711,7 +1796,17 @@ void LSScreen::testPage(unsigned int usbConnectDelay) {
       }
       break;
     case CONF_OPERATING_MODE_GAMEPAD:
-      _display.println("Gamepad");
+      switch (_communicationMode) {
+        case CONF_COM_MODE_USB:
+          _display.println("Gamepad");
+          break;
+        case CONF_COM_MODE_BLE:
+          _display.println("BT Gamepad");
+          break;
+      }
+      break;
+    case CONF_OPERATING_MODE_ABSOLUTE:
+      _display.println("Absolute");
       break;
     default:
       _display.println("Error");
@@ -1916,25 +2011,31 @@ void LSScreen::factoryResetPage() {
 //
 // Description: Format and display an page showing the timestamps related to connecting to USB
 //
-// Arguments :  void
+// Arguments :  before : unsigned long : Time before beginComOpMode in ms
+//              after : unsigned long : Time after beginComOpMode in ms
+//              mount : unsigned long : Time the host configured the USB device in ms, 0 if not mounted yet
+//              firstMotion : unsigned long : Time of the first cursor motion in ms, 0 if not moved yet
 //
 // Return     : void
 //*********************************//
 
-void LSScreen::connectionTimingPage(unsigned long before, unsigned long after) {
+void LSScreen::connectionTimingPage(unsigned long before, unsigned long after, unsigned long mount, unsigned long firstMotion) {
   if (USB_DEBUG) { Serial.println("USBDEBUG: LSScreen::connectionTimingPage()"); }
 
   setupDisplay();
   _display.setTextSize(1);
   _display.println("Before beginComOpMode");
-  _display.setTextSize(2);
   _display.println(before);
 
-  _display.setTextSize(1);
   _display.println("After beginComOpMode");
-  _display.setTextSize(2);
   _display.println(after);
 
+  _display.println("USB mount");
+  _display.println(mount);
+
+  _display.println("First cursor motion");
+  _display.println(firstMotion);
+
   _display.display();
 }
 
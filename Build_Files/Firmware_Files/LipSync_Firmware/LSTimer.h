@@ -67,6 +67,7 @@ class LSTimer {
     unsigned long elapsedTime(int timerId);                                       // Time elapsed for specificed timer
     int deleteTimer(int timerId);                                                 // Destroy the specified timer
     void restartTimer(int timerId);                                               // Restart the specified timer
+    void restartTimer(int timerId, unsigned long startTime);                      // Restart the specified timer as if it had been started at startTime (ms)
     boolean isEnabled(int timerId);                                               // Returns true if the specified timer is enabled
     void enable(int timerId);                                                     // Enables the specified timer
     void disable(int timerId);                                                    // Disables the specified timer
@@ -516,6 +517,30 @@ void LSTimer<T>::restartTimer(int timerId) {
 }
 
 
+//*********************************//
+// Function   : restartTimer 
+// 
+// Description: Restart the specified timer using an earlier start time, so the elapsed time
+//              includes the time between startTime and now
+//
+// Arguments :  int : timerId : Index of the timer to restart
+//           :  unsigned long : startTime : Start time of the timer in millis()
+// 
+// Return     : void
+//*********************************//
+template<typename T>
+void LSTimer<T>::restartTimer(int timerId, unsigned long startTime) {
+    if (timerId >= MAX_TIMERS) {
+        Serial.print("ERROR: Invalid Timer ID: ");
+        Serial.println(timerId);
+        return;
+    }
+
+    timer[timerId].previousTime = startTime;
+    timer[timerId].numRuns = 0;
+}
+
+
 //*********************************//
 // Function   : isEnabled 
 // 
@@ -17,23 +17,51 @@
 */
 
 #include "Adafruit_TinyUSB.h"
+#include "LSReportQueue.h"
+#include "LSPointer.h"
 #pragma once
 
 #define ATTRIBUTE_PACKED  __attribute__((packed, aligned(1)))
 
 #define RID_KEYBOARD 1
 #define RID_MOUSE 2
+#define RID_POINTER 3
+#define RID_GAMEPAD 4
   
 #define MOUSE_LEFT 1
 #define MOUSE_RIGHT 2
 #define MOUSE_MIDDLE 4
 #define MOUSE_ALL (MOUSE_LEFT | MOUSE_RIGHT | MOUSE_MIDDLE)
+#define MOUSE_SCROLL_RESOLUTION 120      // Smooth scroll units per wheel detent
 #define MOUSE_DESCRIPTOR "LipSync Mouse" // TODO 2025-Feb-21 Unused due to Tiny USB library hang
 
 #define GAMEPAD_DESCRIPTOR "LipSync Gamepad" // TODO 2025-Feb-21 Unused due to Tiny USB library hang
 
+// USB mount states of the mouse and gamepad
+#define USB_MOUNT_IDLE 0                 // Not started
+#define USB_MOUNT_WAITING 1              // Waiting for the host to configure the device
+#define USB_MOUNT_MOUNTED 2
+#define USB_MOUNT_RETRY_TIMEOUT 200      // ms - Mount timeout of the attempts after the first one
+
 extern unsigned int g_usbAttempt;  // global variable to keep track of USB connection attempts
 extern void usbCheckConnection(void);
+extern void usbMounted(void);      // Called once the host configured the device
+extern void usbMountTimedOut(void);  // Called once the first mount timed out
+
+// Set by the TinyUSB mount callbacks, the device is enumerated in the USB task while setup goes on
+volatile bool usbHidMounted = false;
+volatile unsigned long usbHidMountTime = 0;   // Time the host configured the device
+
+extern "C" void tud_mount_cb(void)
+{
+  usbHidMountTime = millis();
+  usbHidMounted = true;
+}
+
+extern "C" void tud_umount_cb(void)
+{
+  usbHidMounted = false;
+}
 
 
 // https://github.com/hathach/tinyusb/blob/master/examples/device/hid_generic_inout/src/usb_descriptors.c
@@ -46,32 +74,196 @@ uint8_t const mouse_desc_hid_report[] =
     TUD_HID_REPORT_DESC_MOUSE( HID_REPORT_ID(RID_MOUSE) )
 };
 
+// HID report descriptor for the high resolution mouse : 16-bit relative X and Y, and vertical and horizontal wheels
+// with a Resolution Multiplier feature. Once the host sets the multiplier a wheel unit is 1/120 of a detent.
+uint8_t const mouse_high_res_desc_hid_report[] =
+{
+    TUD_HID_REPORT_DESC_KEYBOARD( HID_REPORT_ID(RID_KEYBOARD) ),
+    0x05, 0x01,        // Usage Page (Generic Desktop Ctrls)
+    0x09, 0x02,        // Usage (Mouse)
+    0xA1, 0x01,        // Collection (Application)
+    0x85, RID_MOUSE,   //   Report ID (2)
+    0x09, 0x01,        //   Usage (Pointer)
+    0xA1, 0x00,        //   Collection (Physical)
+    0x05, 0x09,        //     Usage Page (Button)
+    0x19, 0x01,        //     Usage Minimum (0x01)
+    0x29, 0x05,        //     Usage Maximum (0x05)
+    0x15, 0x00,        //     Logical Minimum (0)
+    0x25, 0x01,        //     Logical Maximum (1)
+    0x95, 0x05,        //     Report Count (5)
+    0x75, 0x01,        //     Report Size (1)
+    0x81, 0x02,        //     Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+    0x95, 0x01,        //     Report Count (1)
+    0x75, 0x03,        //     Report Size (3)
+    0x81, 0x01,        //     Input (Const,Array,Abs,No Wrap,Linear,Preferred State,No Null Position)
+    0x05, 0x01,        //     Usage Page (Generic Desktop Ctrls)
+    0x09, 0x30,        //     Usage (X)
+    0x09, 0x31,        //     Usage (Y)
+    0x16, 0x01, 0x80,  //     Logical Minimum (-32767)
+    0x26, 0xFF, 0x7F,  //     Logical Maximum (32767)
+    0x75, 0x10,        //     Report Size (16)
+    0x95, 0x02,        //     Report Count (2)
+    0x81, 0x06,        //     Input (Data,Var,Rel,No Wrap,Linear,Preferred State,No Null Position)
+    0xA1, 0x02,        //     Collection (Logical)
+    0x09, 0x48,        //       Usage (Resolution Multiplier)
+    0x15, 0x00,        //       Logical Minimum (0)
+    0x25, 0x01,        //       Logical Maximum (1)
+    0x35, 0x01,        //       Physical Minimum (1)
+    0x45, 0x78,        //       Physical Maximum (120)
+    0x75, 0x02,        //       Report Size (2)
+    0x95, 0x01,        //       Report Count (1)
+    0xA4,              //       Push
+    0xB1, 0x02,        //       Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+    0x09, 0x38,        //       Usage (Wheel)
+    0x15, 0x81,        //       Logical Minimum (-127)
+    0x25, 0x7F,        //       Logical Maximum (127)
+    0x35, 0x00,        //       Physical Minimum (0)
+    0x45, 0x00,        //       Physical Maximum (0)
+    0x75, 0x08,        //       Report Size (8)
+    0x81, 0x06,        //       Input (Data,Var,Rel,No Wrap,Linear,Preferred State,No Null Position)
+    0xC0,              //     End Collection
+    0xA1, 0x02,        //     Collection (Logical)
+    0xB4,              //       Pop
+    0x09, 0x48,        //       Usage (Resolution Multiplier)
+    0xB1, 0x02,        //       Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+    0x35, 0x00,        //       Physical Minimum (0)
+    0x45, 0x00,        //       Physical Maximum (0)
+    0x75, 0x04,        //       Report Size (4)
+    0xB1, 0x01,        //       Feature (Const,Array,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+    0x05, 0x0C,        //       Usage Page (Consumer)
+    0x0A, 0x38, 0x02,  //       Usage (AC Pan)
+    0x15, 0x81,        //       Logical Minimum (-127)
+    0x25, 0x7F,        //       Logical Maximum (127)
+    0x75, 0x08,        //       Report Size (8)
+    0x81, 0x06,        //       Input (Data,Var,Rel,No Wrap,Linear,Preferred State,No Null Position)
+    0xC0,              //     End Collection
+    0xC0,              //   End Collection
+    0xC0,              // End Collection
+};
+
+// HID report descriptor for the absolute pointer : X and Y are a position on the screen from 0 to 32767,
+// with the same report layout as the high resolution mouse.
+uint8_t const pointer_desc_hid_report[] =
+{
+    0x05, 0x01,        // Usage Page (Generic Desktop Ctrls)
+    0x09, 0x02,        // Usage (Mouse)
+    0xA1, 0x01,        // Collection (Application)
+    0x85, RID_POINTER, //   Report ID (3)
+    0x09, 0x01,        //   Usage (Pointer)
+    0xA1, 0x00,        //   Collection (Physical)
+    0x05, 0x09,        //     Usage Page (Button)
+    0x19, 0x01,        //     Usage Minimum (0x01)
+    0x29, 0x05,        //     Usage Maximum (0x05)
+    0x15, 0x00,        //     Logical Minimum (0)
+    0x25, 0x01,        //     Logical Maximum (1)
+    0x95, 0x05,        //     Report Count (5)
+    0x75, 0x01,        //     Report Size (1)
+    0x81, 0x02,        //     Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+    0x95, 0x01,        //     Report Count (1)
+    0x75, 0x03,        //     Report Size (3)
+    0x81, 0x01,        //     Input (Const,Array,Abs,No Wrap,Linear,Preferred State,No Null Position)
+    0x05, 0x01,        //     Usage Page (Generic Desktop Ctrls)
+    0x09, 0x30,        //     Usage (X)
+    0x09, 0x31,        //     Usage (Y)
+    0x15, 0x00,        //     Logical Minimum (0)
+    0x26, 0xFF, 0x7F,  //     Logical Maximum (32767)
+    0x75, 0x10,        //     Report Size (16)
+    0x95, 0x02,        //     Report Count (2)
+    0x81, 0x02,        //     Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+    0x09, 0x38,        //     Usage (Wheel)
+    0x15, 0x81,        //     Logical Minimum (-127)
+    0x25, 0x7F,        //     Logical Maximum (127)
+    0x75, 0x08,        //     Report Size (8)
+    0x95, 0x01,        //     Report Count (1)
+    0x81, 0x06,        //     Input (Data,Var,Rel,No Wrap,Linear,Preferred State,No Null Position)
+    0x05, 0x0C,        //     Usage Page (Consumer)
+    0x0A, 0x38, 0x02,  //     Usage (AC Pan)
+    0x81, 0x06,        //     Input (Data,Var,Rel,No Wrap,Linear,Preferred State,No Null Position)
+    0xC0,              //   End Collection
+    0xC0,              // End Collection
+};
+
+// Resolution Multiplier feature report : bits 0-1 vertical wheel, bits 2-3 horizontal wheel
+#define MOUSE_MULTIPLIER_WHEEL 0x01
+#define MOUSE_MULTIPLIER_PAN 0x04
+
+volatile uint8_t mouseResolutionMultiplier = 0;  // Set by the host, 0 until the host supports high resolution wheels
+
+// The host reads and sets the Resolution Multiplier feature report of the high resolution mouse
+uint16_t mouseGetReport(uint8_t report_id, hid_report_type_t report_type, uint8_t* buffer, uint16_t reqlen)
+{
+  if (report_type != HID_REPORT_TYPE_FEATURE || report_id != RID_MOUSE || reqlen < 1) 
+    return 0;
+  buffer[0] = mouseResolutionMultiplier;
+  return 1;
+}
+
+void mouseSetReport(uint8_t report_id, hid_report_type_t report_type, uint8_t const* buffer, uint16_t bufsize)
+{
+  if (report_type != HID_REPORT_TYPE_FEATURE || report_id != RID_MOUSE || bufsize < 1) 
+    return;
+  if (bufsize > 1 && buffer[0] == RID_MOUSE) {
+    buffer++;   // The report id was left in the buffer
+  }
+  mouseResolutionMultiplier = buffer[0] & (MOUSE_MULTIPLIER_WHEEL | MOUSE_MULTIPLIER_PAN);
+}
+
 
 class LSUSBMouse {
   private:
-    void mouseReport(signed char b, signed char x, signed char y, signed char wheel = 0,signed char pan = 0); 
+    void mouseReport(uint8_t b, long x, long y, long wheel = 0, long pan = 0); 
+    bool queueReport(uint8_t reportId, const void* data, uint8_t length);
+    bool claimQueue(void);
   public:
     inline LSUSBMouse(void);
     inline void begin(void);
     inline void end(void);
 	  inline void wakeup(void);
-    inline void move(signed char x, signed char y);
-    inline void moveAll(signed char x, signed char y, signed char wheel = 0,signed char pan = 0); 
+    inline void setHighResolution(bool highResolution); // Set before begin, the host reads the descriptor when the device mounts
+    inline bool isHighResolution(void);
+    inline void setAbsolute(bool absolute);       // Reports carry a screen position instead of motion
+    inline bool isAbsolute(void);
+    inline void moveTo(long x, long y);           // Absolute position from 0 to POINTER_MAX
+    inline void move(int x, int y);
+    inline void moveAll(int x, int y, signed char wheel = 0,signed char pan = 0); 
     inline void scroll(signed char wheel = 0);
     inline void pan(signed char pan = 0); 
+    inline void smoothScroll(int wheel, int pan = 0);   // Wheel motion in 1/MOUSE_SCROLL_RESOLUTION detents
     inline void click(uint8_t b = MOUSE_LEFT);
     inline void press(uint8_t b = MOUSE_LEFT);     // press LEFT by default
     inline void release(uint8_t b = MOUSE_LEFT);   // release LEFT by default
     inline bool isPressed(uint8_t b = MOUSE_LEFT); // check LEFT by default
+    inline bool keyPress(uint8_t m, uint8_t k);    // Keyboard report on the keyboard report id of the mouse interface
+    inline bool keyRelease(uint8_t k);
+    inline bool keyReleaseAll(void);
 	  inline bool isReady(void);
     inline bool isConnected(void);
+    inline bool isMountPending(void);              // Waiting for the first mount timeout
+    void sendQueuedReport(void);                   // Called from the report complete callback and the main loop
+    void update(void);
+    unsigned long getDroppedCount(void);
     bool usbRetrying = false;
     bool showTestPage = false;
     bool timedOut = false;
   protected:
+    LSReportQueue _reportQueue;
+    volatile bool _reportQueueClaimed = false;     // The queue is being sent by the main loop or the USB task
+    unsigned long _reportTime = 0;                 // Time of the last report sent or of the first report queued
+    bool _started = false;
+    int _mountState = USB_MOUNT_IDLE;
+    unsigned long _mountBeginTime = 0;
+    unsigned long _mountTimeout = CONF_USB_HID_TIMEOUT;
+    void updateMount(void);
+    bool _absolute = false;
+    long _absoluteX = POINTER_MAX / 2;             // Position of the absolute pointer
+    long _absoluteY = POINTER_MAX / 2;
+    int _wheelRemainder = 0;                       // Smooth scroll motion below a detent, for hosts without the multiplier
+    int _panRemainder = 0;
     uint8_t _buttons;
+    uint8_t _keyModifiers;
+    uint8_t _keys[6];
     void buttons(uint8_t b);
-    Adafruit_USBD_HID usb_hid;
+    bool keyboardReport(void);
 };
 
 typedef struct
@@ -107,9 +299,12 @@ typedef struct ATTRIBUTE_PACKED {
     uint8_t buttons;
     uint8_t	xAxis;
     uint8_t	yAxis;
+    uint8_t	zAxis;
 } HID_GamepadReport_Data_t;
 
-// HID report descriptor for XAC Compatible gamepad with 8 buttons and 2 axis joystick 
+// HID report descriptor for XAC Compatible gamepad with 8 buttons and 2 axis joystick
+// The descriptors have no report id, it's added after the collection header when the gamepad is part of the composite interface
+#define GAMEPAD_DESC_HEADER_SIZE 6
 uint8_t const gamepad_desc_hid_report[] =
 {
     0x05, 0x01,        // Usage Page (Generic Desktop Ctrls)
@@ -136,6 +331,89 @@ uint8_t const gamepad_desc_hid_report[] =
     0xC0,              // End Collection
 };
 
+// HID report descriptor for the gamepad with a Z axis (sip and puff pressure output) after the 2 axis joystick
+uint8_t const gamepad_z_desc_hid_report[] =
+{
+    0x05, 0x01,        // Usage Page (Generic Desktop Ctrls)
+    0x09, 0x05,        // Usage (Gamepad)
+    0xA1, 0x01,        // Collection (Application)
+    0x15, 0x00,        //   Logical Minimum (0)
+    0x25, 0x01,        //   Logical Maximum (1)
+    0x35, 0x00,        //   Physical Minimum (0)
+    0x45, 0x01,        //   Physical Maximum (1)
+    0x75, 0x01,        //   Report Size (1)
+    0x95, 0x08,        //   Report Count (8)
+    0x05, 0x09,        //   Usage Page (Button)
+    0x19, 0x01,        //   Usage Minimum (0x01)
+    0x29, 0x08,        //   Usage Maximum (0x08)
+    0x81, 0x02,        //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+    0x05, 0x01,        //   Usage Page (Generic Desktop Ctrls)
+    0x26, 0xFF, 0x00,  //   Logical Maximum (255)
+    0x46, 0xFF, 0x00,  //   Physical Maximum (255)
+    0x09, 0x30,        //   Usage (X)
+    0x09, 0x31,        //   Usage (Y)
+    0x09, 0x32,        //   Usage (Z)
+    0x75, 0x08,        //   Report Size (8)
+    0x95, 0x03,        //   Report Count (3)
+    0x81, 0x02,        //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+    0xC0,              // End Collection
+};
+
+// The mouse, keyboard, absolute pointer and gamepad share one composite HID interface with a report id each.
+// The interface is enumerated once, an operating mode change only changes which reports are sent.
+// Booting in gamepad mode enumerates a standalone gamepad interface without report id as the Xbox Adaptive Controller expects.
+Adafruit_USBD_HID usbHid;
+bool usbHidStarted = false;
+bool usbHidGamepadOnly = false;      // Interface only has the gamepad report without report id
+bool usbHidHighResolution = false;   // Mouse report format of the composite descriptor
+bool usbHidGamepadZAxis = false;     // Gamepad report carries the Z axis of the pressure output
+uint8_t usbHidDescriptor[sizeof(mouse_high_res_desc_hid_report) + sizeof(pointer_desc_hid_report) + sizeof(gamepad_z_desc_hid_report) + 2];
+
+// Build the mouse, pointer and gamepad descriptor with a report id each, returns its length
+uint16_t usbHidCompositeDescriptor(const uint8_t* gamepadDescriptor, uint16_t gamepadLength)
+{
+  uint16_t length = 0;
+  if (usbHidHighResolution) {
+    memcpy(usbHidDescriptor, mouse_high_res_desc_hid_report, sizeof(mouse_high_res_desc_hid_report));
+    length += sizeof(mouse_high_res_desc_hid_report);
+    usbHid.setReportCallback(mouseGetReport, mouseSetReport);
+  } else {
+    memcpy(usbHidDescriptor, mouse_desc_hid_report, sizeof(mouse_desc_hid_report));
+    length += sizeof(mouse_desc_hid_report);
+  }
+  memcpy(usbHidDescriptor + length, pointer_desc_hid_report, sizeof(pointer_desc_hid_report));
+  length += sizeof(pointer_desc_hid_report);
+  memcpy(usbHidDescriptor + length, gamepadDescriptor, GAMEPAD_DESC_HEADER_SIZE);
+  length += GAMEPAD_DESC_HEADER_SIZE;
+  usbHidDescriptor[length++] = 0x85;        //   Report ID
+  usbHidDescriptor[length++] = RID_GAMEPAD;
+  memcpy(usbHidDescriptor + length, gamepadDescriptor + GAMEPAD_DESC_HEADER_SIZE, gamepadLength - GAMEPAD_DESC_HEADER_SIZE);
+  length += gamepadLength - GAMEPAD_DESC_HEADER_SIZE;
+  return length;
+}
+
+// Add the HID interface, the mouse format can't change once the host read the descriptor
+void usbHidBegin(void)
+{
+  if (usbHidStarted) 
+    return;
+  const uint8_t* gamepadDescriptor = usbHidGamepadZAxis ? gamepad_z_desc_hid_report : gamepad_desc_hid_report;
+  uint16_t gamepadLength = usbHidGamepadZAxis ? sizeof(gamepad_z_desc_hid_report) : sizeof(gamepad_desc_hid_report);
+  uint16_t length = 0;
+  if (usbHidGamepadOnly) {
+    memcpy(usbHidDescriptor, gamepadDescriptor, gamepadLength);
+    length = gamepadLength;
+  } else {
+    length = usbHidCompositeDescriptor(gamepadDescriptor, gamepadLength);
+  }
+  mouseResolutionMultiplier = 0;
+  usbHid.setPollInterval(1);
+  usbHid.setReportDescriptor(usbHidDescriptor, length);
+  //usbHid.setStringDescriptor(MOUSE_DESCRIPTOR); // TODO this causes TinyUSB to crash 2025-Jan-20
+  usbHid.begin();
+  usbHidStarted = true;
+}
+
 
 class LSUSBGamepad {
   public:
@@ -144,9 +422,7 @@ class LSUSBGamepad {
     inline void end(void);
 	  inline void wakeup(void);
     inline void send(void);
-    inline bool GamepadReport(void* data, size_t length) {
-        return this->usb_hid.sendReport(0, data, (uint8_t)length);
-    };
+    inline bool GamepadReport(void* data, size_t length);
     inline void write(void);
     inline void write(void *report);
     inline void press(uint8_t b);
@@ -155,14 +431,29 @@ class LSUSBGamepad {
     inline void buttons(uint8_t b);
     inline void xAxis(uint8_t a);
     inline void yAxis(uint8_t a);
+    inline void zAxis(uint8_t a);
     inline void move(uint8_t x,uint8_t y);
+    inline void setZAxis(bool zAxis);             // Set before begin, the host reads the descriptor when the device mounts
+    inline bool hasZAxis(void);
     inline bool isReady(void);
     inline bool isConnected(void);
+    inline bool isMountPending(void);              // Waiting for the first mount timeout
+    void sendQueuedReport(void);                   // Called from the report complete callback and the main loop
+    void update(void);
+    unsigned long getDroppedCount(void);
     bool usbRetrying = false;
   protected:
     HID_GamepadReport_Data_t _report;
-    uint32_t startMillis;
-    Adafruit_USBD_HID usb_hid;
+    LSReportQueue _reportQueue;
+    volatile bool _reportQueueClaimed = false;     // The queue is being sent by the main loop or the USB task
+    unsigned long _reportTime = 0;                 // Time of the last report sent or of the first report queued
+    bool _started = false;
+    int _mountState = USB_MOUNT_IDLE;
+    unsigned long _mountBeginTime = 0;
+    unsigned long _mountTimeout = CONF_USB_HID_TIMEOUT;
+    void updateMount(void);
+    bool claimQueue(void);
+    size_t reportLength(void);                     // The Z axis byte is only sent when the descriptor has it
 };
 
 
@@ -180,48 +471,94 @@ LSUSBMouse::LSUSBMouse(void)
 void LSUSBMouse::begin(void)
 {
   _buttons = 0;
-  this->usb_hid.setPollInterval(1);
-  this->usb_hid.setReportDescriptor(mouse_desc_hid_report, sizeof(mouse_desc_hid_report));
-  //this->usb_hid.setStringDescriptor(MOUSE_DESCRIPTOR); // TODO this causes TinyUSB to crash 2025-Jan-20
-  this->usb_hid.begin();
+  _keyModifiers = 0;
+  memset(_keys, 0, sizeof(_keys));
+  _wheelRemainder = 0;
+  _panRemainder = 0;
+  usbHidBegin();
+  _started = true;
   if (USB_DEBUG) { Serial.println("USBDEBUG: Initializing USB HID Mouse");  }
 
-  unsigned long timerHidTimeoutBegin = millis();
-  unsigned long usbTimeoutMillis;
-
   g_usbAttempt++;
-    
-  if (usbRetrying) {
-    usbTimeoutMillis = 200;                     // when reattemping to connect the USB, uses a smaller value to not freeze up the code for long but will keep retrying 
-  } else {
-    usbTimeoutMillis = CONF_USB_HID_TIMEOUT;    // the first time the usb tried to connect, use the default timeout
-  }
-  
-  while( !USBDevice.mounted() ) { //  Wait for USB device to mount
-    delay(1);
 
-    if ((millis() - timerHidTimeoutBegin) > usbTimeoutMillis) { 
-      usbRetrying = true;
-      break;
-    } 
-  }
+  // The mount is not waited for, update() follows it while the sensors start
+  _mountTimeout = usbRetrying ? USB_MOUNT_RETRY_TIMEOUT : CONF_USB_HID_TIMEOUT;
+  _mountBeginTime = millis();
+  _mountState = USB_MOUNT_WAITING;
+  updateMount();
+}
 
-  if (USBDevice.mounted()) { // If USB device mounts, send blank report
-    usbRetrying = false;
-    g_usbAttempt = 0;
-    move(0,0);
+// If USB device mounts, send blank report
+void LSUSBMouse::updateMount(void)
+{
+  if (_mountState == USB_MOUNT_WAITING) {
+    if (usbHidMounted) {
+      _mountState = USB_MOUNT_MOUNTED;
+      usbRetrying = false;
+      g_usbAttempt = 0;
+      move(0,0);
+      usbMounted();
+    } else if (!usbRetrying && (millis() - _mountBeginTime) > _mountTimeout) {
+      usbRetrying = true;   // usbCheckConnection begins again
+      if (_mountTimeout == CONF_USB_HID_TIMEOUT)
+        usbMountTimedOut();
+    }
+  } else if (_mountState == USB_MOUNT_MOUNTED && !usbHidMounted) {
+    _mountState = USB_MOUNT_WAITING;   // Unplugged, wait for the next mount
+    _mountBeginTime = millis();
   }
-  
 }
 
+bool LSUSBMouse::isMountPending(void)
+{
+  return _mountState == USB_MOUNT_WAITING && !usbRetrying;
+}
+
+
+void LSUSBMouse::setHighResolution(bool highResolution)
+{
+  if (!usbHidStarted) 
+    usbHidHighResolution = highResolution;
+}
+
+bool LSUSBMouse::isHighResolution(void)
+{
+  return usbHidHighResolution;
+}
+
+void LSUSBMouse::setAbsolute(bool absolute)
+{
+  _absolute = absolute;
+}
+
+bool LSUSBMouse::isAbsolute(void)
+{
+  return _absolute;
+}
+
+// Only a change of position is reported
+void LSUSBMouse::moveTo(long x, long y)
+{
+  x = constrain(x, 0, POINTER_MAX);
+  y = constrain(y, 0, POINTER_MAX);
+  if (x != _absoluteX || y != _absoluteY) {
+    _absoluteX = x;
+    _absoluteY = y;
+    mouseReport(_buttons, 0, 0, 0, 0);
+  }
+}
 
 bool LSUSBMouse::isConnected(void) {
-  return this->usb_hid.ready() && !USBDevice.suspended();
+  return usbHid.ready() && !USBDevice.suspended();
 }
 
 
 void LSUSBMouse::end(void)
 {
+  if (claimQueue()) {
+    _reportQueue.clear();
+    _reportQueueClaimed = false;
+  }
 }
 
 void LSUSBMouse::wakeup(void)
@@ -231,32 +568,99 @@ void LSUSBMouse::wakeup(void)
     }
 }
 
-void LSUSBMouse::mouseReport(int8_t b, int8_t x, int8_t y, int8_t wheel, int8_t pan) 
+// Mouse reports are queued and the caller returns immediately.
+// While the interface is busy the motion is combined into the last report that was not sent.
+void LSUSBMouse::mouseReport(uint8_t b, long x, long y, long wheel, long pan) 
 {
-	wakeup();
-  unsigned long timerTimeoutBegin = millis();
-    
-    while(!isReady() && !usbRetrying && !timedOut) {
-      delay(1);
-      if ((millis() - timerTimeoutBegin) > CONF_USB_HID_TIMEOUT){
-        timedOut = true;
-        showTestPage=true;
-        usbCheckConnection();
-        break;
-      }
-    }
-    if (isReady()){
-      usb_hid.mouseReport(RID_MOUSE,b,x,y,wheel,pan);
-      timedOut = false;
-    }
-    
+  if (!_started) 
+    return;
+  wakeup();
+  if (_reportQueue.isEmpty()) 
+    _reportTime = millis();   // Start waiting for the interface
+  bool claimed = claimQueue();  // The last report can only be changed while the USB task is not sending it
+  bool queued;
+  if (_absolute) {
+    // Relative motion, such as the macros and the blank report, offsets the position
+    _absoluteX = constrain(_absoluteX + x, 0, POINTER_MAX);
+    _absoluteY = constrain(_absoluteY + y, 0, POINTER_MAX);
+    queued = _reportQueue.pushPointer(RID_POINTER, b, _absoluteX, _absoluteY, wheel, pan, claimed);
+  } else {
+    queued = _reportQueue.pushMouse(RID_MOUSE, usbHidHighResolution, b, x, y, wheel, pan, claimed);
+  }
+  if (claimed) 
+    _reportQueueClaimed = false;
+  if (!queued && USB_DEBUG) { Serial.print("USBDEBUG: Mouse report dropped: "); Serial.println(_reportQueue.getDroppedCount()); }
+  sendQueuedReport();
+}
+
+// Queue a report and send it right away if the interface is ready, otherwise the report complete callback sends it
+bool LSUSBMouse::queueReport(uint8_t reportId, const void* data, uint8_t length)
+{
+  if (!_started) 
+    return false;
+  wakeup();
+  if (_reportQueue.isEmpty()) 
+    _reportTime = millis();   // Start waiting for the interface
+  bool queued = _reportQueue.push(reportId, data, length);
+  if (!queued && USB_DEBUG) { Serial.print("USBDEBUG: Mouse report dropped: "); Serial.println(_reportQueue.getDroppedCount()); }
+  sendQueuedReport();
+  return queued;
+}
+
+// Only one of the main loop and the USB task sends from the queue at a time
+bool LSUSBMouse::claimQueue(void)
+{
+  noInterrupts();
+  bool claimed = !_reportQueueClaimed;
+  _reportQueueClaimed = true;
+  interrupts();
+  return claimed;
+}
+
+void LSUSBMouse::sendQueuedReport(void)
+{
+  if (!claimQueue()) 
+    return;   // The other context is sending, the main loop retries on its next pass
+  hidReportStruct* report = _reportQueue.peek();
+  if (report != NULL && isReady() && usbHid.sendReport(report->reportId, report->data, report->length)) {
+    _reportQueue.pop();
+    _reportTime = millis();
+    timedOut = false;
+  }
+  _reportQueueClaimed = false;
+}
+
+// Send the reports left by the callback and check if the interface stopped taking reports
+void LSUSBMouse::update(void)
+{
+  updateMount();
+  if (_started && _reportQueue.hasPendingMotion()) {
+    bool claimed = claimQueue();
+    _reportQueue.flushMouse(claimed);   // Motion left over while the queue was full
+    if (claimed) 
+      _reportQueueClaimed = false;
+  }
+  sendQueuedReport();
+  if (!_reportQueue.isEmpty() && !usbRetrying && !timedOut 
+      && (millis() - _reportTime) > CONF_USB_HID_TIMEOUT && claimQueue()) {
+    _reportQueue.clear();   // The reports are stale
+    _reportQueueClaimed = false;
+    timedOut = true;
+    showTestPage = true;
+    usbCheckConnection();
+  }
+}
+
+unsigned long LSUSBMouse::getDroppedCount(void)
+{
+  return _reportQueue.getDroppedCount();
 }
 
-void LSUSBMouse::move(int8_t x, int8_t y) 
+void LSUSBMouse::move(int x, int y) 
 {
     mouseReport(_buttons, x, y, 0, 0);
 }
-void LSUSBMouse::moveAll(int8_t x, int8_t y, int8_t wheel, int8_t pan) 
+void LSUSBMouse::moveAll(int x, int y, int8_t wheel, int8_t pan) 
 {
     mouseReport(_buttons, x, y, wheel, pan);
 }
@@ -271,6 +675,25 @@ void LSUSBMouse::pan(int8_t pan)
     mouseReport(_buttons, 0, 0, 0, pan);
 }
 
+// Hosts that set the Resolution Multiplier get the smooth scroll units, other hosts and the absolute pointer get whole detents
+void LSUSBMouse::smoothScroll(int wheel, int pan) 
+{
+    long wheelOutput = wheel;
+    long panOutput = pan;
+    if (_absolute || !usbHidHighResolution || !(mouseResolutionMultiplier & MOUSE_MULTIPLIER_WHEEL)) {
+      _wheelRemainder += wheel;
+      wheelOutput = _wheelRemainder / MOUSE_SCROLL_RESOLUTION;
+      _wheelRemainder -= wheelOutput * MOUSE_SCROLL_RESOLUTION;
+    }
+    if (_absolute || !usbHidHighResolution || !(mouseResolutionMultiplier & MOUSE_MULTIPLIER_PAN)) {
+      _panRemainder += pan;
+      panOutput = _panRemainder / MOUSE_SCROLL_RESOLUTION;
+      _panRemainder -= panOutput * MOUSE_SCROLL_RESOLUTION;
+    }
+    if (wheelOutput != 0 || panOutput != 0) 
+      mouseReport(_buttons, 0, 0, wheelOutput, panOutput);
+}
+
 void LSUSBMouse::click(uint8_t b)
 {
   _buttons = b;
@@ -307,11 +730,50 @@ bool LSUSBMouse::isPressed(uint8_t b)
 
 bool LSUSBMouse::isReady(void)
 {
-	if (usb_hid.ready()) 
+	if (usbHid.ready()) 
 	  return true;
 	return false;
 }
 
+// Keyboard reports share the queue of the mouse reports, so key and button reports are sent in order
+bool LSUSBMouse::keyboardReport(void)
+{
+	hid_keyboard_report_t report;
+	report.modifier = _keyModifiers;
+	report.reserved = 0;
+	memcpy(report.keycode, _keys, sizeof(report.keycode));
+	return queueReport(RID_KEYBOARD, &report, sizeof(report));
+}
+
+bool LSUSBMouse::keyPress(uint8_t m, uint8_t k)
+{
+	_keyModifiers |= m;
+	if (k != 0 && memchr(_keys, k, sizeof(_keys)) == NULL) {
+	  uint8_t* freeKey = (uint8_t*)memchr(_keys, 0, sizeof(_keys));
+	  if (freeKey == NULL) 
+	    return false;
+	  *freeKey = k;
+	}
+	return keyboardReport();
+}
+
+bool LSUSBMouse::keyRelease(uint8_t k)
+{
+	_keyModifiers = 0;
+	for (uint8_t i = 0; i < sizeof(_keys); i++) {
+	  if (k != 0 && _keys[i] == k) 
+	    _keys[i] = 0;
+	}
+	return keyboardReport();
+}
+
+bool LSUSBMouse::keyReleaseAll(void)
+{
+	_keyModifiers = 0;
+	memset(_keys, 0, sizeof(_keys));
+	return keyboardReport();
+}
+
 /*****************************
  *   KEYBOARD SECTION
  *****************************/ 
@@ -444,68 +906,118 @@ bool LSUSBKeyboard::isReady(void)
  *****************************/ 
 LSUSBGamepad::LSUSBGamepad(void)
 {
-  this->usb_hid.setPollInterval(1);
-  this->usb_hid.setReportDescriptor(gamepad_desc_hid_report, sizeof(gamepad_desc_hid_report));
-  //this->usb_hid.setStringDescriptor(GAMEPAD_DESCRIPTOR); // TODO this causes TinyUSB to crash 2025-Jan-20
+
 }
 
 void LSUSBGamepad::begin(void)
 {
-  this->usb_hid.begin();
-
-  unsigned long timerHidTimeoutBegin = millis();
-  unsigned long usbTimeoutMillis;
+  if (!usbHidStarted)
+    usbHidGamepadOnly = true;    // Booting in gamepad mode
+  usbHidBegin();
+  _started = true;
 
   g_usbAttempt++;
-    
-  if (usbRetrying) {
-    usbTimeoutMillis = 200;                     // when reattemping to connect the USB, uses a smaller value to not freeze up the code for long but will keep retrying 
-  } else {
-    usbTimeoutMillis = CONF_USB_HID_TIMEOUT;    // the first time the usb tried to connect, use the default timeout
-  }
-  
-  while( !USBDevice.mounted() ) {
-    delay(1);
 
-    if ((millis() - timerHidTimeoutBegin) > usbTimeoutMillis){
-      usbRetrying = true;
-      break;
-    } 
-  }
+  // The mount is not waited for, update() follows it while the sensors start
+  _mountTimeout = usbRetrying ? USB_MOUNT_RETRY_TIMEOUT : CONF_USB_HID_TIMEOUT;
+  _mountBeginTime = millis();
+  _mountState = USB_MOUNT_WAITING;
+  updateMount();
 
-  if (USBDevice.mounted()) {
-    usbRetrying = false;
-    g_usbAttempt = 0;
-  }
-  
   // Release all the buttons and center joystick
   end();
-  startMillis = millis();
 }
 
+void LSUSBGamepad::updateMount(void)
+{
+  if (_mountState == USB_MOUNT_WAITING) {
+    if (usbHidMounted) {
+      _mountState = USB_MOUNT_MOUNTED;
+      usbRetrying = false;
+      g_usbAttempt = 0;
+      end();   // The host gets the released buttons and centered joystick
+      usbMounted();
+    } else if (!usbRetrying && (millis() - _mountBeginTime) > _mountTimeout) {
+      usbRetrying = true;   // usbCheckConnection begins again
+      if (_mountTimeout == CONF_USB_HID_TIMEOUT)
+        usbMountTimedOut();
+    }
+  } else if (_mountState == USB_MOUNT_MOUNTED && !usbHidMounted) {
+    _mountState = USB_MOUNT_WAITING;   // Unplugged, wait for the next mount
+    _mountBeginTime = millis();
+  }
+}
+
+bool LSUSBGamepad::isMountPending(void)
+{
+  return _mountState == USB_MOUNT_WAITING && !usbRetrying;
+}
+
+// Gamepad reports are queued and the caller returns immediately
 void LSUSBGamepad::send(void)
 {
-  if (startMillis != millis()) {
+  GamepadReport(&_report, reportLength());
+}
+
+// Queue a report and send it right away if the interface is ready, otherwise the report complete callback sends it
+bool LSUSBGamepad::GamepadReport(void* data, size_t length)
+{
+  if (!_started) 
+    return false;
   wakeup();
-  unsigned long timerTimeoutBegin = millis();
+  if (_reportQueue.isEmpty()) 
+    _reportTime = millis();   // Start waiting for the interface
+  bool queued = _reportQueue.pushState(usbHidGamepadOnly ? 0 : RID_GAMEPAD, data, (uint8_t)length, false);  // Axis reports leave room for button transitions
+  if (!queued && USB_DEBUG) { Serial.print("USBDEBUG: Gamepad report dropped: "); Serial.println(_reportQueue.getDroppedCount()); }
+  sendQueuedReport();
+  return queued;
+}
 
-  while(!isReady() && !usbRetrying) {
-    delay(1);
-    if ((millis() - timerTimeoutBegin) > CONF_USB_HID_TIMEOUT){
-      break;
-    }
+// Only one of the main loop and the USB task sends from the queue at a time
+bool LSUSBGamepad::claimQueue(void)
+{
+  noInterrupts();
+  bool claimed = !_reportQueueClaimed;
+  _reportQueueClaimed = true;
+  interrupts();
+  return claimed;
+}
+
+void LSUSBGamepad::sendQueuedReport(void)
+{
+  if (!claimQueue()) 
+    return;   // The other context is sending, the main loop retries on its next pass
+  hidReportStruct* report = _reportQueue.peek();
+  if (report != NULL && isReady() && usbHid.sendReport(report->reportId, report->data, report->length)) {
+    _reportQueue.pop();
+    _reportTime = millis();
   }
-  GamepadReport(&_report, sizeof(_report));
-    startMillis = millis();
+  _reportQueueClaimed = false;
+}
+
+// Send the reports left by the callback and drop them if the interface stopped taking reports
+void LSUSBGamepad::update(void)
+{
+  updateMount();
+  sendQueuedReport();
+  if (!_reportQueue.isEmpty() && (millis() - _reportTime) > CONF_USB_HID_TIMEOUT && claimQueue()) {
+    _reportQueue.clear();   // The reports are stale
+    _reportQueueClaimed = false;
   }
 }
 
+unsigned long LSUSBGamepad::getDroppedCount(void)
+{
+  return _reportQueue.getDroppedCount();
+}
+
 void LSUSBGamepad::end(void)
 {
   _report.buttons = 0;
   _report.xAxis = 128;
   _report.yAxis = 128;
-  GamepadReport(&_report, sizeof(_report));
+  _report.zAxis = 128;
+  GamepadReport(&_report, reportLength());
 }
 
 void LSUSBGamepad::wakeup(void)
@@ -517,31 +1029,13 @@ void LSUSBGamepad::wakeup(void)
 
 void LSUSBGamepad::write(void)
 {
-  wakeup();
-  unsigned long timerTimeoutBegin = millis();
-
-  while(!isReady() && !usbRetrying) {
-    delay(1);
-    if ((millis() - timerTimeoutBegin) > CONF_USB_HID_TIMEOUT){
-      break;
-    }
-  }
-  GamepadReport(&_report, sizeof(_report));
+  GamepadReport(&_report, reportLength());
 }
 
 void LSUSBGamepad::write(void *report)
 {
-  wakeup();
-  unsigned long timerTimeoutBegin = millis();
-
-  while(!isReady() && !usbRetrying) {
-    delay(1);
-    if ((millis() - timerTimeoutBegin) > CONF_USB_HID_TIMEOUT){
-      break;
-    }
-  }
   memcpy(&_report, report, sizeof(_report));
-  GamepadReport(&_report, sizeof(_report));
+  GamepadReport(&_report, reportLength());
 }
 
 void LSUSBGamepad::press(uint8_t b)
@@ -580,21 +1074,43 @@ void LSUSBGamepad::yAxis(uint8_t a)
   _report.yAxis = 128 + a;
 }
 
+
+void LSUSBGamepad::zAxis(uint8_t a)
+{
+  _report.zAxis = 128 + a;
+}
+
 void LSUSBGamepad::move(uint8_t x,uint8_t y)
 {
   _report.xAxis = 128 + x;
   _report.yAxis = 128 + y;
 }
 
+void LSUSBGamepad::setZAxis(bool zAxis)
+{
+  if (!usbHidStarted) 
+    usbHidGamepadZAxis = zAxis;
+}
+
+bool LSUSBGamepad::hasZAxis(void)
+{
+  return usbHidGamepadZAxis;
+}
+
+size_t LSUSBGamepad::reportLength(void)
+{
+  return usbHidGamepadZAxis ? sizeof(_report) : sizeof(_report) - sizeof(_report.zAxis);
+}
+
 bool LSUSBGamepad::isReady(void)
 {
-	if (usb_hid.ready()) 
+	if (usbHid.ready()) 
 	  return true;
 	return false;
 }
 
 bool LSUSBGamepad::isConnected(void) {
-  	if (usb_hid.ready()) { 
+  	if (usbHid.ready()) { 
 	    return true;
     } else {
       return false;
@@ -73,6 +73,46 @@ typedef struct {
   unsigned long elapsedTime;     // in ms
 } inputStateStruct;
 
+// Gesture sequence structure ( Sequence of short input gestures and the output actions it triggers )
+#define GESTURE_SEQUENCE_MAX_LENGTH 4
+
+typedef struct
+{
+  uint8_t sequenceLength;                                 // Number of gestures in the sequence
+  uint8_t sequenceGesture[GESTURE_SEQUENCE_MAX_LENGTH];   // Gesture tokens ( input source and main state )
+  uint8_t mouseOutputActionNumber;
+  uint8_t gamepadOutputActionNumber;
+} gestureSequenceStruct;
+
+// Action commit structure ( Time after which the output action of each input main state is decided )
+#define ACTION_COMMIT_STATE_NUMBER 8          // Number of input main states (sip and puff states fit within button states)
+#define ACTION_COMMIT_TIME_NEVER 0xFFFFFFFF   // Output action is only decided on release
+
+typedef struct
+{
+  unsigned long commitTime[ACTION_COMMIT_STATE_NUMBER];   // Elapsed time after which no longer action window exists
+  bool committed;                                         // True if the output action of the started input was already performed
+  bool holdAction;                                        // True if the committed action is held until the input is released
+} actionCommitStruct;
+
+// Macro step structure ( One HID report of a macro and the delay before the next step )
+typedef struct
+{
+  uint8_t stepType;             // Mouse, keyboard or gamepad report type
+  uint8_t stepParameter1;       // Buttons, x movement, key modifiers or gamepad button
+  uint8_t stepParameter2;       // y movement or key code
+  uint8_t stepDelay;            // Delay after the step in units of CONF_MACRO_DELAY_UNIT
+} macroStepStruct;
+
+// Macro structure ( Sequence of HID report steps )
+#define MACRO_MAX_STEPS 16
+
+typedef struct
+{
+  uint8_t stepCount;
+  macroStepStruct step[MACRO_MAX_STEPS];
+} macroStruct;
+
 // acceleration structure
 typedef struct
 {
@@ -82,4 +122,13 @@ typedef struct
   uint8_t accEndSpeed;
 } accStruct;
 
+// Absolute pointer region structure ( Part of the screen reached by the absolute pointer, in percent of the screen )
+typedef struct
+{
+  uint8_t regionLeft;
+  uint8_t regionTop;
+  uint8_t regionRight;
+  uint8_t regionBottom;
+} absoluteRegionStruct;
+
 #endif
@@ -26,9 +26,18 @@
 #include "LSUSB.h"
 #include "LSBLE.h"
 #include "LSCircularBuffer.h"
+#include "LSInputStateMachine.h"
 #include "LSInput.h"
 #include "LSPressure.h"
+#include "LSGesture.h"
+#include "LSActionTable.h"
+#include "LSActionMap.h"
+#include "LSChord.h"
+#include "LSMacro.h"
+#include "LSEventQueue.h"
 #include "LSJoystick.h"
+#include "LSDwell.h"
+#include "LSPointer.h"
 #include "LSMemory.h"
 #include "LSScreen.h"
 #include "LSBuzzer.h"
@@ -39,7 +48,7 @@ String g_deviceUID = "";  // Global variable for storing unique identifier for b
 
 // Communication mode and debug mode variables
 int g_comMode;        // 0 = None , 1 = USB , 2 = Wireless
-int g_operatingMode;  // 0 = None, 1 = Mouse, 2 = Gamepad, 3 = Safe
+int g_operatingMode;  // 0 = None, 1 = Mouse, 2 = Gamepad, 3 = Safe, 4 = Absolute
 int g_soundMode;      // 0 = None, 1 = Basic, 2 = Advanced // TODO 2025-Feb-05 Currently not used - buzzer.begin sets sound mode from memory
 int g_lightMode;      // 0 = None, 1 = Basic, 2 = Advanced
 
@@ -49,6 +58,7 @@ int g_debugMode;  // 0 = Debug mode is Off
                   // 3 = Buttons debug mode is On
                   // 4 = Switch debug mode is On
                   // 5 = Sip & Puff state debug mode is On
+                  // 6 = Input event record debug mode is On
 
 int g_errorCode = 0;  // Global variable for storing error code. 0 is no error. Additional errors defined in LSConfig.h
 
@@ -71,9 +81,10 @@ ledStateStruct* ledCurrentState = new ledStateStruct;  // pointer to LED current
 bool ledActionEnabled = false;
 
 // Input module variables
-int buttonActionSize, switchActionSize;
-unsigned long buttonActionMaxTime, switchActionMaxTime;
+LSActionTable buttonActionTable, switchActionTable;  // Compiled button and switch action mapping
 inputStateStruct buttonState, switchState;
+actionCommitStruct buttonActionCommit, switchActionCommit;  // Early commit times of button and switch actions
+bool g_inputEnabled = true;  // Buttons and switches are processed if true
 
 int inputButtonPinArray[] = { CONF_BUTTON1_PIN, CONF_BUTTON2_PIN };
 int inputSwitchPinArray[] = { CONF_SWITCH1_PIN, CONF_SWITCH2_PIN, CONF_SWITCH3_PIN };
@@ -83,8 +94,19 @@ LSInput is(inputSwitchPinArray, CONF_SWITCH_NUMBER);  // Create an instance of t
 
 inputStateStruct sapActionState;
 
-int sapActionSize;
-unsigned long sapActionMaxTime = 0;
+// Gesture sequence variables
+int g_gestureMode = CONF_GESTURE_MODE_DEFAULT;  // 0 = Off, 1 = On
+int gestureSequenceSize;
+LSGesture gesture;  // Create an instance of the gesture sequence recognizer
+
+// Chord variables
+LSActionTable chordActionTable;  // Compiled chord action mapping
+LSChord chord;                   // Inputs held together over sip and puff, buttons and switches
+
+LSActionMap actionMap;  // Sip and puff, button, switch and led action mapping, loaded from flash memory
+LSMacro macro;          // HID report macros, loaded from flash memory
+LSActionTable sapActionTable;  // Compiled sip and puff action mapping
+actionCommitStruct sapActionCommit;  // Early commit times of sip and puff actions
 
 // Timer related variables
 int actionTimerId[1];  // 1 action timer
@@ -93,7 +115,7 @@ LSTimer<int> actionTimer;
 int calibrationTimerId[2];  // 2 calibration timers: 0 - , 1-
 LSTimer<int> calibrationTimer;
 
-int pollTimerId[10];  // 9 poll timers
+int pollTimerId[10];  // 8 poll timers
 LSTimer<void> pollTimer;
 
 int ledTimerId[5];  // 3 LED timers 0 - startup feedback, 1 - IBM, 2- normal blinks, 3 - Bluetooth Status, 4 - error
@@ -102,13 +124,35 @@ LSTimer<ledStateStruct> ledStateTimer;
 int usbConnectTimerId[1];
 LSTimer<int> usbConnectTimer;
 
+int macroTimerId[1];  // 1 macro step timer
+bool macroRetrying = false;           // The current macro step is waiting for the HID interface
+unsigned long macroRetryMillis = 0;   // Time the current macro step was first held back
+LSTimer<void> macroTimer;
+
+LSEventQueue eventQueue;  // Timestamped input events from the joystick, pressure and input loops
+
 unsigned int g_usbAttempt = 0;
 unsigned int g_usbConnectDelay = CONF_USB_HID_INIT_DELAY;
 
 // Joystick module variables and structures
 int acceleration = 0;
 int g_scrollLevel = 0;
-int g_scrollNumRuns = 0;
+bool g_scrollPollActive = false;  // True if the scroll poll timer is enabled instead of the joystick poll timer
+
+// Proportional pressure output variables
+int g_pressureOutputMode = CONF_PRESS_OUTPUT_MODE_OFF;              // 0 = Off, 1 = Gamepad axis, 2 = Scroll speed, 3 = Cursor speed
+float g_pressureOutputDeadband = CONF_PRESS_OUTPUT_DEADBAND_DEFAULT;  // Pressure magnitude (hPa) with no output
+float g_pressureOutputCurve = CONF_PRESS_OUTPUT_CURVE_DEFAULT;        // Output curve exponent
+float g_pressureOutputValue = 0.0;                                    // Latest proportional output, -1.0 (sip) to 1.0 (puff)
+int g_pressureOutputAxis = 0;                                         // Last gamepad Z axis value sent by the proportional output
+
+// Dwell click variables
+int g_dwellMode = CONF_DWELL_MODE_DEFAULT;  // 0 = Off, 1 = Left click, 2 = Right click, 3 = Double click, 4 = Drag toggle
+LSDwell dwell;                              // Create an instance of the dwell click detector
+
+// Absolute pointer variables
+int g_absoluteMode = CONF_ABS_MODE_DEFAULT;  // 0 = Integrate, 1 = Direct
+LSPointer pointer;                           // Create an instance of the absolute pointer position
 
 int outputAction;
 bool canOutputAction = true;
@@ -122,6 +166,8 @@ bool settingsEnabled = false;  // Serial input settings command mode enabled or
 unsigned long beginMillis;
 unsigned long beforeComOpMillis;
 unsigned long afterComOpMillis;
+unsigned long usbMountMillis = 0;      // Time the host configured the USB device
+unsigned long firstMotionMillis = 0;   // Time of the first cursor motion sent to the host
 
 
 // Create instances of classes
@@ -135,6 +181,8 @@ LSBuzzer buzzer;  // Create an instance of the LSBuzzer Object
 LSUSBMouse usbmouse;   // Create an instance of the USB mouse object
 LSBLEMouse btmouse;    // Create an instance of the BLE mouse object
 LSUSBGamepad gamepad;  // Create an instance of the USB gamepad object
+LSBLEGamepad btgamepad;  // Create an instance of the BLE gamepad object
+LSBLEConnection btconnection;  // Create an instance of the BLE connection parameter manager
 
 
 //***MICROCONTROLLER AND PERIPHERAL CONFIGURATION***//
@@ -224,7 +272,6 @@ void setup() {
   // Configure poll timer to perform each feature as a separate loop
   pollTimerId[CONF_TIMER_JOYSTICK] = pollTimer.setInterval(CONF_JOYSTICK_POLL_RATE, 0, joystickLoop);  // poll rate, start delay, function
   pollTimerId[CONF_TIMER_PRESSURE] = pollTimer.setInterval(CONF_PRESSURE_POLL_RATE, 0, pressureLoop);
-  pollTimerId[CONF_TIMER_INPUT] = pollTimer.setInterval(CONF_INPUT_POLL_RATE, 0, inputLoop);
   pollTimerId[CONF_TIMER_BLUETOOTH] = pollTimer.setInterval(CONF_BT_FEEDBACK_POLL_RATE, 0, btFeedbackLoop);
   pollTimerId[CONF_TIMER_DEBUG] = pollTimer.setInterval(CONF_DEBUG_POLL_RATE, 0, debugLoop);
   pollTimerId[CONF_TIMER_SCROLL] = pollTimer.setInterval(CONF_SCROLL_POLL_RATE, 0, joystickLoop);
@@ -261,8 +308,7 @@ void setup() {
   }
 
   if (g_joystickSensorConnected) {
-    pollTimer.enable(CONF_TIMER_JOYSTICK);
-    pollTimer.enable(CONF_TIMER_SCROLL);
+    updateJoystickPollTimer(true);  // Enable joystick or scroll polling
   } else {
     pollTimer.disable(CONF_TIMER_JOYSTICK);
     pollTimer.disable(CONF_TIMER_SCROLL);
@@ -300,6 +346,20 @@ void loop() {
   ledStateTimer.run();  // Timer for lights
   
   usbConnectTimer.run();
+
+  usbmouse.update();  // Send the USB reports the report complete callback left in the queues
+  gamepad.update();
+  btmouse.update();   // Send the Bluetooth reports waiting for a free notification buffer
+  btgamepad.update();
+  if (g_comMode == CONF_COM_MODE_BLE) {
+    btconnection.update(millis());  // Renegotiate the connection interval after the user rests
+    blehosts.update(millis());      // Advertise to the selected host after a switch
+    if (blehosts.isChanged()) {
+      saveBluetoothHost();
+    }
+  }
+
+  macroTimer.run();  // Timer for macro steps
   
 
   if (g_joystickSensorConnected) {
@@ -312,6 +372,13 @@ void loop() {
   }
 
   pollTimer.run();  // Timer for normal joystick functions
+
+  // Buttons and switches are interrupt driven: only update them when an edge was captured or an input is active
+  if (g_inputEnabled && (ib.isUpdateDue(millis()) || is.isUpdateDue(millis()))) {
+    inputLoop();
+  }
+
+  eventLoop();  // Perform the input events of this loop
   
 
   settingsEnabled = serialSettings(settingsEnabled);  // Process Serial API commands
@@ -431,10 +498,10 @@ void handleHardwareErrors(void) {
 void errorCheck(void) {
   if (USB_DEBUG) { Serial.println("USBDEBUG: errorCheck()"); }
 
-  if ((g_operatingMode == CONF_OPERATING_MODE_MOUSE) && (g_comMode == CONF_COM_MODE_USB)
+  if (isMouseOperatingMode() && (g_comMode == CONF_COM_MODE_USB)
       && (!usbmouse.isReady() || usbmouse.usbRetrying || usbmouse.timedOut)) {
     g_errorCode = CONF_ERROR_USB;
-  } else if ((g_operatingMode == CONF_OPERATING_MODE_GAMEPAD) && !gamepad.isReady()) {
+  } else if ((g_operatingMode == CONF_OPERATING_MODE_GAMEPAD) && (g_comMode == CONF_COM_MODE_USB) && !gamepad.isReady()) {
     g_errorCode = CONF_ERROR_USB;
   } else {
     g_errorCode = CONF_ERROR_NONE;  // 0
@@ -586,6 +653,10 @@ void toggleSafeMode(bool safeModeEnabled) {
 void readyToUse(void) {
   if (USB_DEBUG) { Serial.println("USBDEBUG: readyToUse()"); }
 
+  if (isUsbMountPending()) {
+    return;  // Called again by usbMounted or usbMountTimedOut
+  }
+
   errorCheck();  // Check for errors
 
   if (readyToUseFirstTime && g_resetCenterComplete && !g_safeModeEnabled) {
@@ -600,15 +671,107 @@ void readyToUse(void) {
     }
 
     if (SHOW_CONNECTION_TIME) {
-      screen.connectionTimingPage(beforeComOpMillis, afterComOpMillis);
-      Serial.print("Time until before com op mode: ");
-      Serial.println(beforeComOpMillis);
-      Serial.print("Time until after com op mode: ");
-      Serial.println(afterComOpMillis);
+      showConnectionTime();
     }
   }
 }
 
+//***SHOW CONNECTION TIME FUNCTION***//
+// Function   : showConnectionTime
+//
+// Description: This function shows the startup timestamps on the screen and prints them.
+//              The USB mount and first cursor motion are 0 until they happened.
+//
+// Parameters : void
+//
+// Return     : void
+//****************************************//
+void showConnectionTime(void) {
+  screen.connectionTimingPage(beforeComOpMillis, afterComOpMillis, usbMountMillis, firstMotionMillis);
+  Serial.print("Time until before com op mode: ");
+  Serial.println(beforeComOpMillis);
+  Serial.print("Time until after com op mode: ");
+  Serial.println(afterComOpMillis);
+  Serial.print("Time until USB mount: ");
+  Serial.println(usbMountMillis);
+  Serial.print("Time until first cursor motion: ");
+  Serial.println(firstMotionMillis);
+}
+
+//***USB MOUNTED FUNCTION***//
+// Function   : usbMounted
+//
+// Description: This function is called by the USB mouse and gamepad once the host configured the device.
+//              The ready screen waits for the mount if the center reset completed first.
+//
+// Parameters : void
+//
+// Return     : void
+//****************************************//
+void usbMounted(void) {
+  if (usbMountMillis == 0) {
+    usbMountMillis = (usbHidMountTime > beginMillis) ? (usbHidMountTime - beginMillis) : 1;  // Mounted before setup
+  }
+  if (g_resetCenterComplete) {
+    readyToUse();
+  }
+}
+
+//***USB MOUNT TIMED OUT FUNCTION***//
+// Function   : usbMountTimedOut
+//
+// Description: This function is called by the USB mouse and gamepad once the first mount timed out.
+//              The ready screen that waited for the mount shows the error screen and sound instead.
+//
+// Parameters : void
+//
+// Return     : void
+//****************************************//
+void usbMountTimedOut(void) {
+  if (g_resetCenterComplete) {
+    readyToUse();
+  }
+}
+
+//***IS USB MOUNT PENDING FUNCTION***//
+// Function   : isUsbMountPending
+//
+// Description: This function checks if the USB device of the current mode is waiting for its first mount.
+//
+// Parameters : void
+//
+// Return     : bool : true while the host did not configure the device and the mount did not time out
+//****************************************//
+bool isUsbMountPending(void) {
+  if (g_comMode == CONF_COM_MODE_USB && g_operatingMode == CONF_OPERATING_MODE_GAMEPAD) {
+    return gamepad.isMountPending();
+  }
+  return isUsbOperatingMode(g_operatingMode) && usbmouse.isMountPending();
+}
+
+//***RECORD FIRST MOTION FUNCTION***//
+// Function   : recordFirstMotion
+//
+// Description: This function records the time of the first cursor motion sent to a connected host.
+//
+// Parameters : void
+//
+// Return     : void
+//****************************************//
+void recordFirstMotion(void) {
+  if (firstMotionMillis != 0) {
+    return;
+  }
+  bool connected = (g_comMode == CONF_COM_MODE_BLE && g_operatingMode == CONF_OPERATING_MODE_MOUSE) ? btmouse.isConnected() : usbmouse.isConnected();
+  if (!connected) {
+    return;
+  }
+  firstMotionMillis = millis() - beginMillis;
+  if (SHOW_CONNECTION_TIME) {
+    showConnectionTime();
+  }
+}
+
 //***ENABLE POLL FUNCTION***//
 // Function   : enablePoll
 //
@@ -625,12 +788,14 @@ void enablePoll(bool isEnabled) {
   if (isEnabled) {
     getDebugMode(false, false);
     pollTimer.enable(CONF_TIMER_PRESSURE);
-    pollTimer.enable(CONF_TIMER_INPUT);
+    ib.clear();  // Drop the edges the interrupts queued while input was off
+    is.clear();
+    g_inputEnabled = true;
     pollTimer.enable(CONF_TIMER_BLUETOOTH);
   } else {
     pollTimer.disable(CONF_TIMER_JOYSTICK);
     pollTimer.disable(CONF_TIMER_PRESSURE);
-    pollTimer.disable(CONF_TIMER_INPUT);
+    g_inputEnabled = false;
     pollTimer.disable(CONF_TIMER_BLUETOOTH);
     pollTimer.disable(CONF_TIMER_DEBUG);
     pollTimer.disable(CONF_TIMER_SCROLL);
@@ -657,13 +822,167 @@ void initMemory() {
   // Open settings file (CONF_SETTINGS_FILE) from flash memory.
   // If not present, create file based on defaults in CONF_SETTINGS_JSON
   mem.initialize(CONF_SETTINGS_FILE, CONF_SETTINGS_JSON);  
+
+  initActionMap();  // Load action mapping from flash memory
+  initMacro();      // Load macros from flash memory
+  initBluetoothHost();  // Load Bluetooth hosts from flash memory
+}
+
+//***INITIALIZE ACTION MAPPING FUNCTION***//
+// Function   : initActionMap
+//
+// Description: This function loads the action mapping record (CONF_ACTION_MAP_FILE) from flash memory.
+//              The default mapping of LSConfig.h is used if the record is not present or invalid.
+//
+// Parameters : void
+//
+// Return     : void
+//****************************************//
+void initActionMap() {
+  static uint8_t actionMapRecord[ACTION_MAP_RECORD_MAX_SIZE];
+  int recordLength = mem.readBinary(CONF_ACTION_MAP_FILE, actionMapRecord, sizeof(actionMapRecord));
+  if (recordLength == 0) {
+    return;  // No custom mapping
+  }
+
+  int result = actionMap.decode(actionMapRecord, recordLength);
+  if (USB_DEBUG && result != ACTION_MAP_VALID) {
+    Serial.print("USBDEBUG: Invalid action mapping record, error ");
+    Serial.println(result);
+  }
+}
+
+//***INITIALIZE MACROS FUNCTION***//
+// Function   : initMacro
+//
+// Description: This function loads the macro record (CONF_MACRO_FILE) from flash memory.
+//              The default macros of LSConfig.h are used if the record is not present, and for any invalid macro.
+//
+// Parameters : void
+//
+// Return     : void
+//****************************************//
+void initMacro() {
+  static uint8_t macroRecord[MACRO_RECORD_MAX_SIZE];
+  int recordLength = mem.readBinary(CONF_MACRO_FILE, macroRecord, sizeof(macroRecord));
+  if (recordLength == 0) {
+    return;  // No custom macros
+  }
+
+  int result = macro.decode(macroRecord, recordLength);
+  if (USB_DEBUG && result != MACRO_VALID) {
+    Serial.print("USBDEBUG: Invalid macro record, error ");
+    Serial.println(result);
+  }
+}
+
+//***INITIALIZE BLUETOOTH HOSTS FUNCTION***//
+// Function   : initBluetoothHost
+//
+// Description: This function loads the Bluetooth host slots (CONF_BT_HOST_FILE) and the selected slot from flash memory.
+//
+// Parameters : void
+//
+// Return     : void
+//****************************************//
+void initBluetoothHost() {
+  static uint8_t hostRecord[sizeof(bleHostStruct) * BLE_HOST_SLOTS];
+  int recordLength = mem.readBinary(CONF_BT_HOST_FILE, hostRecord, sizeof(hostRecord));
+  if (recordLength > 0 && !blehosts.setRecord(hostRecord, recordLength) && USB_DEBUG) {
+    Serial.println("USBDEBUG: Invalid Bluetooth host record");
+  }
+  blehosts.setSlot(getBluetoothHost(false, false));
+}
+
+//***SAVE BLUETOOTH HOSTS FUNCTION***//
+// Function   : saveBluetoothHost
+//
+// Description: This function writes the Bluetooth host slots to flash memory as one binary record.
+//
+// Parameters : void
+//
+// Return     : bool : true if the record was written
+//****************************************//
+bool saveBluetoothHost() {
+  static uint8_t hostRecord[sizeof(bleHostStruct) * BLE_HOST_SLOTS];
+  int recordLength = blehosts.getRecord(hostRecord, sizeof(hostRecord));
+  blehosts.saved();  // A failed write is not retried every loop
+  return (recordLength > 0) && mem.writeBinary(CONF_BT_HOST_FILE, hostRecord, recordLength);
+}
+
+//***SAVE MACROS FUNCTION***//
+// Function   : saveMacro
+//
+// Description: This function writes all macros to flash memory as one binary record.
+//
+// Parameters : void
+//
+// Return     : bool : true if the record was written
+//****************************************//
+bool saveMacro() {
+  static uint8_t macroRecord[MACRO_RECORD_MAX_SIZE];
+  int recordLength = macro.encode(macroRecord, sizeof(macroRecord));
+  return (recordLength > 0) && mem.writeBinary(CONF_MACRO_FILE, macroRecord, recordLength);
+}
+
+//***SAVE ACTION MAPPING FUNCTION***//
+// Function   : saveActionMap
+//
+// Description: This function writes the current action mapping to flash memory as one binary record.
+//
+// Parameters : void
+//
+// Return     : bool : true if the record was written
+//****************************************//
+bool saveActionMap() {
+  static uint8_t actionMapRecord[ACTION_MAP_RECORD_MAX_SIZE];
+  int recordLength = actionMap.encode(actionMapRecord, sizeof(actionMapRecord));
+  return (recordLength > 0) && mem.writeBinary(CONF_ACTION_MAP_FILE, actionMapRecord, recordLength);
+}
+
+//***APPLY ACTION MAPPING FUNCTION***//
+// Function   : applyActionMap
+//
+// Description: This function recompiles the action mapping of an input table after it was changed.
+//              Any action in progress is released first so it can't outlive its mapping.
+//
+// Parameters : table : int : ACTION_MAP_TABLE_SAP, _BUTTON, _SWITCH, _CHORD or _LED
+//
+// Return     : void
+//****************************************//
+void applyActionMap(int table) {
+  if (outputAction == CONF_ACTION_SCROLL || outputAction == CONF_ACTION_DRAG) {
+    setLedDefault();
+    releaseOutputAction();
+    updateJoystickPollTimer(false);
+  }
+
+  switch (table) {
+    case ACTION_MAP_TABLE_SAP:
+      sapActionTable.begin(actionMap.getInputTable(ACTION_MAP_TABLE_SAP), actionMap.getInputSize(ACTION_MAP_TABLE_SAP));
+      initActionCommit(&sapActionCommit, &sapActionTable, 0);
+      break;
+    case ACTION_MAP_TABLE_BUTTON:
+      buttonActionTable.begin(actionMap.getInputTable(ACTION_MAP_TABLE_BUTTON), actionMap.getInputSize(ACTION_MAP_TABLE_BUTTON));
+      initActionCommit(&buttonActionCommit, &buttonActionTable, INPUT_REACTION_TIME);
+      break;
+    case ACTION_MAP_TABLE_SWITCH:
+      switchActionTable.begin(actionMap.getInputTable(ACTION_MAP_TABLE_SWITCH), actionMap.getInputSize(ACTION_MAP_TABLE_SWITCH));
+      initActionCommit(&switchActionCommit, &switchActionTable, INPUT_REACTION_TIME);
+      break;
+    case ACTION_MAP_TABLE_CHORD:
+      chordActionTable.begin(actionMap.getInputTable(ACTION_MAP_TABLE_CHORD), actionMap.getInputSize(ACTION_MAP_TABLE_CHORD));
+      chord.clear(millis());
+      break;
+  }
 }
 
 //***RESET MEMORY FUNCTION***//
 // Function   : resetMemory
 //
 // Description: This function formats and removes existing text files in flash memory.
-//              It initializes flash memory to store settings after formatting.
+//              It initializes flash memory to store settings after formatting, and restores and
+//              recompiles the default action mapping and macros.
 //
 // Parameters : void
 //
@@ -673,6 +992,13 @@ void resetMemory() {
   if (USB_DEBUG) { Serial.println("USBDEBUG: resetMemory()"); }
   mem.format();                                            // Format and remove existing text files in flash memory
   mem.initialize(CONF_SETTINGS_FILE, CONF_SETTINGS_JSON);  // Initialize flash memory to store settings
+  for (int tableIndex = 0; tableIndex < ACTION_MAP_TABLE_NUMBER; tableIndex++) {
+    actionMap.resetTable(tableIndex);                      // Restore default action mapping
+    applyActionMap(tableIndex);                            // Recompile the restored mapping
+  }
+  for (int macroIndex = 0; macroIndex < CONF_MACRO_NUMBER; macroIndex++) {
+    macro.resetMacro(macroIndex);                          // Restore default macros
+  }
 }
 
 //***Read UID FUNCTION***//
@@ -888,6 +1214,27 @@ void initCommunicationMode() {
 }
 
 
+//***USB REPORT COMPLETE CALLBACK FUNCTION***//
+// Function   : tud_hid_report_complete_cb
+//
+// Description: This function is called by TinyUSB from the USB task when a HID report was sent to the host.
+//              The next queued report of the interface is sent right away.
+//
+// Parameters : instance : uint8_t : HID interface instance
+//              report : uint8_t const* : Sent report
+//              len : uint16_t : Length of the sent report
+//
+// Return     : void
+//****************************************//
+void tud_hid_report_complete_cb(uint8_t instance, uint8_t const* report, uint16_t len) {
+  (void)instance;
+  (void)report;
+  (void)len;
+  usbmouse.sendQueuedReport();  // Only the interface that was started has reports queued
+  gamepad.sendQueuedReport();
+}
+
+
 //***USB CONNECTION LOOP FUNCTION***//
 // Function   : usbConnectionLoop
 //
@@ -902,7 +1249,7 @@ void usbConnectionLoop() {
   
   // Check if USB is connected
   if (g_comMode == CONF_COM_MODE_USB) {
-    if (g_operatingMode == CONF_OPERATING_MODE_MOUSE) {
+    if (isMouseOperatingMode()) {
       g_usbIsConnected = usbmouse.isConnected();
     }
     else if (g_operatingMode == CONF_OPERATING_MODE_GAMEPAD) {
@@ -936,7 +1283,10 @@ void usbCheckConnection(void) {
   if (USB_DEBUG) { Serial.println("USBDEBUG: usbCheckConnection()"); }
 
 
-  if (usbmouse.usbRetrying || gamepad.usbRetrying) {
+  if (isUsbMountPending()) {
+    usbConnectTimerId[0] = usbConnectTimer.setTimeout(g_usbConnectDelay, usbCheckConnection);  // The host is still enumerating the device
+
+  } else if (usbmouse.usbRetrying || gamepad.usbRetrying) {
 
     if (usbmouse.usbRetrying) {
       Serial.print("Reattempting USB Mouse ");
@@ -961,8 +1311,8 @@ void usbCheckConnection(void) {
 
     usbConnectTimerId[0] = usbConnectTimer.setTimeout(g_usbConnectDelay, usbCheckConnection);  // Keep retrying connection until USB connection is made
 
-  } else if (((g_operatingMode == CONF_OPERATING_MODE_MOUSE) && (g_comMode == CONF_COM_MODE_USB) && (!usbmouse.isReady()))  // in usb mouse mode and usb mouse is not ready
-      || ((g_operatingMode == CONF_OPERATING_MODE_GAMEPAD) && !gamepad.isReady())){                                         // in usb gamepad mode and usb gamepad is not ready
+  } else if ((isMouseOperatingMode() && (g_comMode == CONF_COM_MODE_USB) && (!usbmouse.isReady()))                        // in usb mouse mode and usb mouse is not ready
+      || ((g_operatingMode == CONF_OPERATING_MODE_GAMEPAD) && (g_comMode == CONF_COM_MODE_USB) && !gamepad.isReady())){     // in usb gamepad mode and usb gamepad is not ready
 
     if (!screen.isMenuActive()) {
       screen.noUsbPage();
@@ -1006,22 +1356,81 @@ void initOperatingMode() {
 
 }
 
+//***IS MOUSE OPERATING MODE FUNCTION***//
+// Function   : isMouseOperatingMode
+//
+// Description: This function checks if the operating mode sends mouse reports.
+//
+// Parameters : void
+//
+// Return     : bool : true in mouse and absolute pointer mode
+//****************************************//
+bool isMouseOperatingMode() {
+  return (g_operatingMode == CONF_OPERATING_MODE_MOUSE || g_operatingMode == CONF_OPERATING_MODE_ABSOLUTE);
+}
+
+//***IS USB OPERATING MODE FUNCTION***//
+// Function   : isUsbOperatingMode
+//
+// Description: This function checks if an operating mode sends its reports on the USB HID interface.
+//              A standalone gamepad interface started in gamepad mode only carries the gamepad reports.
+//
+// Parameters : operatingMode : int : The operating mode to check
+//
+// Return     : bool : true in USB mouse, gamepad and absolute pointer mode
+//****************************************//
+bool isUsbOperatingMode(int operatingMode) {
+  if (usbHidGamepadOnly) {
+    return (operatingMode == CONF_OPERATING_MODE_GAMEPAD && g_comMode == CONF_COM_MODE_USB);
+  }
+  return (((operatingMode == CONF_OPERATING_MODE_MOUSE || operatingMode == CONF_OPERATING_MODE_GAMEPAD) && g_comMode == CONF_COM_MODE_USB)
+          || operatingMode == CONF_OPERATING_MODE_ABSOLUTE);
+}
+
 //***CHANGE OPERATING MODE FUNCTION***//
 // Function   : changeOperatingMode
 //
-// Description: This function configures the state of operation based on the current and desired operating mode
+// Description: This function configures the state of operation based on the current and desired operating mode.
+//              USB modes share the composite HID interface, so switching between them only releases the
+//              outputs of the current mode and changes which reports are sent. Leaving a standalone gamepad
+//              interface needs a reset.
 //
 // Parameters : inputOperatingMode : int : The operating mode to change to
 //
-// Return     : void
+// Return     : bool : false if the device must be reset to begin the new mode
 //****************************************//
-void changeOperatingMode(int inputOperatingState) {
+bool changeOperatingMode(int inputOperatingState) {
   if (inputOperatingState == g_operatingMode) {
-    // do nothing
-  } else {
-    softwareReset();
+    return true;
+  }
+  if (!isUsbOperatingMode(g_operatingMode) || !isUsbOperatingMode(inputOperatingState)) {
+    g_operatingMode = inputOperatingState;
+    return false;
   }
+
+  // Release the outputs of the current mode
+  releaseOutputAction();
+  stopDwell();
+  stopMacro();
+  if (g_operatingMode == CONF_OPERATING_MODE_GAMEPAD) {
+    gamepad.end();
+  }
+
   g_operatingMode = inputOperatingState;
+
+  switch (g_operatingMode) {
+    case CONF_OPERATING_MODE_MOUSE:
+    case CONF_OPERATING_MODE_ABSOLUTE:
+      usbmouse.setAbsolute(g_operatingMode == CONF_OPERATING_MODE_ABSOLUTE);
+      pointer.center();
+      usbmouse.begin();
+      break;
+    case CONF_OPERATING_MODE_GAMEPAD:
+      gamepad.begin();
+      break;
+  }
+  setLedDefault();
+  return true;
 }
 
 
@@ -1040,6 +1449,10 @@ void beginComOpMode() {
   initCommunicationMode();  // Retrieve communication mode from memory (None, USB, Bluetooth)
   initOperatingMode();      // Retrieve operating mode from memory (USB Mouse, Bluetooth Mouse, Gamepad)
 
+  usbmouse.setHighResolution(getHighResMode(false, false) == CONF_HIGH_RES_MODE_ON);  // Mouse format of the composite USB descriptor, read by the host when the device mounts
+  gamepad.setZAxis(getPressureOutputMode(false, false) == CONF_PRESS_OUTPUT_MODE_AXIS);  // The gamepad report only gets a Z axis when the pressure output uses it
+  btgamepad.setZAxis(getPressureOutputMode(false, false) == CONF_PRESS_OUTPUT_MODE_AXIS);
+
   switch (g_operatingMode) {
     case CONF_OPERATING_MODE_MOUSE:
       switch (g_comMode) {
@@ -1052,8 +1465,20 @@ void beginComOpMode() {
           break;
       }
       break;
-    case CONF_OPERATING_MODE_GAMEPAD:  // USB Gamepad
-      gamepad.begin();
+    case CONF_OPERATING_MODE_GAMEPAD:
+      switch (g_comMode) {
+        case CONF_COM_MODE_USB:  // USB Gamepad
+          gamepad.begin();
+          break;
+        case CONF_COM_MODE_BLE:  // Bluetooth Gamepad
+          String btName = String("LS_") + String(g_deviceUID);  // Form Bluetooth name using device UID
+          btgamepad.begin(btName.c_str());
+          break;
+      }
+      break;
+    case CONF_OPERATING_MODE_ABSOLUTE:  // USB Absolute pointer
+      usbmouse.setAbsolute(true);
+      usbmouse.begin();
       break;
     case CONF_OPERATING_MODE_SAFE: // Safe mode
       Serial.print("USBDEBUG: beginComOpMode: Safe Mode");
@@ -1088,19 +1513,29 @@ void initInput() {
   
   // Hub Input Buttons
   ib.begin();                                                                      // Begin input buttons
-  buttonActionSize = sizeof(buttonActionProperty) / sizeof(inputActionStruct);     // Size of total available input button actions
-  buttonActionMaxTime = getActionMaxTime(buttonActionSize, buttonActionProperty);  // Maximum button action end time
+  buttonActionTable.begin(actionMap.getInputTable(ACTION_MAP_TABLE_BUTTON), actionMap.getInputSize(ACTION_MAP_TABLE_BUTTON));  // Compile button action mapping
+  initActionCommit(&buttonActionCommit, &buttonActionTable, INPUT_REACTION_TIME);                              // Time each button action is decided
 
   // Hub External Switch Inputs
   is.begin();                                                                      // Begin input switches
-  switchActionSize = sizeof(switchActionProperty) / sizeof(inputActionStruct);     // Size of total available input switch actions
-  switchActionMaxTime = getActionMaxTime(switchActionSize, switchActionProperty);  // Maximum switch action end time
+  switchActionTable.begin(actionMap.getInputTable(ACTION_MAP_TABLE_SWITCH), actionMap.getInputSize(ACTION_MAP_TABLE_SWITCH));  // Compile switch action mapping
+  initActionCommit(&switchActionCommit, &switchActionTable, INPUT_REACTION_TIME);                              // Time each switch action is decided
+
+  // Chords of sip and puff, buttons and switches
+  chordActionTable.begin(actionMap.getInputTable(ACTION_MAP_TABLE_CHORD), actionMap.getInputSize(ACTION_MAP_TABLE_CHORD));  // Compile chord action mapping
+  chord.begin(&chordActionTable);
+
+  // Gesture sequences of sip and puff, buttons and switches
+  gestureSequenceSize = sizeof(gestureSequenceProperty) / sizeof(gestureSequenceStruct);  // Size of total available gesture sequences
+  gesture.begin(gestureSequenceProperty, gestureSequenceSize, CONF_GESTURE_TAP_TIME, CONF_GESTURE_SEQUENCE_TIMEOUT);
+  g_gestureMode = getGestureMode(false, false);                                          // Get gesture sequence mode stored in flash memory
 }
 
 //***INPUT LOOP FUNCTION***//
 // Function   : inputLoop
 //
-// Description: This function handles input button and input switch actions.
+// Description: This function reads input buttons and input switches and queues their input states.
+//              It is called from loop when an input edge was captured or an input is active.
 //
 // Parameters : void
 //
@@ -1117,96 +1552,579 @@ void inputLoop() {
   buttonState = ib.getInputState();
   switchState = is.getInputState();
 
-  // Evaluate Output Actions
-  evaluateOutputAction(buttonState, buttonActionMaxTime, buttonActionSize, buttonActionProperty);
-  evaluateOutputAction(switchState, switchActionMaxTime, switchActionSize, switchActionProperty);
+  // Queue input states for the event loop
+  pushInputEvent(CONF_GESTURE_SOURCE_BUTTON, buttonState, ib.getEventTime());
+  pushInputEvent(CONF_GESTURE_SOURCE_SWITCH, switchState, is.getEventTime());
+}
+
+//*********************************//
+// Input Event Functions
+//*********************************//
+
+//***PUSH INPUT EVENT FUNCTION***//
+// Function   : pushInputEvent
+//
+// Description: This function queues the input state of an input source for the event loop.
+//              The event is stamped with the time the state machine found the state, so an edge captured
+//              by a pin interrupt is ordered at the time it happened.
+//
+// Parameters : source : int : Input source (sip and puff, buttons or switches)
+//              actionState : inputStateStruct : Input state
+//              eventTime : unsigned long : Time in ms of the input state
+//
+// Return     : void
+//****************************************//
+void pushInputEvent(int source, inputStateStruct actionState, unsigned long eventTime) {
+  inputEventStruct inputEvent = { eventTime, EVENT_TYPE_INPUT, (uint8_t)source,
+                                  actionState.mainState, actionState.secondaryState, (long)actionState.elapsedTime };
+  eventQueue.push(inputEvent, EVENT_COALESCE_NONE);
+}
+
+//***PUSH PRESSURE EVENT FUNCTION***//
+// Function   : pushPressureEvent
+//
+// Description: This function queues the proportional pressure output for the event loop.
+//              Only the latest pending output is kept.
+//
+// Parameters : outputValue : float : Proportional output from -1.0 (full sip) to 1.0 (full puff)
+//
+// Return     : void
+//****************************************//
+void pushPressureEvent(float outputValue) {
+  inputEventStruct pressureEvent = { millis(), EVENT_TYPE_PRESSURE, 0, lround(outputValue * EVENT_PRESSURE_SCALE), 0, 0 };
+  eventQueue.push(pressureEvent, EVENT_COALESCE_REPLACE);
+}
+
+//***EVENT LOOP FUNCTION***//
+// Function   : eventLoop
+//
+// Description: This function performs the queued input events in time order. It is the only place
+//              the joystick, pressure and input loops reach the output actions.
+//              Held gestures or a pending sequence are performed once the next gesture did not arrive in time.
+//
+// Parameters : void
+//
+// Return     : void
+//****************************************//
+void eventLoop() {
+  inputEventStruct inputEvent;
+  while (eventQueue.pop(&inputEvent)) {
+    performEvent(inputEvent);
+  }
+
+  if (g_inputEnabled && gesture.isPending()) {
+    gesture.checkTimeout(millis());
+    performGestureOutput();
+  }
+}
+
+//***PERFORM EVENT FUNCTION***//
+// Function   : performEvent
+//
+// Description: This function performs one input event and records it in event debug mode.
+//
+// Parameters : inputEvent : inputEventStruct : Input event
+//
+// Return     : void
+//****************************************//
+void performEvent(inputEventStruct inputEvent) {
+  if (g_debugMode == CONF_DEBUG_MODE_EVENT) {
+    char eventRecord[EVENT_RECORD_MAX_LENGTH];
+    LSEventQueue::formatEvent(inputEvent, eventRecord, EVENT_RECORD_MAX_LENGTH);
+    Serial.println(eventRecord);
+  }
+
+  switch (inputEvent.eventType) {
+    case EVENT_TYPE_JOYSTICK:
+      {
+        pointIntType joyOutPoint = { (int)inputEvent.value1, (int)inputEvent.value2 };
+        performJoystick(joyOutPoint);
+        break;
+      }
+    case EVENT_TYPE_INPUT:
+      {
+        inputStateStruct actionState = { (int)inputEvent.value1, (int)inputEvent.value2, (unsigned long)inputEvent.value3 };
+        // Sips, puffs and gestures use the shortest connection interval, idle waiting states don't keep it
+        if (g_comMode == CONF_COM_MODE_BLE
+            && (actionState.secondaryState != INPUT_SEC_STATE_WAITING || actionState.mainState != INPUT_MAIN_STATE_NONE)) {
+          btconnection.setActive(millis());
+        }
+        evaluateChordInput(inputEvent.eventSource, actionState);
+        break;
+      }
+    case EVENT_TYPE_PRESSURE:
+      performPressureOutput((float)inputEvent.value1 / EVENT_PRESSURE_SCALE);
+      break;
+  }
+}
 
+//***EVALUATE CHORD INPUT FUNCTION***//
+// Function   : evaluateChordInput
+//
+// Description: This function combines the input state of a source with the inputs held on the other sources.
+//              A mapped chord performs its own action and replaces the actions of its inputs until each
+//              of them is released. A drag or scroll an input already started on its own is released when
+//              the chord claims it. Other input states are evaluated by their source.
+//
+// Parameters : source : int : Input source (sip and puff, buttons or switches)
+//              actionState : inputStateStruct : Input state
+//
+// Return     : void
+//****************************************//
+void evaluateChordInput(int source, inputStateStruct actionState) {
+  bool sourceClaimed = chord.isClaimed(source);  // The release of a claimed source is not evaluated
+
+  chord.update(source, actionState, millis());
+
+  // The chord replaces the actions of its inputs, including a committed drag or scroll
+  for (int chordSource = CONF_GESTURE_SOURCE_SAP; chordSource <= CONF_GESTURE_SOURCE_SWITCH; chordSource++) {
+    actionCommitStruct* actionCommit = getActionCommit(chordSource);
+    if (chord.isClaimed(chordSource) && actionCommit->committed) {
+      if (actionCommit->holdAction && (outputAction == CONF_ACTION_SCROLL || outputAction == CONF_ACTION_DRAG)) {
+        setLedDefault();
+        releaseOutputAction();
+        updateJoystickPollTimer(false);
+      }
+      actionCommit->committed = false;
+      actionCommit->holdAction = false;
+    }
+  }
+
+  if (chord.isActive()) {
+    evaluateOutputAction(chord.getState(), &chordActionTable);
+  }
+
+  if (!sourceClaimed && !chord.isClaimed(source)) {
+    evaluateInputAction(source, actionState);
+  }
 }
 
 //*********************************//
 // Sip and Puff Functions
 //*********************************//
 
-//***INITIALIZE SIP AND PUFF FUNCTION***//
-// Function   : initSipAndPuff
+//***INITIALIZE SIP AND PUFF FUNCTION***//
+// Function   : initSipAndPuff
+//
+// Description: This function initializes sip and puff as inputs.
+//
+// Parameters : void
+//
+// Return     : void
+//****************************************//
+void initSipAndPuff() {
+  if (USB_DEBUG) { Serial.println("USBDEBUG: Initializing Sip and Puff"); }
+  ps.begin();                                                             // Begin sip and puff
+  getSipPressureThreshold(false, false);                                  // Get sip  pressure thresholds stored in flash memory
+  getPuffPressureThreshold(false, false);                                 // Get puff pressure thresholds stored in flash memory
+  getHardSipPressureThreshold(false, false);                              // Get hard sip pressure threshold stored in flash memory
+  getHardPuffPressureThreshold(false, false);                             // Get hard puff pressure threshold stored in flash memory
+  getAdaptiveThresholdMode(false, false);                                 // Get adaptive threshold mode stored in flash memory
+  g_pressureOutputDeadband = getPressureOutputDeadband(false, false);     // Get proportional output deadband stored in flash memory
+  g_pressureOutputCurve = getPressureOutputCurve(false, false);           // Get proportional output curve stored in flash memory
+  g_pressureOutputMode = getPressureOutputMode(false, false);             // Get proportional output mode stored in flash memory
+  sapActionTable.begin(actionMap.getInputTable(ACTION_MAP_TABLE_SAP), actionMap.getInputSize(ACTION_MAP_TABLE_SAP));  // Compile sip and puff action mapping
+  initActionCommit(&sapActionCommit, &sapActionTable, 0);                                          // Time each sip and puff action is decided
+}
+
+
+//***INITIALIZE ACTION COMMIT FUNCTION***//
+// Function   : initActionCommit
+//
+// Description: This function finds, for each input main state, the elapsed time after which its output action is decided.
+//              Once the elapsed time reaches the start of the last action window, releasing later can't select
+//              another action, so the action of that window is performed without waiting for the release.
+//
+// Parameters : actionCommit : actionCommitStruct* : commit times to initialize
+//              actionTable : LSActionTable* : compiled action mapping
+//              debounceTime : unsigned long : time a started input can still change to another input state
+//
+// Return     : void
+//****************************************//
+void initActionCommit(actionCommitStruct* actionCommit, LSActionTable* actionTable, unsigned long debounceTime) {
+  actionCommit->commitTime[0] = ACTION_COMMIT_TIME_NEVER;  // No input
+  for (int stateIndex = 1; stateIndex < ACTION_COMMIT_STATE_NUMBER; stateIndex++) {
+    if (actionTable->getIntervalCount(stateIndex) == 0) {
+      actionCommit->commitTime[stateIndex] = ACTION_COMMIT_TIME_NEVER;
+    } else {
+      actionCommit->commitTime[stateIndex] = max(actionTable->getLastStartTime(stateIndex), debounceTime);
+    }
+  }
+
+  actionCommit->committed = false;
+  actionCommit->holdAction = false;
+}
+
+//***PRESSURE LOOP FUNCTION***//
+// Function   : pressureLoop
+//
+// Description: This function handles pressure polling and queues the sip and puff state or proportional output.
+//
+// Parameters : void
+//
+// Return     : void
+//****************************************//
+void pressureLoop() {
+  //if (USB_DEBUG) { Serial.println("USBDEBUG: pressureLoop()"); }
+  ps.update();  // Request new pressure difference from sensor and push it to array
+
+  //pressureValues = ps.getAllPressure();  // Read the pressure object (can be last value from array, average or other algorithms)
+
+  // Get the last state change
+  sapActionState = ps.getState();
+
+  // Output action logic
+  if (isPressureOutputActive()) {
+    pushPressureEvent(ps.getProportionalOutput(g_pressureOutputDeadband, g_pressureOutputCurve));
+  } else {
+    if (g_pressureOutputValue != 0.0) {
+      pushPressureEvent(0.0);  // Return proportional output to rest
+    }
+    pushInputEvent(CONF_GESTURE_SOURCE_SAP, sapActionState, ps.getEventTime());
+  }
+
+  // Save adapted sip and puff thresholds periodically
+  if (ps.isAdaptiveThresholdSaveDue(CONF_PRESS_ADAPTIVE_SAVE_INTERVAL)) {
+    mem.writeFloat(CONF_SETTINGS_FILE, "ST", ps.getSipThreshold());
+    mem.writeFloat(CONF_SETTINGS_FILE, "PT", ps.getPuffThreshold());
+  }
+}
+
+//***PRESSURE OUTPUT ACTIVE FUNCTION***//
+// Function   : isPressureOutputActive
+//
+// Description: This function checks if sip and puff pressure is used as a proportional output 
+//              in the current operating mode instead of performing actions.
+//
+// Parameters : void
+//
+// Return     : bool : true if proportional pressure output is active
+//****************************************//
+bool isPressureOutputActive() {
+  if (screen.isMenuActive()) {
+    return false;  // Sip and puff navigate the menu
+  }
+  switch (g_pressureOutputMode) {
+    case CONF_PRESS_OUTPUT_MODE_AXIS:
+      return (g_operatingMode == CONF_OPERATING_MODE_GAMEPAD);
+    case CONF_PRESS_OUTPUT_MODE_SCROLL:
+    case CONF_PRESS_OUTPUT_MODE_SPEED:
+      return isMouseOperatingMode();
+  }
+  return false;
+}
+
+//***PERFORM PRESSURE OUTPUT FUNCTION***//
+// Function   : performPressureOutput
+//
+// Description: This function applies the proportional pressure output for each pressure sample.
+//              Axis mode moves the gamepad Z axis when its value changes, scroll mode scrolls at a speed set by the pressure 
+//              and speed mode stores the output for performJoystick to scale the cursor speed.
+//
+// Parameters : outputValue : float : Proportional output from -1.0 (full sip) to 1.0 (full puff)
+//
+// Return     : void
+//****************************************//
+void performPressureOutput(float outputValue) {
+  g_pressureOutputValue = outputValue;
+
+  switch (g_pressureOutputMode) {
+    case CONF_PRESS_OUTPUT_MODE_AXIS:
+    {
+      // Only send a report when the axis value changes
+      int axisOutput = round(outputValue * CONF_JOY_OUTPUT_XY_MAX_GAMEPAD);
+      if (axisOutput == g_pressureOutputAxis) {
+        break;
+      }
+      g_pressureOutputAxis = axisOutput;
+      if (g_comMode == CONF_COM_MODE_USB) {
+        gamepad.zAxis(axisOutput);
+        gamepad.send();
+      } else if (g_comMode == CONF_COM_MODE_BLE) {
+        btgamepad.zAxis(axisOutput);
+        btgamepad.send();
+      }
+      break;
+    }
+    case CONF_PRESS_OUTPUT_MODE_SCROLL:
+    {
+      // Full output scrolls at the same maximum speed as joystick scrolling at the current scroll level
+      // The fraction of a detent is carried over by the mouse until the host gets a whole detent
+      int scrollOutput = round(outputValue * getScrollMaxSpeed(g_scrollLevel) * MOUSE_SCROLL_RESOLUTION * CONF_PRESSURE_POLL_RATE / float(CONF_SCROLL_MOVE_MAX * CONF_SCROLL_POLL_RATE));
+      if (scrollOutput != 0) {
+        if (g_comMode == CONF_COM_MODE_USB) {
+          usbmouse.smoothScroll(scrollOutput);
+        } else if (g_comMode == CONF_COM_MODE_BLE) {
+          btmouse.smoothScroll(scrollOutput);
+        }
+      }
+      break;
+    }
+    case CONF_PRESS_OUTPUT_MODE_SPEED:
+      break;  // Applied in performJoystick
+  }
+}
+
+//***RELEASE OUTPUT FUNCTION***//
+// Function   : releaseOutputAction
+//
+// Description: This function handles release of usbmouse hold actions.
+//
+// Parameters : void
+//
+// Return     : void
+//****************************************//
+void releaseOutputAction() {
+  // Release left click if it's in drag mode and left mouse button is pressed.
+  if (outputAction == CONF_ACTION_DRAG && (usbmouse.isPressed(MOUSE_LEFT) || btmouse.isPressed(MOUSE_LEFT))) {
+    usbmouse.release(MOUSE_LEFT);
+    btmouse.release(MOUSE_LEFT);
+  }
+  // Set new state of current output action
+  outputAction = CONF_ACTION_NOTHING;
+  canOutputAction = true;
+}
+
+//***EVALUATE INPUT ACTION FUNCTION***//
+// Function   : evaluateInputAction
+//
+// Description: This function performs the output action of an input as soon as it is decided.
+//              A started input whose elapsed time reaches its commit time performs its action without
+//              waiting for the release. A drag or scroll is then held until the input is released, and is
+//              cancelled if the input is held past the end of the action window.
+//              Other released gestures pass through the gesture sequence recognizer when gesture sequences
+//              are active, and are evaluated unless the recognizer holds them for a sequence.
+//
+// Parameters : source : int : Input source (sip and puff, buttons or switches)
+//              actionState : inputStateStruct : Input state
+//
+// Return     : void
+//****************************************//
+void evaluateInputAction(int source, inputStateStruct actionState) {
+  actionCommitStruct* actionCommit = getActionCommit(source);
+  bool gestureHeld = false;
+
+  // Action already performed: release held drag or scroll with the input, or once it is held past the action window
+  if (actionCommit->committed) {
+    bool cancelled = (actionState.secondaryState == INPUT_SEC_STATE_STARTED
+      && getSourceActionTable(source)->getAction(getActionTableMode(), actionState.mainState, actionState.elapsedTime) == ACTION_TABLE_NO_ACTION);
+    if (actionState.secondaryState != INPUT_SEC_STATE_STARTED || cancelled) {
+      if (actionCommit->holdAction && (outputAction == CONF_ACTION_SCROLL || outputAction == CONF_ACTION_DRAG)) {
+        setLedDefault();
+        releaseOutputAction();
+        updateJoystickPollTimer(false);
+      }
+      actionCommit->holdAction = false;
+    }
+    if (actionState.secondaryState != INPUT_SEC_STATE_STARTED) {
+      actionCommit->committed = false;
+    }
+    return;
+  }
+
+  // Action decided before release: perform it now
+  if (isActionCommitDue(source, actionState)) {
+    if (isGestureSequenceActive()) {
+      gesture.flush();         // Perform pending gestures first to keep their order
+      performGestureOutput();
+    }
+    inputStateStruct committedState = { actionState.mainState, INPUT_SEC_STATE_RELEASED, actionState.elapsedTime };
+    evaluateSourceAction(source, committedState);
+    actionCommit->committed = true;
+    actionCommit->holdAction = (outputAction == CONF_ACTION_SCROLL || outputAction == CONF_ACTION_DRAG);
+    return;
+  }
+
+  // A release during drag or scroll ends the hold action and is never part of a sequence
+  if (actionState.secondaryState == INPUT_SEC_STATE_RELEASED && isGestureSequenceActive()
+      && outputAction != CONF_ACTION_SCROLL && outputAction != CONF_ACTION_DRAG) {
+    gestureHeld = gesture.update(source, actionState, millis());
+    performGestureOutput();  // Perform earlier gestures or completed sequence first
+  }
+
+  if (!gestureHeld) {
+    evaluateSourceAction(source, actionState);
+  }
+}
+
+//***ACTION COMMIT DUE FUNCTION***//
+// Function   : isActionCommitDue
+//
+// Description: This function checks if the action of a started input is decided.
+//              The action is decided once the elapsed time is inside the last action window of the input state,
+//              as no longer window exists for it. A click is then performed at once, so holding past the window
+//              no longer cancels it. A drag or scroll toggled on by an earlier input is ended by the release,
+//              not at commit time. Sips and puffs that can still become hard, and inputs that can be part of a
+//              gesture sequence before the tap time, are not decided early.
+//
+// Parameters : source : int : Input source (sip and puff, buttons or switches)
+//              actionState : inputStateStruct : Input state
+//
+// Return     : bool : true if the action should be performed now
+//****************************************//
+bool isActionCommitDue(int source, inputStateStruct actionState) {
+  if (actionState.secondaryState != INPUT_SEC_STATE_STARTED
+      || actionState.mainState <= 0 || actionState.mainState >= ACTION_COMMIT_STATE_NUMBER
+      || !canOutputAction
+      || outputAction == CONF_ACTION_SCROLL || outputAction == CONF_ACTION_DRAG) {
+    return false;
+  }
+
+  unsigned long commitTime = getActionCommit(source)->commitTime[actionState.mainState];
+  if (commitTime == ACTION_COMMIT_TIME_NEVER) {
+    return false;
+  }
+
+  if (source == CONF_GESTURE_SOURCE_SAP && ps.canEscalate(actionState.mainState)) {
+    return false;
+  }
+
+  if (isGestureSequenceActive() && gesture.isGestureToken(CONF_GESTURE_TOKEN(source, actionState.mainState))) {
+    commitTime = max(commitTime, (unsigned long)CONF_GESTURE_TAP_TIME);
+  }
+
+  if (actionState.elapsedTime < commitTime) {
+    return false;
+  }
+
+  // Past the end of the last window nothing is performed
+  int commitAction = getSourceActionTable(source)->getAction(getActionTableMode(), actionState.mainState, actionState.elapsedTime);
+  return (commitAction != ACTION_TABLE_NO_ACTION);
+}
+
+//***GET ACTION COMMIT FUNCTION***//
+// Function   : getActionCommit
+//
+// Description: This function returns the action commit times of an input source.
+//
+// Parameters : source : int : Input source (sip and puff, buttons or switches)
+//
+// Return     : actionCommit : actionCommitStruct* : Action commit times of the source
+//****************************************//
+actionCommitStruct* getActionCommit(int source) {
+  switch (source) {
+    case CONF_GESTURE_SOURCE_BUTTON:
+      return &buttonActionCommit;
+    case CONF_GESTURE_SOURCE_SWITCH:
+      return &switchActionCommit;
+    default:
+      return &sapActionCommit;
+  }
+}
+
+//***GET SOURCE ACTION TABLE FUNCTION***//
+// Function   : getSourceActionTable
+//
+// Description: This function returns the compiled action mapping of an input source.
+//
+// Parameters : source : int : Input source (sip and puff, buttons or switches)
+//
+// Return     : actionTable : LSActionTable* : Compiled action mapping of the source
+//****************************************//
+LSActionTable* getSourceActionTable(int source) {
+  switch (source) {
+    case CONF_GESTURE_SOURCE_BUTTON:
+      return &buttonActionTable;
+    case CONF_GESTURE_SOURCE_SWITCH:
+      return &switchActionTable;
+    default:
+      return &sapActionTable;
+  }
+}
+
+//***EVALUATE SOURCE ACTION FUNCTION***//
+// Function   : evaluateSourceAction
 //
-// Description: This function initializes sip and puff as inputs.
+// Description: This function evaluates the output action of an input state using the action table of its source.
 //
-// Parameters : void
+// Parameters : source : int : Input source (sip and puff, buttons or switches)
+//              actionState : inputStateStruct : Input state
 //
 // Return     : void
 //****************************************//
-void initSipAndPuff() {
-  if (USB_DEBUG) { Serial.println("USBDEBUG: Initializing Sip and Puff"); }
-  ps.begin();                                                             // Begin sip and puff
-  getSipPressureThreshold(false, false);                                  // Get sip  pressure thresholds stored in flash memory
-  getPuffPressureThreshold(false, false);                                 // Get puff pressure thresholds stored in flash memory
-  sapActionSize = sizeof(sapActionProperty) / sizeof(inputActionStruct);  // Size of total available sip and puff actions
-  sapActionMaxTime = getActionMaxTime(sapActionSize, sapActionProperty);  // Maximum end action time
+void evaluateSourceAction(int source, inputStateStruct actionState) {
+  evaluateOutputAction(actionState, getSourceActionTable(source));
 }
 
-
-//***GET ACTION MAX TIME FUNCTION***//
-// Function   : getActionMaxTime
+//***GESTURE SEQUENCE ACTIVE FUNCTION***//
+// Function   : isGestureSequenceActive
 //
-// Description: This function finds the maximum end action time
+// Description: This function checks if gesture sequences are recognized in the current operating mode.
+//              The menu and safe mode always use single gestures.
 //
-// Parameters : actionSize : int : size of available actions
-//              actionProperty : const inputActionStruct : array of all possible actions
+// Parameters : void
 //
-// Return     : actionMaxTime : unsigned long : maximum end action time
+// Return     : bool : true if gesture sequences are active
 //****************************************//
-unsigned long getActionMaxTime(int actionSize, const inputActionStruct actionProperty[]) {
-  unsigned long actionMaxTime = 0;
-  // Loop over all possible outputs
-  for (int actionIndex = 0; actionIndex < actionSize; actionIndex++) {
-    if (actionMaxTime < actionProperty[actionIndex].inputActionEndTime) {
-      actionMaxTime = actionProperty[actionIndex].inputActionEndTime;
-    }
-  }
-  return actionMaxTime;
+bool isGestureSequenceActive() {
+  return (g_gestureMode == CONF_GESTURE_MODE_ON
+          && !screen.isMenuActive()
+          && (isMouseOperatingMode() || g_operatingMode == CONF_OPERATING_MODE_GAMEPAD));
 }
 
-//***PRESSURE LOOP FUNCTION***//
-// Function   : pressureLoop
+//***PERFORM GESTURE OUTPUT FUNCTION***//
+// Function   : performGestureOutput
 //
-// Description: This function handles pressure polling, sip and puff state evaluation.
+// Description: This function performs the outputs of the gesture sequence recognizer in order.
+//              Held gestures that did not complete a sequence perform their own action.
 //
 // Parameters : void
 //
 // Return     : void
 //****************************************//
-void pressureLoop() {
-  //if (USB_DEBUG) { Serial.println("USBDEBUG: pressureLoop()"); }
-  ps.update();  // Request new pressure difference from sensor and push it to array
-
-  //pressureValues = ps.getAllPressure();  // Read the pressure object (can be last value from array, average or other algorithms)
-
-  // Get the last state change
-  sapActionState = ps.getState();
-
-  // Output action logic
-  evaluateOutputAction(sapActionState, sapActionMaxTime, sapActionSize, sapActionProperty);
+void performGestureOutput() {
+  for (int outputIndex = 0; outputIndex < gesture.getOutputLength(); outputIndex++) {
+    gestureEventStruct gestureOutput = gesture.getOutput(outputIndex);
+    if (gestureOutput.source == CONF_GESTURE_SOURCE_SEQUENCE) {
+      performGestureSequenceAction(gestureOutput.state.mainState);
+    } else {
+      evaluateSourceAction(gestureOutput.source, gestureOutput.state);
+    }
+  }
 }
 
-//***RELEASE OUTPUT FUNCTION***//
-// Function   : releaseOutputAction
+//***PERFORM GESTURE SEQUENCE ACTION FUNCTION***//
+// Function   : performGestureSequenceAction
 //
-// Description: This function handles release of usbmouse hold actions.
+// Description: This function performs the output action of a completed gesture sequence.
 //
-// Parameters : void
+// Parameters : sequenceIndex : int : Index of the sequence in gestureSequenceProperty
 //
 // Return     : void
 //****************************************//
-void releaseOutputAction() {
-  // Release left click if it's in drag mode and left mouse button is pressed.
-  if (outputAction == CONF_ACTION_DRAG && (usbmouse.isPressed(MOUSE_LEFT) || btmouse.isPressed(MOUSE_LEFT))) {
-    usbmouse.release(MOUSE_LEFT);
-    btmouse.release(MOUSE_LEFT);
+void performGestureSequenceAction(int sequenceIndex) {
+  if (sequenceIndex < 0 || sequenceIndex >= gestureSequenceSize || !canOutputAction) {
+    return;
   }
-  // Set new state of current output action
-  outputAction = CONF_ACTION_NOTHING;
-  canOutputAction = true;
+
+  int tempActionIndex = CONF_ACTION_NOTHING;
+  switch (g_operatingMode) {
+    case CONF_OPERATING_MODE_MOUSE:
+    case CONF_OPERATING_MODE_ABSOLUTE:
+      tempActionIndex = gestureSequenceProperty[sequenceIndex].mouseOutputActionNumber;
+      break;
+    case CONF_OPERATING_MODE_GAMEPAD:
+      tempActionIndex = gestureSequenceProperty[sequenceIndex].gamepadOutputActionNumber;
+      break;
+  }
+
+  // Set Led state
+  setLedState(actionMap.getLedAction(tempActionIndex).ledEndAction,
+              actionMap.getLedAction(tempActionIndex).ledEndColor,
+              actionMap.getLedAction(tempActionIndex).ledNumber,
+              CONF_INPUT_LED_BLINK,
+              CONF_INPUT_LED_DELAY,
+              led.getLedBrightness());
+  outputAction = tempActionIndex;
+
+  // Perform led action
+  performLedAction(ledCurrentState);
+
+  // Perform output action
+  performOutputAction(tempActionIndex);
+
+  // Switch between joystick controlled scroll and joystick controlled cursor movement
+  updateJoystickPollTimer(false);
 }
 
 //***EVALUATE OUTPUT ACTION FUNCTION***//
@@ -1215,13 +2133,11 @@ void releaseOutputAction() {
 // Description: This function evaluates and performs output action
 //
 // Parameters : actionState : inputStateStruct : Current input state
-//              actionMaxEndTime : unsigned long : maximum end action time
-//              actionSize : int : size of available actions
-//              actionProperty : const inputActionStruct : array of all possible actions
+//              actionTable : LSActionTable* : compiled action mapping of the input source
 //
 // Return     : void
 //****************************************//
-void evaluateOutputAction(inputStateStruct actionState, unsigned long actionMaxEndTime, int actionSize, const inputActionStruct actionProperty[]) {
+void evaluateOutputAction(inputStateStruct actionState, LSActionTable* actionTable) {
   bool canEvaluateAction = true;
 
   // Output action logic
@@ -1234,102 +2150,105 @@ void evaluateOutputAction(inputStateStruct actionState, unsigned long actionMaxE
     releaseOutputAction();
     canEvaluateAction = false;
   }  // Detected input release after defined time limits.
-  else if (actionState.secondaryState == INPUT_SEC_STATE_RELEASED && actionState.elapsedTime > actionMaxEndTime) {
+  else if (actionState.secondaryState == INPUT_SEC_STATE_RELEASED && actionState.elapsedTime > actionTable->getMaxTime()) {
     // Set Led color to default
     setLedDefault();
   }
 
-  // Code to switch between joystick controlled scroll and joystick controlled cursor movement
-  if(g_joystickSensorConnected){
-    if (outputAction == CONF_ACTION_SCROLL) {
-      pollTimer.enable(CONF_TIMER_SCROLL);
-      pollTimer.disable(CONF_TIMER_JOYSTICK);
-    } else if (outputAction != CONF_ACTION_SCROLL) {
-      pollTimer.enable(CONF_TIMER_JOYSTICK);
-      pollTimer.disable(CONF_TIMER_SCROLL);
-    }
+  // Switch between joystick controlled scroll and joystick controlled cursor movement
+  updateJoystickPollTimer(false);
+
+  if (!canEvaluateAction || !canOutputAction || actionState.secondaryState == INPUT_SEC_STATE_WAITING) {
+    return;
   }
 
-  // Loop over all possible outputs
-  for (int actionIndex = 0; actionIndex < actionSize && canEvaluateAction && canOutputAction; actionIndex++) {
-    // Detected input release in defined time limits. Perform output action based on action index
-    if (actionState.mainState == actionProperty[actionIndex].inputActionState
-        && actionState.secondaryState == INPUT_SEC_STATE_RELEASED
-        && actionState.elapsedTime >= actionProperty[actionIndex].inputActionStartTime
-        && actionState.elapsedTime < actionProperty[actionIndex].inputActionEndTime) {
-      
-      // Get action index
-      if (screen.isMenuActive()) {
-        tempActionIndex = actionProperty[actionIndex].menuOutputActionNumber;
-      } else {
-        switch (g_operatingMode) {
-          case CONF_OPERATING_MODE_MOUSE:
-            tempActionIndex = actionProperty[actionIndex].mouseOutputActionNumber;
-            break;
-          case CONF_OPERATING_MODE_GAMEPAD:
-            tempActionIndex = actionProperty[actionIndex].gamepadOutputActionNumber;
-            break;
-          case CONF_OPERATING_MODE_SAFE:
-            tempActionIndex = actionProperty[actionIndex].safeModeOutputActionNumber;
-            break;
-        }
-      }
+  // Find the action window of the input state
+  tempActionIndex = actionTable->getAction(getActionTableMode(), actionState.mainState, actionState.elapsedTime);
+  if (tempActionIndex == ACTION_TABLE_NO_ACTION) {
+    return;
+  }
 
-      // Set Led color to default
-      //setLedDefault();
-      // Set Led state
-      setLedState(ledActionProperty[tempActionIndex].ledEndAction,
-                  ledActionProperty[tempActionIndex].ledEndColor,
-                  ledActionProperty[tempActionIndex].ledNumber,
-                  CONF_INPUT_LED_BLINK,
-                  CONF_INPUT_LED_DELAY,
-                  led.getLedBrightness());
-      outputAction = tempActionIndex;
+  // Detected input release in defined time limits. Perform output action based on action index
+  if (actionState.secondaryState == INPUT_SEC_STATE_RELEASED) {
+    // Set Led state
+    setLedState(actionMap.getLedAction(tempActionIndex).ledEndAction,
+                actionMap.getLedAction(tempActionIndex).ledEndColor,
+                actionMap.getLedAction(tempActionIndex).ledNumber,
+                CONF_INPUT_LED_BLINK,
+                CONF_INPUT_LED_DELAY,
+                led.getLedBrightness());
+    outputAction = tempActionIndex;
 
-      // Perform led action
-      performLedAction(ledCurrentState);
+    // Perform led action
+    performLedAction(ledCurrentState);
 
-      // Perform output action
-      performOutputAction(tempActionIndex);
+    // Perform output action
+    performOutputAction(tempActionIndex);
+
+    updateJoystickPollTimer(false);
+  }  // Detected input start in defined time limits. Perform led action based on action index
+  else if (actionState.secondaryState == INPUT_SEC_STATE_STARTED) {
+    // Set Led state
+    setLedState(LED_ACTION_ON,
+                actionMap.getLedAction(tempActionIndex).ledStartColor,
+                actionMap.getLedAction(tempActionIndex).ledNumber,
+                0,                     // number of blinks
+                0,                     // blink time
+                led.getLedBrightness());  // brightness
+    // Perform led action
+    performLedAction(ledCurrentState);
+  }
+}
 
-      break;
-    }  // Detected input start in defined time limits. Perform led action based on action index
-    else if (actionState.mainState == actionProperty[actionIndex].inputActionState
-             && actionState.secondaryState == INPUT_SEC_STATE_STARTED
-             && actionState.elapsedTime >= actionProperty[actionIndex].inputActionStartTime
-             && actionState.elapsedTime < actionProperty[actionIndex].inputActionEndTime) {
-      // Get action index
-      if (screen.isMenuActive()) {
-        tempActionIndex = actionProperty[actionIndex].menuOutputActionNumber;
-      } else {
-        switch (g_operatingMode) {
-          case CONF_OPERATING_MODE_MOUSE:
-            tempActionIndex = actionProperty[actionIndex].mouseOutputActionNumber;
-            break;
-          case CONF_OPERATING_MODE_GAMEPAD:
-            tempActionIndex = actionProperty[actionIndex].gamepadOutputActionNumber;
-            break;
-          case CONF_OPERATING_MODE_SAFE:
-            tempActionIndex = actionProperty[actionIndex].safeModeOutputActionNumber;
-            break;
-        }
-      }
+//***GET ACTION TABLE MODE FUNCTION***//
+// Function   : getActionTableMode
+//
+// Description: This function returns the action column used for the current operating mode and menu state.
+//
+// Parameters : void
+//
+// Return     : mode : int : ACTION_TABLE_MODE_MOUSE, _GAMEPAD, _MENU or _SAFE
+//****************************************//
+int getActionTableMode() {
+  if (screen.isMenuActive()) {
+    return ACTION_TABLE_MODE_MENU;
+  }
+  switch (g_operatingMode) {
+    case CONF_OPERATING_MODE_MOUSE:
+    case CONF_OPERATING_MODE_ABSOLUTE:
+      return ACTION_TABLE_MODE_MOUSE;
+    case CONF_OPERATING_MODE_GAMEPAD:
+      return ACTION_TABLE_MODE_GAMEPAD;
+    case CONF_OPERATING_MODE_SAFE:
+      return ACTION_TABLE_MODE_SAFE;
+  }
+  return ACTION_TABLE_MODE_MOUSE;
+}
 
-      // Set Led color to default
-      //setLedDefault();
-      // Set Led state
-      setLedState(LED_ACTION_ON,
-                  ledActionProperty[tempActionIndex].ledStartColor,
-                  ledActionProperty[tempActionIndex].ledNumber,
-                  0,                     // number of blinks
-                  0,                     // blink time
-                  led.getLedBrightness());  // brightness
-      // Perform led action
-      performLedAction(ledCurrentState);
+//***UPDATE JOYSTICK POLL TIMER FUNCTION***//
+// Function   : updateJoystickPollTimer
+//
+// Description: This function switches between joystick controlled scroll and joystick controlled cursor movement.
+//              The poll timers are only changed when the output action changed to or from scroll, unless forced.
+//
+// Parameters : forceUpdate : bool : set the poll timers even if scroll mode did not change
+//
+// Return     : void
+//****************************************//
+void updateJoystickPollTimer(bool forceUpdate) {
+  bool scrollActive = (outputAction == CONF_ACTION_SCROLL);
+  if (!g_joystickSensorConnected || (!forceUpdate && scrollActive == g_scrollPollActive)) {
+    return;
+  }
 
-      break;
-    }
+  if (scrollActive) {
+    pollTimer.enable(CONF_TIMER_SCROLL);
+    pollTimer.disable(CONF_TIMER_JOYSTICK);
+  } else {
+    pollTimer.enable(CONF_TIMER_JOYSTICK);
+    pollTimer.disable(CONF_TIMER_SCROLL);
   }
+  g_scrollPollActive = scrollActive;
 }
 
 //***PERFORM OUTPUT ACTION FUNCTION***//
@@ -1342,6 +2261,8 @@ void evaluateOutputAction(inputStateStruct actionState, unsigned long actionMaxE
 // Return     : void
 //****************************************//
 void performOutputAction(int action) {
+  stopDwell();  // An input action restarts dwell clicking after the next cursor motion
+
   switch (action) {
     case CONF_ACTION_NOTHING:
       {
@@ -1374,6 +2295,7 @@ void performOutputAction(int action) {
     case CONF_ACTION_CURSOR_CENTER:
       {
         screen.centerResetPage();  // Perform cursor center
+        pointer.center();          // The absolute pointer returns to the center of its region
         //setJoystickInitialization(true,false);
         break;
       }
@@ -1473,8 +2395,21 @@ void performOutputAction(int action) {
         doFactoryReset(true, false);  // Perform Factory Reset
         break;
       }
+    case CONF_ACTION_MACRO_1:
+    case CONF_ACTION_MACRO_2:
+    case CONF_ACTION_MACRO_3:
+    case CONF_ACTION_MACRO_4:
+      {
+        startMacro(action - CONF_ACTION_MACRO_1);  // Start macro, its steps are performed by the macro timer
+        break;
+      }
+    case CONF_ACTION_NEXT_HOST:
+      {
+        nextBluetoothHost(true, false);  // Switch to the next Bluetooth host
+        break;
+      }
   }
-  if (g_operatingMode == CONF_OPERATING_MODE_GAMEPAD) {
+  if (g_operatingMode == CONF_OPERATING_MODE_GAMEPAD && (action < CONF_ACTION_MACRO_1 || action > CONF_ACTION_MACRO_4)) {  // Macros release their own buttons
     //actionTimerId[0] = actionTimer.setTimeout(CONF_BUTTON_PRESS_DELAY, gamepadButtonRelease, (int *)action);
     actionTimerId[0] = actionTimer.setTimeout(CONF_BUTTON_PRESS_DELAY, gamepadButtonReleaseAll);  // TODO: Change this to just release one
     outputAction = CONF_ACTION_NOTHING;
@@ -1571,7 +2506,155 @@ void cursorDrag(void) {
 //****************************************//
 void cursorScroll(void) {
   outputAction = CONF_ACTION_SCROLL;
-  g_scrollNumRuns = 0;
+}
+
+
+//*********************************//
+// Macro Functions
+//*********************************//
+
+//***START MACRO FUNCTION***//
+// Function   : startMacro
+//
+// Description: This function starts a macro. A running macro is stopped and its held buttons and keys are released.
+//
+// Parameters : macroIndex : int : Macro (0 to CONF_MACRO_NUMBER - 1)
+//
+// Return     : void
+//****************************************//
+void startMacro(int macroIndex) {
+  if (macro.isRunning()) {
+    stopMacro();
+  }
+  if (macro.start(macroIndex)) {
+    macroTimerId[0] = macroTimer.setTimeout(0, macroLoop);
+  }
+}
+
+//***STOP MACRO FUNCTION***//
+// Function   : stopMacro
+//
+// Description: This function stops the running macro and releases any mouse button, key or gamepad button it holds.
+//
+// Parameters : void
+//
+// Return     : void
+//****************************************//
+void stopMacro() {
+  macro.stop();
+  macroRetrying = false;
+  if (macroTimerId[0] >= 0 && macroTimer.isEnabled(macroTimerId[0])) {
+    macroTimer.deleteTimer(macroTimerId[0]);  // Cancel the pending step
+  }
+
+  if (g_operatingMode == CONF_OPERATING_MODE_GAMEPAD) {
+    gamepadButtonReleaseAll();
+  } else if (g_comMode == CONF_COM_MODE_USB) {
+    usbmouse.release(MOUSE_ALL);
+    usbmouse.keyReleaseAll();
+  } else if (g_comMode == CONF_COM_MODE_BLE) {
+    btmouse.release(MOUSE_ALL);
+    btmouse.keyReleaseAll();
+  }
+}
+
+//***MACRO LOOP FUNCTION***//
+// Function   : macroLoop
+//
+// Description: This function performs the current step of the running macro and schedules the next step
+//              after the step delay. If the HID interface is busy, the step is retried after CONF_MACRO_RETRY_DELAY.
+//              The macro is stopped, and its held buttons and keys released, if the step is still held back after CONF_MACRO_RETRY_TIMEOUT.
+//
+// Parameters : void
+//
+// Return     : void
+//****************************************//
+void macroLoop() {
+  const macroStepStruct* step = macro.getStep();
+  if (step == NULL) {
+    return;
+  }
+
+  if (!performMacroStep(*step)) {
+    if (!macroRetrying) {
+      macroRetrying = true;
+      macroRetryMillis = millis();
+    } else if (millis() - macroRetryMillis > CONF_MACRO_RETRY_TIMEOUT) {
+      if (USB_DEBUG) { Serial.println("USBDEBUG: Macro stopped, HID interface busy"); }
+      stopMacro();
+      return;
+    }
+    macroTimerId[0] = macroTimer.setTimeout(CONF_MACRO_RETRY_DELAY, macroLoop);  // Interface busy, retry the same step
+    return;
+  }
+  macroRetrying = false;
+
+  unsigned long stepDelay = (unsigned long)step->stepDelay * CONF_MACRO_DELAY_UNIT;
+  macro.nextStep();
+  if (macro.isRunning()) {
+    macroTimerId[0] = macroTimer.setTimeout(stepDelay, macroLoop);
+  }
+}
+
+//***PERFORM MACRO STEP FUNCTION***//
+// Function   : performMacroStep
+//
+// Description: This function sends the HID report of a macro step. Mouse and keyboard steps use the current
+//              communication mode, gamepad steps are only sent in gamepad mode.
+//
+// Parameters : step : macroStepStruct : Step to perform
+//
+// Return     : bool : false if the interface is busy and the step should be retried
+//****************************************//
+bool performMacroStep(macroStepStruct step) {
+  bool isGamepadStep = (step.stepType >= CONF_MACRO_STEP_GAMEPAD_PRESS);
+  if (step.stepType == CONF_MACRO_STEP_WAIT || isGamepadStep != (g_operatingMode == CONF_OPERATING_MODE_GAMEPAD)) {
+    return true;  // Nothing to send in this mode
+  }
+
+  if (isGamepadStep) {
+    if ((g_comMode == CONF_COM_MODE_USB && !gamepad.isReady()) || (g_comMode == CONF_COM_MODE_BLE && !btgamepad.isReady())) {
+      return false;
+    }
+    switch (step.stepType) {
+      case CONF_MACRO_STEP_GAMEPAD_PRESS:
+        gamepadButtonPress(step.stepParameter1);
+        break;
+      case CONF_MACRO_STEP_GAMEPAD_RELEASE:
+        gamepadButtonRelease((int*)step.stepParameter1);
+        break;
+      case CONF_MACRO_STEP_GAMEPAD_RELEASE_ALL:
+        gamepadButtonReleaseAll();
+        break;
+    }
+    return true;
+  }
+
+  if (g_comMode == CONF_COM_MODE_USB) {
+    if (!usbmouse.isReady()) {
+      return false;
+    }
+    switch (step.stepType) {
+      case CONF_MACRO_STEP_MOUSE_PRESS:     usbmouse.press(step.stepParameter1); break;
+      case CONF_MACRO_STEP_MOUSE_RELEASE:   usbmouse.release(step.stepParameter1); break;
+      case CONF_MACRO_STEP_MOUSE_MOVE:      usbmouse.move((int8_t)step.stepParameter1, (int8_t)step.stepParameter2); break;
+      case CONF_MACRO_STEP_MOUSE_SCROLL:    usbmouse.scroll((int8_t)step.stepParameter1); break;
+      case CONF_MACRO_STEP_KEY_PRESS:       return usbmouse.keyPress(step.stepParameter1, step.stepParameter2);
+      case CONF_MACRO_STEP_KEY_RELEASE:     return usbmouse.keyRelease(step.stepParameter2);
+      case CONF_MACRO_STEP_KEY_RELEASE_ALL: return usbmouse.keyReleaseAll();
+    }
+  } else if (g_comMode == CONF_COM_MODE_BLE) {
+    switch (step.stepType) {
+      case CONF_MACRO_STEP_MOUSE_PRESS:     btmouse.press(step.stepParameter1); break;
+      case CONF_MACRO_STEP_MOUSE_RELEASE:   btmouse.release(step.stepParameter1); break;
+      case CONF_MACRO_STEP_MOUSE_MOVE:      btmouse.move((int8_t)step.stepParameter1, (int8_t)step.stepParameter2); break;
+      case CONF_MACRO_STEP_MOUSE_SCROLL:    btmouse.scroll((int8_t)step.stepParameter1); break;
+      case CONF_MACRO_STEP_KEY_PRESS:       btmouse.keyPress(step.stepParameter1, step.stepParameter2); break;
+      case CONF_MACRO_STEP_KEY_RELEASE:     btmouse.keyRelease(step.stepParameter2); break;
+      case CONF_MACRO_STEP_KEY_RELEASE_ALL: btmouse.keyReleaseAll(); break;
+    }
+  }
+  return true;
 }
 
 
@@ -1590,8 +2673,13 @@ void cursorScroll(void) {
 //****************************************//
 void gamepadButtonPress(int buttonNumber) {
   if (buttonNumber > 0 && buttonNumber <= 8) {
-    gamepad.press(buttonNumber - 1);
-    gamepad.send();  // Gamepad button press
+    if (g_comMode == CONF_COM_MODE_USB) {
+      gamepad.press(buttonNumber - 1);
+      gamepad.send();  // Gamepad button press
+    } else if (g_comMode == CONF_COM_MODE_BLE) {
+      btgamepad.press(buttonNumber - 1);
+      btgamepad.send();  // Bluetooth gamepad button press
+    }
   }
 }
 
@@ -1606,8 +2694,7 @@ void gamepadButtonPress(int buttonNumber) {
 //****************************************//
 void gamepadButtonClick(int buttonNumber) {
   if (buttonNumber > 0 && buttonNumber <= 8) {
-    gamepad.press(buttonNumber - 1);
-    gamepad.send();
+    gamepadButtonPress(buttonNumber);
     actionTimerId[0] = actionTimer.setTimeout(CONF_BUTTON_PRESS_DELAY, gamepadButtonRelease, (int*)buttonNumber);
   }
 }
@@ -1624,8 +2711,13 @@ void gamepadButtonClick(int buttonNumber) {
 void gamepadButtonRelease(int* args) {
   int buttonNumber = (int)args;
   if (buttonNumber > 0 && buttonNumber <= 8) {
-    gamepad.release(buttonNumber - 1);
-    gamepad.send();
+    if (g_comMode == CONF_COM_MODE_USB) {
+      gamepad.release(buttonNumber - 1);
+      gamepad.send();
+    } else if (g_comMode == CONF_COM_MODE_BLE) {
+      btgamepad.release(buttonNumber - 1);
+      btgamepad.send();
+    }
   }
 }
 
@@ -1640,8 +2732,13 @@ void gamepadButtonRelease(int* args) {
 // Return     : void
 //****************************************//
 void gamepadButtonReleaseAll() {
-  gamepad.releaseAll();  // Release all gamepad buttons
-  gamepad.send();
+  if (g_comMode == CONF_COM_MODE_USB) {
+    gamepad.releaseAll();  // Release all gamepad buttons
+    gamepad.send();
+  } else if (g_comMode == CONF_COM_MODE_BLE) {
+    btgamepad.releaseAll();  // Release all Bluetooth gamepad buttons
+    btgamepad.send();
+  }
 }
 
 
@@ -1667,6 +2764,12 @@ void initJoystick() {
   getJoystickOuterDeadzone(true, false);                                     // Get joystick deadzone stored in flash memory
   getCursorSpeed(true, false);                                          // Get joystick cursor speed stored in flash memory
   g_scrollLevel = getScrollLevel(true, false);                            // Get scroll level stored in flash memory
+  dwell.begin(CONF_DWELL_TIME_DEFAULT, CONF_DWELL_REST_RADIUS, CONF_DWELL_CANCEL_RADIUS);  // Begin dwell click detection
+  g_dwellMode = getDwellMode(false, false);                             // Get dwell click mode stored in flash memory
+  getDwellTime(false, false);                                           // Get dwell time stored in flash memory
+  getAbsoluteMode(false, false);                                        // Get absolute pointer settings stored in flash memory
+  getAbsoluteRegion(false, false);
+  getAbsoluteGrid(false, false);
   setJoystickInitialization(true, false);                               // Perform joystick center initialization
   getJoystickCalibration(true, false);                                  // Get joystick calibration points stored in flash memory
 }
@@ -1781,7 +2884,7 @@ void performJoystickCalibration(int* args) {
 
   if (stepNumber == 0) {                     // STEP 0: Calibration started
     pollTimer.disable(CONF_TIMER_JOYSTICK);  // Temporarily disable joystick data polling timer
-    pollTimer.disable(CONF_TIMER_INPUT);
+    g_inputEnabled = false;
     pollTimer.disable(CONF_TIMER_PRESSURE);
     setLedState(LED_ACTION_BLINK, CONF_JOY_CALIB_START_LED_COLOR, CONF_JOY_CALIB_LED_NUMBER, CONF_JOY_CALIB_STEP_BLINK, CONF_JOY_CALIB_STEP_BLINK_DELAY, led.getLedBrightness());
     performLedAction(ledCurrentState);
@@ -1815,9 +2918,10 @@ void performJoystickCalibration(int* args) {
     setLedDefault();
     canOutputAction = true;
     g_resetCenterComplete = true;
-    pollTimer.enable(CONF_TIMER_JOYSTICK);     // Re-Enable joystick data polling
-    pollTimer.enable(CONF_TIMER_SCROLL);       // Re-enable scroll data polling
-    pollTimer.enable(CONF_TIMER_INPUT);
+    updateJoystickPollTimer(true);             // Re-Enable joystick or scroll data polling
+    ib.clear();                                // Drop the button and switch edges queued during the calibration
+    is.clear();
+    g_inputEnabled = true;
     pollTimer.enable(CONF_TIMER_PRESSURE);
     screen.fullCalibrationPrompt(stepNumber);  // update
     g_calibrationError = false;
@@ -1891,7 +2995,7 @@ void performJoystickCalibrationStep(int* args) {
 //***JOYSTICK LOOP FUNCTION***//
 // Function   : joystickLoop
 //
-// Description: This function handles joystick move and scroll actions.
+// Description: This function reads the joystick and queues its output point for move and scroll actions.
 //
 // Parameters : void
 //
@@ -1904,7 +3008,9 @@ void joystickLoop() {
   pointIntType joyOutPoint = js.getXYOut();  // Read the filtered values
 
   if (g_resetCenterComplete) {     // Don't output joystick movement until the center position has been reset
-    performJoystick(joyOutPoint);  // Perform joystick move action
+    // The output point is the joystick position, so a newer point replaces a pending one
+    inputEventStruct joystickEvent = { millis(), EVENT_TYPE_JOYSTICK, 0, joyOutPoint.x, joyOutPoint.y, 0 };
+    eventQueue.push(joystickEvent, EVENT_COALESCE_REPLACE);
   }
 
   //if (USB_DEBUG) { Serial.println("USBDEBUG: End of joystickLoop");  }
@@ -1926,71 +3032,203 @@ void performJoystick(pointIntType inputPoint) {
     int maxMouse = js.getMouseSpeedRange();
     outputPoint.x = js.mapRoundInt(inputPoint.x, -CONF_JOY_OUTPUT_XY_MAX, CONF_JOY_OUTPUT_XY_MAX ,-maxMouse, maxMouse);
     outputPoint.y = js.mapRoundInt(inputPoint.y, -CONF_JOY_OUTPUT_XY_MAX, CONF_JOY_OUTPUT_XY_MAX ,-maxMouse, maxMouse);
+    // Scale cursor speed with sip and puff pressure
+    if (g_pressureOutputMode == CONF_PRESS_OUTPUT_MODE_SPEED && isPressureOutputActive()) {
+      float speedFactor = (g_pressureOutputValue >= 0.0) ? 1.0 + g_pressureOutputValue * (CONF_PRESS_OUTPUT_SPEED_FACTOR_MAX - 1.0) : 1.0 + g_pressureOutputValue;
+      outputPoint.x = round(outputPoint.x * speedFactor);
+      outputPoint.y = round(outputPoint.y * speedFactor);
+    }
     // 0 = None , 1 = USB , 2 = Wireless
     if (g_comMode == CONF_COM_MODE_USB) {
       //(outputAction == CONF_ACTION_SCROLL) ? usbmouse.scroll(scrollModifier(round(inputPoint.y),js.getMinimumRadius(),g_scrollLevel)) : usbmouse.move(accelerationModifier(round(inputPoint.x),js.getMinimumRadius(),acceleration), accelerationModifier(round(-inputPoint.y),js.getMinimumRadius(),acceleration)); // TODO Implement acceleration
-      (outputAction == CONF_ACTION_SCROLL) ? usbmouse.scroll(scrollModifier(round(inputPoint.y), CONF_JOY_OUTPUT_XY_MAX, g_scrollLevel)) : usbmouse.move(outputPoint.x, outputPoint.y);
+      (outputAction == CONF_ACTION_SCROLL) ? usbmouse.smoothScroll(scrollModifier(round(inputPoint.y), CONF_JOY_OUTPUT_XY_MAX, g_scrollLevel)) : usbmouse.move(outputPoint.x, outputPoint.y);
 
     } else if (g_comMode == CONF_COM_MODE_BLE) {
       //(outputAction == CONF_ACTION_SCROLL) ? btmouse.scroll(scrollModifier(round(inputPoint.y),js.getMinimumRadius(),g_scrollLevel)) : btmouse.move(accelerationModifier(round(inputPoint.x),js.getMinimumRadius(),acceleration), accelerationModifier(round(-inputPoint.y),js.getMinimumRadius(),acceleration)); // TODO Implement acceleration
-      (outputAction == CONF_ACTION_SCROLL) ? btmouse.scroll(scrollModifier(round(inputPoint.y), CONF_JOY_OUTPUT_XY_MAX, g_scrollLevel)) : btmouse.move(outputPoint.x, outputPoint.y);
+      if (outputAction == CONF_ACTION_SCROLL || outputPoint.x != 0 || outputPoint.y != 0) {
+        btconnection.setActive(millis());  // Shortest connection interval while the cursor moves
+      }
+      (outputAction == CONF_ACTION_SCROLL) ? btmouse.smoothScroll(scrollModifier(round(inputPoint.y), CONF_JOY_OUTPUT_XY_MAX, g_scrollLevel)) : btmouse.move(outputPoint.x, outputPoint.y);
+    }
+    if (outputPoint.x != 0 || outputPoint.y != 0) {
+      recordFirstMotion();  // Time to first cursor motion for SHOW_CONNECTION_TIME
     }
+    performDwell(outputPoint);  // Click once the cursor rests
   } else if (g_operatingMode == CONF_OPERATING_MODE_GAMEPAD) {
-    // Gamepad is USB only, if wireless gamepad functionality is added, add that here
     outputPoint.x = js.mapRoundInt(inputPoint.x, -CONF_JOY_OUTPUT_XY_MAX, CONF_JOY_OUTPUT_XY_MAX ,-CONF_JOY_OUTPUT_XY_MAX_GAMEPAD, CONF_JOY_OUTPUT_XY_MAX_GAMEPAD);
     outputPoint.y = js.mapRoundInt(inputPoint.y, -CONF_JOY_OUTPUT_XY_MAX, CONF_JOY_OUTPUT_XY_MAX ,-CONF_JOY_OUTPUT_XY_MAX_GAMEPAD, CONF_JOY_OUTPUT_XY_MAX_GAMEPAD);
-    gamepad.move(outputPoint.x, outputPoint.y);
-    gamepad.send();
+    if (g_comMode == CONF_COM_MODE_USB) {
+      gamepad.move(outputPoint.x, outputPoint.y);
+      gamepad.send();
+    } else if (g_comMode == CONF_COM_MODE_BLE) {
+      if (outputPoint.x != 0 || outputPoint.y != 0) {
+        btconnection.setActive(millis());
+      }
+      btgamepad.move(outputPoint.x, outputPoint.y);
+      btgamepad.send();  // Only a changed report is sent
+    }
+  } else if (g_operatingMode == CONF_OPERATING_MODE_ABSOLUTE) {
+    // Absolute pointer is USB only
+    if (outputAction == CONF_ACTION_SCROLL) {
+      usbmouse.smoothScroll(scrollModifier(round(inputPoint.y), CONF_JOY_OUTPUT_XY_MAX, g_scrollLevel));
+    } else {
+      long lastX = pointer.getX();
+      long lastY = pointer.getY();
+      if (g_absoluteMode == CONF_ABS_MODE_DIRECT) {
+        pointer.setDeflection(inputPoint.x, inputPoint.y, CONF_JOY_OUTPUT_XY_MAX);  // Spring return to the center of the region
+      } else {
+        int maxMouse = js.getMouseSpeedRange();
+        long moveX = js.mapRoundInt(inputPoint.x, -CONF_JOY_OUTPUT_XY_MAX, CONF_JOY_OUTPUT_XY_MAX, -maxMouse, maxMouse);
+        long moveY = js.mapRoundInt(inputPoint.y, -CONF_JOY_OUTPUT_XY_MAX, CONF_JOY_OUTPUT_XY_MAX, -maxMouse, maxMouse);
+        pointer.move(moveX * CONF_ABS_MOTION_SCALE, moveY * CONF_ABS_MOTION_SCALE);
+      }
+      usbmouse.moveTo(pointer.getX(), pointer.getY());
+      // Dwell clicking measures the motion of the reported position in mouse units
+      outputPoint.x = (pointer.getX() - lastX) / CONF_ABS_MOTION_SCALE;
+      outputPoint.y = (pointer.getY() - lastY) / CONF_ABS_MOTION_SCALE;
+      if (outputPoint.x != 0 || outputPoint.y != 0) {
+        recordFirstMotion();
+      }
+    }
+    performDwell(outputPoint);
+  }
+}
+
+//***SET ABSOLUTE REGION PROPERTY FUNCTION***//
+// Function   : setAbsoluteRegionProperty
+//
+// Description: This function limits the absolute pointer to a screen region of absoluteRegionProperty.
+//
+// Parameters : regionIndex : int : Index of the screen region
+//
+// Return     : void
+//****************************************//
+void setAbsoluteRegionProperty(int regionIndex) {
+  absoluteRegionStruct region = absoluteRegionProperty[regionIndex];
+  pointer.setRegion(region.regionLeft, region.regionTop, region.regionRight, region.regionBottom);
+}
+
+//***PERFORM DWELL FUNCTION***//
+// Function   : performDwell
+//
+// Description: This function performs a dwell click once the cursor rested for the dwell time.
+//              The left LED lights after a third of the dwell time and the middle LED after two thirds,
+//              the click is performed at the end of the dwell time.
+//
+// Parameters : outputPoint : pointIntType : The cursor motion of the joystick sample
+//
+// Return     : void
+//****************************************//
+void performDwell(pointIntType outputPoint) {
+  if (g_dwellMode == CONF_DWELL_MODE_OFF || screen.isMenuActive() || outputAction == CONF_ACTION_SCROLL) {
+    stopDwell();
+    return;
+  }
+
+  switch (dwell.update(outputPoint.x, outputPoint.y, millis())) {
+    case DWELL_EVENT_STAGE:
+      led.setLedColor(CONF_LED_LEFT + dwell.getStage() - 1, CONF_DWELL_LED_COLOR, led.getLedBrightness());  // Next countdown LED
+      break;
+    case DWELL_EVENT_CANCEL:
+      setLedDefault();
+      break;
+    case DWELL_EVENT_CLICK:
+      setLedDefault();
+      performDwellClick();
+      break;
+  }
+}
+
+//***STOP DWELL FUNCTION***//
+// Function   : stopDwell
+//
+// Description: This function stops the dwell countdown and clears the countdown LEDs.
+//              The next countdown starts after the cursor leaves the cancel zone.
+//
+// Parameters : void
+//
+// Return     : void
+//****************************************//
+void stopDwell() {
+  if (dwell.getStage() > 0) {
+    setLedDefault();
+  }
+  dwell.clear();
+}
+
+//***PERFORM DWELL CLICK FUNCTION***//
+// Function   : performDwellClick
+//
+// Description: This function performs the click of the dwell click mode.
+//              Drag toggle presses the left button, and releases it at the next dwell click.
+//
+// Parameters : void
+//
+// Return     : void
+//****************************************//
+void performDwellClick() {
+  switch (g_dwellMode) {
+    case CONF_DWELL_MODE_LEFT_CLICK:
+      cursorLeftClick();
+      break;
+    case CONF_DWELL_MODE_RIGHT_CLICK:
+      cursorRightClick();
+      break;
+    case CONF_DWELL_MODE_DOUBLE_CLICK:
+      cursorLeftClick();
+      cursorLeftClick();
+      break;
+    case CONF_DWELL_MODE_DRAG:
+      if (outputAction == CONF_ACTION_DRAG) {
+        releaseOutputAction();
+      } else {
+        outputAction = CONF_ACTION_DRAG;
+        cursorDrag();
+      }
+      break;
   }
 }
 
 //***SCROLL MOVEMENT MODIFIER FUNCTION***//
 // Function   : scrollModifier
 //
-// Description: This function converts y cursor movements to y scroll movements based on y cursor value and scroll speed level.
+// Description: This function converts y cursor movements to smooth scroll movements based on y cursor value and scroll speed level.
+//              The scroll speed is a continuous function of the joystick deflection, from one detent every
+//              CONF_SCROLL_MOVE_MAX scroll polls up to one detent every poll.
 //
 // Parameters : cursorValue : const int : y cursor value.
 //              cursorMaxValue : const int : maximum y cursor value.
 //              scrollLevelValue : const int : scroll speed level value.
 //
-// Return     : cursorOutput : int : The modified scroll value.
+// Return     : scrollOutput : int : The scroll motion of this poll in 1/MOUSE_SCROLL_RESOLUTION detents.
 //****************************************//
 int scrollModifier(const int cursorValue, const int cursorMaxValue, const int scrollLevelValue) {
-  int scrollOutput = 0;
-
-  //int scrollMaxSpeed = round((1.0 * pow(CONF_SCROLL_MOVE_MAX, scrollLevelValue / 10.0)) + CONF_SCROLL_MOVE_BASE);
-  //int scrollMaxSpeed = round((1.0 * pow(CONF_SCROLL_MOVE_MAX, scrollLevelValue / CONF_SCROLL_LEVEL_MAX)) + CONF_SCROLL_MOVE_BASE);
-  int scrollMaxSpeed = round((1.0 * CONF_SCROLL_MOVE_MAX * scrollLevelValue/CONF_SCROLL_LEVEL_MAX) + CONF_SCROLL_MOVE_BASE); // Max scroll speed at a given scroll level
-
-  //scrollOutput = map(cursorValue, 0, cursorMaxValue, 0, scrollMaxSpeed);
-  //scrollOutput = -1 * constrain(scrollOutput, -1 * scrollMaxSpeed, scrollMaxSpeed);
-
-  scrollOutput = round(float(cursorValue) * float(scrollMaxSpeed) / float(cursorMaxValue));     // Actual scroll output based on amount of joystick movement
-  scrollOutput = -1 * constrain(scrollOutput, -1 * scrollMaxSpeed, scrollMaxSpeed);
+  if (cursorValue == 0) {
+    return 0;
+  }
 
+  float scrollMaxSpeed = getScrollMaxSpeed(scrollLevelValue); // Max scroll speed at a given scroll level
+  float scrollSpeed = constrain(abs(cursorValue) * scrollMaxSpeed / float(cursorMaxValue), 0.0f, scrollMaxSpeed);  // Scroll speed based on amount of joystick movement
+  float scrollPeriod = max(1.0f, float(CONF_SCROLL_MOVE_MAX) - scrollSpeed);  // Scroll polls per detent
 
-  //Serial.print(cursorValue);  Serial.print("\t");
-  //Serial.print(cursorMaxValue); Serial.print("\t");
-  //Serial.println(scrollOutput);  
+  int scrollOutput = round(MOUSE_SCROLL_RESOLUTION / scrollPeriod);
+  return (cursorValue < 0) ? scrollOutput : -scrollOutput;
+}
 
-  if (g_scrollNumRuns % (CONF_SCROLL_MOVE_MAX - abs(scrollOutput)) == 0){
-    if (cursorValue < 0) {
-      scrollOutput = 1;
-    } else if (cursorValue > 0){
-      scrollOutput = -1;
-    } else { 
-      scrollOutput = 0;
-    }
-    g_scrollNumRuns = 0;
-  } else {
-    scrollOutput = 0;
-  }
 
-  g_scrollNumRuns++;
-  return scrollOutput;
+//***SCROLL MAX SPEED FUNCTION***//
+// Function   : getScrollMaxSpeed
+//
+// Description: This function returns the maximum scroll speed at a scroll level.
+//
+// Parameters : scrollLevelValue : const int : scroll speed level value.
+//
+// Return     : scrollMaxSpeed : int : The maximum scroll speed.
+//****************************************//
+int getScrollMaxSpeed(const int scrollLevelValue) {
+  return round((1.0 * CONF_SCROLL_MOVE_MAX * scrollLevelValue/CONF_SCROLL_LEVEL_MAX) + CONF_SCROLL_MOVE_BASE);
 }
 
-
 //***ACCELERATION MOVEMENT MODIFIER FUNCTION***//
 // Function   : accelerationModifier
 //
@@ -2099,14 +3337,16 @@ void setDebugState(int inputDebugMode) {
   }
 
   if (inputDebugMode == CONF_DEBUG_MODE_NONE) {
-    pollTimer.enable(CONF_TIMER_JOYSTICK);  // Enable joystick data polling
+    updateJoystickPollTimer(true);          // Enable joystick or scroll data polling
     pollTimer.disable(CONF_TIMER_DEBUG);    // Disable debug data polling
-    pollTimer.enable(CONF_TIMER_SCROLL);    // Enable scroll data polling
 
   } else if (inputDebugMode == CONF_DEBUG_MODE_JOYSTICK) {
     pollTimer.disable(CONF_TIMER_JOYSTICK);  // Disable joystick data polling
     pollTimer.disable(CONF_TIMER_SCROLL);    // Disable scroll data polling
     pollTimer.enable(CONF_TIMER_DEBUG);      // Enable debug data polling
+  } else if (inputDebugMode == CONF_DEBUG_MODE_EVENT) {
+    updateJoystickPollTimer(true);          // Enable joystick or scroll data polling
+    pollTimer.disable(CONF_TIMER_DEBUG);    // Events are printed by the event loop
   } else {
     pollTimer.enable(CONF_TIMER_DEBUG);  // Enable debug data polling
   }
@@ -2470,7 +3710,16 @@ void setLedDefault() {
       }
     case CONF_OPERATING_MODE_GAMEPAD:
       {
-        led.setLedColor(CONF_LED_MICRO, LED_CLR_YELLOW, led.getLedBrightness());
+        if (g_comMode == CONF_COM_MODE_USB) {
+          led.setLedColor(CONF_LED_MICRO, LED_CLR_YELLOW, led.getLedBrightness());
+        } else if (g_comMode == CONF_COM_MODE_BLE && btgamepad.isConnected()) {  // Set micro LED to blue if it's in BLE MODE
+          led.setLedColor(CONF_BT_LED_NUMBER, LED_CLR_BLUE, led.getLedBrightness());
+        }
+        break;
+      }
+    case CONF_OPERATING_MODE_ABSOLUTE:
+      {
+        led.setLedColor(CONF_LED_MICRO, CONF_ABS_LED_COLOR, led.getLedBrightness());
         break;
       }
     case CONF_OPERATING_MODE_SAFE:
@@ -2574,6 +3823,7 @@ void softwareReset() {
   usbmouse.end();
   gamepad.end();
   btmouse.end();
+  btgamepad.end();
 
   delay(3000);
   screen.clear();
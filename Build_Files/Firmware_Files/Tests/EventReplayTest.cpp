@@ -0,0 +1,169 @@
+/*
+* File: EventReplayTest.cpp
+* Firmware: LipSync
+* Developed by: MakersMakingChange
+* Version: v4.1 (28 March 2025)
+  License: GPL v3.0 or later
+
+  Copyright (C) 2024 - 2025 Neil Squire Society
+  This program is free software: you can redistribute it and/or modify it under the terms of
+  the GNU General Public License as published by the Free Software Foundation,
+  either version 3 of the License, or (at your option) any later version.
+  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License along with this program.
+  If not, see <http://www.gnu.org/licenses/>
+*/
+
+// Host replay of recorded input events. The event debug mode prints each event as an EVENT line;
+// the lines are parsed, pushed into the event queue in the order they were captured and performed
+// in event time order, as the event loop of the firmware does.
+//
+// Build and run from this folder:
+//   g++ -std=c++11 -Wall -Wextra -I../LipSync_Firmware EventReplayTest.cpp -o EventReplayTest && ./EventReplayTest
+// Replay a capture saved from the serial monitor instead of the built in one:
+//   ./EventReplayTest capture.txt
+
+#include <stdio.h>
+#include "LSEventQueue.h"
+
+#define TEST_SOURCE_SAP 1
+#define TEST_SOURCE_BUTTON 2
+#define TEST_STATE_STARTED 1
+#define TEST_STATE_RELEASED 2
+#define TEST_MAX_EVENTS 64
+
+// Joystick sampled at 1000 ms, then a button press the pin interrupt captured at 990 ms and a puff with
+// its onset at 1010 ms. The joystick sample at 1125 ms replaces the values of the pending one at 1025 ms,
+// which keeps its place, and the button release captured at 1120 ms follows it.
+const char* testCapture[] = {
+  "EVENT,1000,1,0,5,-3,0",
+  "EVENT,990,2,2,1,1,0",
+  "EVENT,1010,2,1,2,1,15",
+  "EVENT,1025,1,0,8,-4,0",
+  "EVENT,1125,1,0,2,0,0",
+  "EVENT,1120,2,2,1,2,130",
+  "EVENT,1130,3,0,250,0,0",
+  "EVENT,1135,3,0,-100,0,0",
+};
+
+int failCount = 0;
+
+void check(const char* step, bool condition)
+{
+  if (!condition) {
+    printf("FAIL %s\n", step);
+    failCount++;
+  }
+}
+
+// Coalescing used by the firmware for each event type
+int getCoalesce(const inputEventStruct& event)
+{
+  return (event.eventType == EVENT_TYPE_INPUT) ? EVENT_COALESCE_NONE : EVENT_COALESCE_REPLACE;
+}
+
+// Push the captured lines in capture order and pop them in event time order
+int replay(const char* const* lines, int lineNumber, inputEventStruct* performed, int performedSize)
+{
+  LSEventQueue queue;
+  int performedNumber = 0;
+  for (int lineIndex = 0; lineIndex < lineNumber; lineIndex++) {
+    inputEventStruct event;
+    if (!LSEventQueue::parseEvent(lines[lineIndex], &event)) {
+      continue;  // Other serial output
+    }
+    queue.push(event, getCoalesce(event));
+  }
+  inputEventStruct event;
+  while (queue.pop(&event) && performedNumber < performedSize) {
+    performed[performedNumber++] = event;
+  }
+  return performedNumber;
+}
+
+void printEvent(const inputEventStruct& event)
+{
+  char eventRecord[EVENT_RECORD_MAX_LENGTH];
+  LSEventQueue::formatEvent(event, eventRecord, EVENT_RECORD_MAX_LENGTH);
+  printf("%s\n", eventRecord);
+}
+
+// A formatted event is parsed back to the same event
+void testRecordRoundTrip()
+{
+  inputEventStruct event = { 4294967000UL, EVENT_TYPE_INPUT, TEST_SOURCE_BUTTON, 3, TEST_STATE_RELEASED, 1234 };
+  char eventRecord[EVENT_RECORD_MAX_LENGTH];
+  LSEventQueue::formatEvent(event, eventRecord, EVENT_RECORD_MAX_LENGTH);
+  inputEventStruct parsed;
+  check("round trip parse", LSEventQueue::parseEvent(eventRecord, &parsed));
+  check("round trip values", parsed.eventTime == event.eventTime && parsed.eventType == event.eventType
+        && parsed.eventSource == event.eventSource && parsed.value1 == event.value1
+        && parsed.value2 == event.value2 && parsed.value3 == event.value3);
+  check("other output ignored", !LSEventQueue::parseEvent("SUCCESS,0:BS,0:0,0,-1,0,0,0", &parsed));
+}
+
+// The captured events are performed by event time, the input edges before the later joystick samples
+void testReplayOrder()
+{
+  inputEventStruct performed[TEST_MAX_EVENTS];
+  int performedNumber = replay(testCapture, sizeof(testCapture) / sizeof(testCapture[0]), performed, TEST_MAX_EVENTS);
+
+  // The joystick and pressure samples are only merged with a pending sample after the last input event
+  check("event number", performedNumber == 6);
+  for (int eventIndex = 1; eventIndex < performedNumber; eventIndex++) {
+    check("time order", (long)(performed[eventIndex].eventTime - performed[eventIndex - 1].eventTime) >= 0);
+  }
+  check("button press first", performed[0].eventType == EVENT_TYPE_INPUT && performed[0].eventSource == TEST_SOURCE_BUTTON
+        && performed[0].value2 == TEST_STATE_STARTED);
+  check("joystick before puff", performed[1].eventType == EVENT_TYPE_JOYSTICK && performed[1].value1 == 5);
+  check("puff onset", performed[2].eventType == EVENT_TYPE_INPUT && performed[2].eventSource == TEST_SOURCE_SAP);
+  check("joystick coalesced", performed[3].eventType == EVENT_TYPE_JOYSTICK && performed[3].value1 == 2);
+  check("button release", performed[4].eventType == EVENT_TYPE_INPUT && performed[4].value2 == TEST_STATE_RELEASED
+        && performed[4].value3 == 130);
+  check("pressure replaced", performed[performedNumber - 1].eventType == EVENT_TYPE_PRESSURE
+        && performed[performedNumber - 1].value1 == -100);
+}
+
+// Replay a capture file and print the events in the order they are performed
+int replayFile(const char* fileName)
+{
+  static char lineBuffer[TEST_MAX_EVENTS][EVENT_RECORD_MAX_LENGTH + 16];
+  const char* lines[TEST_MAX_EVENTS];
+  FILE* file = fopen(fileName, "r");
+  if (file == NULL) {
+    printf("Can't open %s\n", fileName);
+    return 1;
+  }
+  int lineNumber = 0;
+  while (lineNumber < TEST_MAX_EVENTS && fgets(lineBuffer[lineNumber], sizeof(lineBuffer[lineNumber]), file) != NULL) {
+    lines[lineNumber] = lineBuffer[lineNumber];
+    lineNumber++;
+  }
+  fclose(file);
+
+  inputEventStruct performed[TEST_MAX_EVENTS];
+  int performedNumber = replay(lines, lineNumber, performed, TEST_MAX_EVENTS);
+  for (int eventIndex = 0; eventIndex < performedNumber; eventIndex++) {
+    printEvent(performed[eventIndex]);
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc > 1) {
+    return replayFile(argv[1]);
+  }
+
+  testRecordRoundTrip();
+  testReplayOrder();
+
+  if (failCount == 0) {
+    printf("All checks passed\n");
+    return 0;
+  }
+  printf("%d checks failed\n", failCount);
+  return 1;
+}
@@ -0,0 +1,151 @@
+/*
+* File: InputStateMachineTest.cpp
+* Firmware: LipSync
+* Developed by: MakersMakingChange
+* Version: v4.1 (28 March 2025)
+  License: GPL v3.0 or later
+
+  Copyright (C) 2024 - 2025 Neil Squire Society
+  This program is free software: you can redistribute it and/or modify it under the terms of
+  the GNU General Public License as published by the Free Software Foundation,
+  either version 3 of the License, or (at your option) any later version.
+  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License along with this program.
+  If not, see <http://www.gnu.org/licenses/>
+*/
+
+// Host test of the input state machine with a fake clock. It is kept outside the sketch folder
+// so the Arduino IDE doesn't build it with the firmware.
+//
+// Build and run from this folder:
+//   g++ -std=c++11 -Wall -Wextra -I../LipSync_Firmware InputStateMachineTest.cpp -o InputStateMachineTest && ./InputStateMachineTest
+
+#include <stdio.h>
+#include "LSInputStateMachine.h"
+
+#define TEST_NONE 0
+#define TEST_SOFT 1
+#define TEST_OTHER 2
+#define TEST_HARD 3
+
+// Test policy : 50 ms debounce, soft input can be raised to hard while started
+struct TestPolicy {
+  static constexpr int noneState = TEST_NONE;
+  static constexpr unsigned long debounceTime = 50;
+  static constexpr unsigned long idleTimeout = 1000;
+  static bool mergeState(int prevMainState, int newMainState, unsigned long elapsedTime) {
+    (void)elapsedTime;  // Merged at any time while started
+    return (prevMainState == TEST_SOFT && newMainState == TEST_HARD);
+  }
+};
+
+int failCount = 0;
+
+void checkState(const char* step, InputStateMachine<TestPolicy>& machine, int mainState, int secondaryState, unsigned long elapsedTime)
+{
+  inputStateStruct state = machine.getState();
+  if (state.mainState != mainState || state.secondaryState != secondaryState || state.elapsedTime != elapsedTime) {
+    printf("FAIL %s : got {%d, %d, %lu} expected {%d, %d, %lu}\n", step,
+      state.mainState, state.secondaryState, (unsigned long)state.elapsedTime, mainState, secondaryState, elapsedTime);
+    failCount++;
+  }
+}
+
+void checkNewState(const char* step, bool newState, bool expected)
+{
+  if (newState != expected) {
+    printf("FAIL %s : new state %d expected %d\n", step, newState, expected);
+    failCount++;
+  }
+}
+
+// WAITING -> STARTED -> RELEASED -> WAITING, with the full input duration reported on release
+void testPressRelease()
+{
+  InputStateMachine<TestPolicy> machine;
+  machine.clear(0);
+  checkState("clear", machine, TEST_NONE, INPUT_SEC_STATE_WAITING, 0);
+
+  checkNewState("wait", machine.update(TEST_NONE, 10), false);
+  checkState("wait", machine, TEST_NONE, INPUT_SEC_STATE_WAITING, 10);
+
+  checkNewState("start", machine.update(TEST_SOFT, 100), true);
+  checkState("start", machine, TEST_SOFT, INPUT_SEC_STATE_STARTED, 0);
+
+  checkNewState("hold", machine.update(TEST_SOFT, 250), false);
+  checkState("hold", machine, TEST_SOFT, INPUT_SEC_STATE_STARTED, 150);
+
+  checkNewState("release", machine.update(TEST_NONE, 300), true);
+  checkState("release", machine, TEST_SOFT, INPUT_SEC_STATE_RELEASED, 200);
+
+  checkNewState("after release", machine.update(TEST_NONE, 310), true);
+  checkState("after release", machine, TEST_NONE, INPUT_SEC_STATE_WAITING, 0);
+}
+
+// A release lasts one update, a new input right after it starts again
+void testReleaseOneUpdate()
+{
+  InputStateMachine<TestPolicy> machine;
+  machine.clear(0);
+  machine.update(TEST_SOFT, 0);
+  machine.update(TEST_NONE, 100);
+  checkState("released", machine, TEST_SOFT, INPUT_SEC_STATE_RELEASED, 100);
+
+  checkNewState("restart", machine.update(TEST_SOFT, 110), true);
+  checkState("restart", machine, TEST_SOFT, INPUT_SEC_STATE_STARTED, 0);
+}
+
+// Changes before the debounce time are ignored, a merge keeps the start time
+void testDebounceAndMerge()
+{
+  InputStateMachine<TestPolicy> machine;
+  machine.clear(0);
+  machine.update(TEST_SOFT, 0);
+
+  checkNewState("bounce", machine.update(TEST_NONE, 20), false);
+  checkState("bounce", machine, TEST_SOFT, INPUT_SEC_STATE_STARTED, 20);
+
+  checkNewState("merge", machine.update(TEST_HARD, 80), false);
+  checkState("merge", machine, TEST_HARD, INPUT_SEC_STATE_STARTED, 80);
+
+  checkNewState("change", machine.update(TEST_OTHER, 120), true);
+  checkState("change", machine, TEST_HARD, INPUT_SEC_STATE_RELEASED, 120);
+}
+
+// A started state is timed from the event time when the input was detected late
+void testEventTime()
+{
+  InputStateMachine<TestPolicy> machine;
+  machine.clear(0);
+  machine.update(TEST_SOFT, 100, 70);
+  checkState("late start", machine, TEST_SOFT, INPUT_SEC_STATE_STARTED, 30);
+}
+
+// The waiting time restarts after the idle timeout
+void testIdleTimeout()
+{
+  InputStateMachine<TestPolicy> machine;
+  machine.clear(0);
+  machine.update(TEST_NONE, 1001);
+  checkState("idle", machine, TEST_NONE, INPUT_SEC_STATE_WAITING, 0);
+  machine.update(TEST_NONE, 1101);
+  checkState("idle restart", machine, TEST_NONE, INPUT_SEC_STATE_WAITING, 100);
+}
+
+int main()
+{
+  testPressRelease();
+  testReleaseOneUpdate();
+  testDebounceAndMerge();
+  testEventTime();
+  testIdleTimeout();
+
+  if (failCount > 0) {
+    printf("%d check(s) failed\n", failCount);
+    return 1;
+  }
+  printf("All checks passed\n");
+  return 0;
+}